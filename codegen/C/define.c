@@ -7,18 +7,17 @@
  * Copyright (c) 2024 Yaokai Liu. All rights reserved.
  **/
 
+#include "define.h"
 #include "char_t.h"
 #include "context.h"
+#include "enum.h"
+#include "tokens.gen.h"
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 
-const char_t MEM_ENUM_FMT[] = "enum_MEM_%s";
-const char_t IMM_ENUM_FMT[] = "enum_IMM_%s";
-const char_t REG_ENUM_FMT[] = "enum_REG_%s";
-const char_t REG_DEC_FMT[] = "const Entry *REG_%s";
-const char_t MEM_DEC_FMT[] = "Entry *MEM_%s(uint64_t base, uint64_t offset)";
-const char_t IMM_DEC_FMT[] = "Entry *IMM_%s(uint64_t val)";
+const char_t MEM_DEC_FMT[] = "static inline Entry MEM_%s(uint64_t base, uint64_t offset)";
+const char_t IMM_DEC_FMT[] = "static inline Entry IMM_%s(uint64_t val)";
 
 [[gnu::unused]]
 const char_t STRUCT_MEM_FMT[] = "typedef struct {\n"
@@ -30,96 +29,230 @@ const char_t STRUCT_IMM_FMT[] = "typedef struct {\n"
                                 "  uint64_t value : %d;\n"
                                 "} struct_Immediate_%s;\n";
 
-const char_t MEM_DEF_FMT[] =
-    "{\n"
-    "  Entry * entry = CURRENT_MACHINE->allocator->calloc(1, sizeof(Entry));\n"
-    "  entry->type = enum_MEM_%s;\n"
-    "  uint64_t number = 0;\n"
-    "  number = setNumBits(number, %d, %d, base);\n"
-    "  number = setNumBits(number, %d, %d, offset);\n"
-    "  entry->value = number;\n"
-    "  return entry;\n"
+const char_t MEM_DEF_FMT[] = " {\n"
+                            "  assert(FITS_UNSIGNED(base, %d));\n"
+                            "  assert(FITS_UNSIGNED(offset, %d));\n"
+                            "  uint64_t number = 0;\n"
+                            "  number = numSetBits(number, %d, %d, base);\n"
+                            "  number = numSetBits(number, %d, %d, offset);\n"
+                            "  return (Entry) {.kind = ENTRY_MEMORY, .type = enum_MEM_%s, .value = number};\n"
+                            "}\n";
+const char_t IMM_FITS_FMT[] = "static inline bool IMM_%s_fits(uint64_t val) {\n"
+                              "  return FITS_%s(val, %d);\n"
+                              "}\n";
+const char_t IMM_DEF_FMT[] = " {\n"
+                             "  assert(IMM_%s_fits(val));\n"
+                             "  return (Entry) {\n"
+                             "      .kind = ENTRY_IMMEDIATE, .type = enum_IMM_%s, .value = LOW_BITS(val, %d)\n"
+                             "  };\n"
+                             "}\n";
+const char_t IMM_TABLE_HEAD[] = "static const struct {\n"
+                                "  uint8_t width[IMMEDIATE_ID_COUNT];\n"
+                                "  bool is_signed[IMMEDIATE_ID_COUNT];\n"
+                                "} IMMEDIATE_TABLE = {\n";
+const char_t IMM_TABLE_ITEM_FMT[] = "    [enum_IMM_%s] = %d,\n";
+const char_t IMM_VALUE_DEF[] =
+    "static inline uint64_t IMM_value(const Entry *imm) {\n"
+    "  if (imm->kind != ENTRY_IMMEDIATE || !IMMEDIATE_TABLE.is_signed[imm->type]) {\n"
+    "    return imm->value;\n"
+    "  }\n"
+    "  return (uint64_t) SIGN_EXTEND(imm->value, IMMEDIATE_TABLE.width[imm->type]);\n"
     "}\n";
-const char_t IMM_DEF_FMT[] =
-    "{\n"
-    "  Entry * entry = CURRENT_MACHINE->allocator->calloc(1, sizeof(Entry));\n"
-    "  entry->type = enum_IMM_%s;\n"
-    "  entry->value = val;\n"
-    "  return entry;\n"
-    "}\n";
-const char_t REG_DEF_FMT[] = "const static Entry {\n"
+const char_t SET_HAS_HEAD_FMT[] = "%s SET_%s_has(const Entry *e) {\n"
+                                  "  if (e->kind != %s) { return false; }\n"
+                                  "  switch (e->type) {\n";
+const char_t SET_HAS_ITEM_FMT[] = "    case enum_%s_%s:\n";
+const char_t SET_HAS_TAIL[] = "      return true;\n"
+                              "  }\n"
+                              "  return false;\n"
+                              "}\n";
+const char_t SET_CODE_DEF_FMT[] = "const uint64_t SET_%s[] = {\n";
+const char_t SET_MEM_DEF_FMT[] = "const MemLayout SET_%s[] = {\n";
+const char_t SET_REG_ITEM_FMT[] = "  [enum_REG_%s] = 0x%lX,\n";
+const char_t SET_IMM_ITEM_FMT[] = "  [enum_IMM_%s] = UINT_N_MAX(%d),\n";
+const char_t SET_MEM_ITEM_FMT[] = "  [enum_MEM_%s] = {%d, %d, %d, %d},\n";
+const char_t REG_DEF_FMT[] = "static const Entry Entry_REG_%s = {\n"
+                             "  .kind = ENTRY_REGISTER,\n"
                              "  .type = enum_REG_%s,\n"
                              "  .value = enum_REG_%s,\n"
-                             "} Entry_REG_%s;\n"
-                             "const Entry * REG_%s = &Entry_REG_%s;\n";
+                             "};\n"
+                             "static const Entry *const REG_%s = &Entry_REG_%s;\n";
+const char_t REG_TABLE_HEAD[] = "#define REGISTER_TABLE_SIZE REGISTER_ID_COUNT\n"
+                                "static const struct {\n"
+                                "  uint64_t code[REGISTER_TABLE_SIZE];\n"
+                                "  uint64_t mask[REGISTER_TABLE_SIZE];\n"
+                                "  uint16_t group[REGISTER_TABLE_SIZE];\n"
+                                "  uint16_t width[REGISTER_TABLE_SIZE];\n"
+                                "} REGISTER_TABLE = {\n";
+const char_t REG_TABLE_ITEM_FMT[] = "    [enum_REG_%s] = 0x%lX,\n";
+const char_t *const REG_TABLE_COLUMN_NAMES[REG_TABLE_COLUMNS] = {
+    "code", "mask", "group", "width"
+};
+const char_t REG_ACCESSORS[] =
+    "static inline uint64_t REG_code(uint32_t reg) { return REGISTER_TABLE.code[reg]; }\n"
+    "static inline uint64_t REG_mask(uint32_t reg) { return REGISTER_TABLE.mask[reg]; }\n"
+    "static inline uint16_t REG_group(uint32_t reg) { return REGISTER_TABLE.group[reg]; }\n"
+    "static inline uint16_t REG_width(uint32_t reg) { return REGISTER_TABLE.width[reg]; }\n";
 
 #define push_string(s) \
   do { Array_append(buffer, s, strlen(s)); } while (false)
 
-void gen_memory_enum_item(GContext *, Array *buffer, const Memory *mem) {
-  char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, MEM_ENUM_FMT, mem->name->ptr);
-  push_string(temp_buffer);
-  push_string(",\n");
-}
-
+// Operands are built by value in the header, so a constructor inlines into its encoder call
+// and costs no allocation.
 void gen_memory_dec(GContext *, Array *buffer, const Memory *mem) {
-  char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, MEM_DEC_FMT, mem->name->ptr);
-  push_string(temp_buffer);
-  push_string(";\n");
-}
-
-void gen_memory_def(GContext *, Array *buffer, const Memory *mem) {
   char_t temp_buffer[512] = {};
   sprintf(temp_buffer, MEM_DEC_FMT, mem->name->ptr);
   push_string(temp_buffer);
   sprintf(
-      temp_buffer, MEM_DEF_FMT, mem->name->ptr, mem->base->lower, mem->base->upper,
-      mem->offset->lower, mem->offset->upper
+      temp_buffer, MEM_DEF_FMT, mem->base->upper + 1 - mem->base->lower,
+      mem->offset->upper + 1 - mem->offset->lower, mem->base->lower, mem->base->upper + 1,
+      mem->offset->lower, mem->offset->upper + 1, mem->name->ptr
   );
   push_string(temp_buffer);
 }
 
-void gen_immediate_enum_item(GContext *, Array *buffer, const Immediate *imm) {
+// A signed immediate takes its value in two's complement, so `fits` is the range check of
+// both the constructor and the selection between short and long forms.
+void gen_immediate_dec(GContext *, Array *buffer, const Immediate *imm) {
   char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, IMM_ENUM_FMT, imm->name->ptr);
+  const char_t *name = imm->name->ptr;
+  const char_t *kind = (IT_SIGNED == imm->type) ? "SIGNED" : "UNSIGNED";
+  sprintf(temp_buffer, IMM_FITS_FMT, name, kind, imm->width);
+  push_string(temp_buffer);
+  sprintf(temp_buffer, IMM_DEC_FMT, name);
+  push_string(temp_buffer);
+  sprintf(temp_buffer, IMM_DEF_FMT, name, name, imm->width);
   push_string(temp_buffer);
-  push_string(",\n");
 }
 
-void gen_immediate_dec(GContext *, Array *buffer, const Immediate *imm) {
+// An operand keeps the low bits of its own type, so a selector tests the value sign-extended
+// from that width: `IMM_i32(-2)` fits a form of `i8` as well.
+void gen_immediate_table(GContext *context, Array *buffer) {
+  const uint32_t n_imms = Array_length(context->immArray);
+  if (0 == n_imms) { return; }
   char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, IMM_DEC_FMT, imm->name->ptr);
-  push_string(temp_buffer);
-  push_string(";\n");
+  push_string(IMM_TABLE_HEAD);
+  push_string("  .width = {\n");
+  for (uint32_t i = 0; i < n_imms; i++) {
+    const Immediate *imm = GContext_getImmediate(context, i);
+    sprintf(temp_buffer, IMM_TABLE_ITEM_FMT, imm->name->ptr, imm->width);
+    push_string(temp_buffer);
+  }
+  push_string("  },\n  .is_signed = {\n");
+  for (uint32_t i = 0; i < n_imms; i++) {
+    const Immediate *imm = GContext_getImmediate(context, i);
+    sprintf(temp_buffer, IMM_TABLE_ITEM_FMT, imm->name->ptr, IT_SIGNED == imm->type);
+    push_string(temp_buffer);
+  }
+  push_string("  },\n};\n");
+  push_string(IMM_VALUE_DEF);
 }
 
-void gen_immediate_def(GContext *, Array *buffer, const Immediate *imm) {
+void gen_register_def(GContext *, Array *buffer, const Register *reg) {
   char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, IMM_DEC_FMT, imm->name->ptr);
-  push_string(temp_buffer);
-  sprintf(temp_buffer, IMM_DEF_FMT, imm->name->ptr);
+  const char_t *name = reg->name->ptr;
+  sprintf(temp_buffer, REG_DEF_FMT, name, name, name, name, name);
   push_string(temp_buffer);
 }
 
-void gen_register_enum_item(GContext *, Array *buffer, const Register *reg) {
+uint64_t register_column(const Register *reg, uint32_t group, uint32_t column) {
+  const uint32_t width = reg->field->upper - reg->field->lower + 1;
+  switch (column) {
+    case 0: return reg->code;
+    case 1: return (width >= 64 ? UINT64_MAX : (1UL << width) - 1) << reg->field->lower;
+    case 2: return group;
+    default: return width;
+  }
+}
+
+// One table per machine, a column per property indexed by the register id.
+// It is `static` in the header, so a register known at the call site folds into a constant.
+void gen_register_table(GContext *context, Array *buffer) {
+  const uint32_t n_groups = Array_length(context->grpArray);
+  if (0 == n_groups) { return; }
   char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, REG_ENUM_FMT, reg->name->ptr);
-  push_string(temp_buffer);
-  push_string(",\n");
+  push_string(REG_TABLE_HEAD);
+  for (uint32_t c = 0; c < REG_TABLE_COLUMNS; c++) {
+    sprintf(temp_buffer, "  .%s = {\n", REG_TABLE_COLUMN_NAMES[c]);
+    push_string(temp_buffer);
+    for (uint32_t g = 0; g < n_groups; g++) {
+      const RegisterGroup *grp = GContext_getRegisterGroup(context, g);
+      const uint32_t n_regs = Array_length(grp->registers);
+      REFER(Register) *regs = Array_real_addr(grp->registers, 0);
+      for (uint32_t i = 0; i < n_regs; i++) {
+        const Register *reg = Array_vert2real(context->regArray, regs[i]);
+        sprintf(temp_buffer, REG_TABLE_ITEM_FMT, reg->name->ptr, register_column(reg, g, c));
+        push_string(temp_buffer);
+      }
+    }
+    push_string("  },\n");
+  }
+  push_string("};\n");
+  push_string(REG_ACCESSORS);
+}
+
+// The kind and the enum prefix of the items of a set.
+const char_t *set_kind(const Set *set, const char_t **prefix) {
+  switch (set->type) {
+    case enum_Register: *prefix = "REG"; return "ENTRY_REGISTER";
+    case enum_Memory: *prefix = "MEM"; return "ENTRY_MEMORY";
+  }
+  *prefix = "IMM";
+  return "ENTRY_IMMEDIATE";
 }
 
-void gen_register_dec(GContext *, Array *buffer, const Register *reg) {
+// The ids of different kinds overlap, so an operand is a member by its kind and its id;
+// an encoder tests it before indexing the table of the set with its id.
+void gen_set_has(GContext *, Array *buffer, const Set *set, const char_t *qualifier) {
   char_t temp_buffer[512] = {};
-  sprintf(temp_buffer, REG_DEC_FMT, reg->name->ptr);
+  const char_t *prefix = nullptr;
+  const char_t *kind = set_kind(set, &prefix);
+  sprintf(temp_buffer, SET_HAS_HEAD_FMT, qualifier, set->name->ptr, kind);
   push_string(temp_buffer);
-  push_string(";\n");
+  const uint32_t n_items = Array_length(set->items);
+  const SetItem *items = Array_real_addr(set->items, 0);
+  for (uint32_t i = 0; i < n_items; i++) {
+    sprintf(temp_buffer, SET_HAS_ITEM_FMT, prefix, items[i].name->ptr);
+    push_string(temp_buffer);
+  }
+  push_string(SET_HAS_TAIL);
 }
 
-void gen_register_def(GContext *, Array *buffer, const Register *reg) {
+// A set is generated as a table indexed by the enum of its items: register codes,
+// immediate masks or memory layouts, so one encoder serves every item of the set.
+void gen_set_def(GContext *context, Array *buffer, const Set *set) {
   char_t temp_buffer[512] = {};
-  const char_t *name = reg->name->ptr;
-  sprintf(temp_buffer, REG_DEF_FMT, name, name, name, name, name);
+  const char_t *def_fmt = (enum_Memory == set->type) ? SET_MEM_DEF_FMT : SET_CODE_DEF_FMT;
+  sprintf(temp_buffer, def_fmt, set->name->ptr);
   push_string(temp_buffer);
+  const uint32_t n_items = Array_length(set->items);
+  const SetItem *items = Array_real_addr(set->items, 0);
+  for (uint32_t i = 0; i < n_items; i++) {
+    const Record *record = GContext_findRecord(context, items[i].name);
+    const char_t *name = items[i].name->ptr;
+    switch (record->typeid) {
+      case enum_Register: {
+        const Register *reg = GContext_getRegister(context, record->offset);
+        sprintf(temp_buffer, SET_REG_ITEM_FMT, name, reg->code);
+        break;
+      }
+      case enum_Immediate: {
+        const Immediate *imm = GContext_getImmediate(context, record->offset);
+        sprintf(temp_buffer, SET_IMM_ITEM_FMT, name, imm->width);
+        break;
+      }
+      case enum_Memory: {
+        const Memory *mem = GContext_getMemory(context, record->offset);
+        sprintf(
+            temp_buffer, SET_MEM_ITEM_FMT, name, mem->base->lower,
+            mem->base->upper - mem->base->lower + 1, mem->offset->lower,
+            mem->offset->upper - mem->offset->lower + 1
+        );
+        break;
+      }
+    }
+    push_string(temp_buffer);
+  }
+  push_string("};\n");
+  gen_set_has(context, buffer, set, "[[maybe_unused]] static bool");
 }
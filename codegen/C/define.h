@@ -12,16 +12,23 @@
 
 #include "context.h"
 
+// the columns of the register table: code, mask, group and width.
+#define REG_TABLE_COLUMNS 4
+
+extern const char_t *const REG_TABLE_COLUMN_NAMES[REG_TABLE_COLUMNS];
+
+uint64_t register_column(const Register *reg, uint32_t group, uint32_t column);
+
 void gen_memory_dec(GContext *context, Array *buffer, const Memory *mem);
-void gen_memory_def(GContext *context, Array *buffer, const Memory *mem);
-void gen_memory_enum_item(GContext *context, Array *buffer, const Memory *mem);
 
 void gen_immediate_dec(GContext *context, Array *buffer, const Immediate *imm);
-void gen_immediate_def(GContext *context, Array *buffer, const Immediate *imm);
-void gen_immediate_enum_item(GContext *context, Array *buffer, const Immediate *imm);
+void gen_immediate_table(GContext *context, Array *buffer);
 
-void gen_register_dec(GContext *context, Array *buffer, const Register *reg);
 void gen_register_def(GContext *context, Array *buffer, const Register *reg);
-void gen_register_enum_item(GContext *context, Array *buffer, const Register *reg);
+void gen_register_table(GContext *context, Array *buffer);
+
+const char_t *set_kind(const Set *set, const char_t **prefix);
+void gen_set_has(GContext *context, Array *buffer, const Set *set, const char_t *qualifier);
+void gen_set_def(GContext *context, Array *buffer, const Set *set);
 
 #endif  // MACHINE_DEFINE_H
@@ -0,0 +1,117 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: emit.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "emit.h"
+#include "static.h"
+#include "timing.h"
+#include <stdio.h>
+#include <string.h>
+
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+// Buffers are only created by the outputs which use them, so a missing one is empty.
+void emit_output(Generator *generator, uint32_t index) {
+  Array *output = generator->context->outputs[index];
+  if (!output || 0 == Array_length(output)) { return; }
+  Array_append(generator->buffer, Array_real_addr(output, 0), Array_length(output));
+}
+
+// An enum or an array with no item is not valid C, so it is left out with its items.
+void emit_wrapped(Generator *generator, uint32_t index, const char_t *head, const char_t *tail) {
+  Array *buffer = generator->buffer;
+  Array *output = generator->context->outputs[index];
+  if (!output || 0 == Array_length(output)) { return; }
+  push_string(head);
+  emit_output(generator, index);
+  push_string(tail);
+}
+
+// `MACHINE_` and the file name in upper case, with every other character made an underscore.
+void header_guard(const char_t *filename, char_t *guard) {
+  uint32_t n = sprintf(guard, "MACHINE_");
+  for (const char_t *p = filename; *p; p++) {
+    const bool digit = '0' <= *p && *p <= '9';
+    const bool lower = 'a' <= *p && *p <= 'z';
+    const bool upper = 'A' <= *p && *p <= 'Z';
+    guard[n++] = lower ? *p - 'a' + 'A' : (digit || upper) ? *p : '_';
+  }
+  guard[n] = '\0';
+}
+
+// The header holds every declaration and everything `static` or `static inline`:
+// the enums, the register table, the operand constructors and the encoder prototypes.
+// With `ids`, the enums of the items take the ids of the map instead of the declaration order.
+int32_t emit_c_header(Generator *generator, const char_t *guard, const IdMap *ids) {
+  Array *buffer = generator->buffer;
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, "\n#ifndef %s\n#define %s\n\n", guard, guard);
+  push_string(temp_buffer);
+  push_string("#include \"array.h\"\n#include <stdbool.h>\n#include <stdint.h>\n\n");
+  push_string(MACROS);
+  push_string(FIELD_MACROS);
+  push_string("\n");
+  push_string(TYPE_DEFS);
+  if (ids) {
+    gen_id_enums(generator->context, buffer, ids);
+  } else {
+    emit_output(generator, CtxBuf_enum_item);
+  }
+  emit_wrapped(generator, CtxBuf_form_enum, "\nenum {\n", "};\n");
+  emit_output(generator, CtxBuf_name_dec);
+  push_string("\n");
+  push_string(TIMING_DEFS);
+  push_string("\n");
+  emit_output(generator, CtxBuf_register_table);
+  emit_output(generator, CtxBuf_register_dec);
+  emit_output(generator, CtxBuf_memory_dec);
+  emit_output(generator, CtxBuf_immediate_dec);
+  emit_output(generator, CtxBuf_encoding_dec);
+  sprintf(temp_buffer, "\n#endif  // %s\n", guard);
+  push_string(temp_buffer);
+  return (int32_t) Array_length(buffer);
+}
+
+// The source defines what the header declares; sets come ahead of the encoders using them.
+int32_t emit_c_source(Generator *generator, const char_t *header) {
+  Array *buffer = generator->buffer;
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, "\n#include \"%s\"\n\n", header);
+  push_string(temp_buffer);
+  emit_output(generator, CtxBuf_set_def);
+  emit_wrapped(generator, CtxBuf_timing_def, "\nconst FormTiming FORM_TIMING[] = {\n", "};\n");
+  emit_wrapped(generator, CtxBuf_form_size, "\nconst uint8_t FORM_SIZE[] = {\n", "};\n");
+  emit_output(generator, CtxBuf_name_def);
+  push_string("\n");
+  emit_output(generator, CtxBuf_encoding_def);
+  return (int32_t) Array_length(buffer);
+}
+
+// Writes `<name>.h` into `header` and `<name>.c` into `source`, each after the license
+// header. Nothing depends on the clock, so one machine always gives the same bytes.
+int32_t emit_c_files(
+    GContext *context, const char_t *name, int32_t year, char_t *holder, const IdMap *ids,
+    Array *header, Array *source
+) {
+  if (strlen(name) + 3 > MAX_NAME) { return -1; }
+  char_t header_name[MAX_NAME] = {}, source_name[MAX_NAME] = {}, guard[MAX_GUARD] = {};
+  sprintf(header_name, "%s.h", name);
+  sprintf(source_name, "%s.c", name);
+  header_guard(header_name, guard);
+
+  Generator generator = {.allocator = GContext_getAllocator(context), .context = context};
+  generator.buffer = header;
+  if (set_header(&generator, header_name, year, holder) < 0) { return -1; }
+  emit_c_header(&generator, guard, ids);
+  generator.buffer = source;
+  if (set_header(&generator, source_name, year, holder) < 0) { return -1; }
+  emit_c_source(&generator, header_name);
+  return 0;
+}
@@ -0,0 +1,30 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: emit.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_EMIT_H
+#define MACHINE_EMIT_H
+
+#include "generate.h"
+#include "ids.h"
+
+#define MAX_NAME  256
+#define MAX_GUARD (MAX_NAME + 8)
+
+void emit_output(Generator *generator, uint32_t index);
+void emit_wrapped(Generator *generator, uint32_t index, const char_t *head, const char_t *tail);
+void header_guard(const char_t *filename, char_t *guard);
+
+int32_t emit_c_header(Generator *generator, const char_t *guard, const IdMap *ids);
+int32_t emit_c_source(Generator *generator, const char_t *header);
+int32_t emit_c_files(
+    GContext *context, const char_t *name, int32_t year, char_t *holder, const IdMap *ids,
+    Array *header, Array *source
+);
+
+#endif  // MACHINE_EMIT_H
@@ -9,6 +9,7 @@
 
 #include "encoding.h"
 #include "enum.h"
+#include "number.h"
 #include "tokens.gen.h"
 #include <stdio.h>
 #include <string.h>
@@ -17,14 +18,16 @@ const char_t ENCODING_DEC_FMT[] = "uint32_t encoding_%s_%d(%s, Array *buffer)";
 
 const char_t ENCODING_DEF_FMT_HEAD[] = "{\n"
                                        "  const uint32_t size = %d;\n"
-                                       "  uint8_t bytes[%d] = {};\n"
+                                       "  uint8_t bytes[%d + sizeof(uint64_t)] = {};\n"
                                        "  uint64_t number = 0;\n"
                                        "  uint32_t index = 0;\n";
 
-const char_t ENCODING_DEF_FMT_TAIL[] = "  Array_append(buffer, bytes, sizeof(bytes));\n"
+const char_t ENCODING_DEF_FMT_TAIL[] = "  Array_append(buffer, bytes, size);\n"
                                        "  return size;\n"
                                        "}\n";
 
+#define MAX_IDENT_LEN 64
+
 #define push_string(s) \
   do { Array_append(buffer, s, strlen(s)); } while (false)
 
@@ -38,7 +41,12 @@ const char_t ENCODING_DEF_FMT_TAIL[] = "  Array_append(buffer, bytes, sizeof(byt
       const Identifier *args = Array_real_addr((form).pattern->args, 0); \
       for (uint32_t j = 0; j < n_args; j++) {                            \
         const Identifier *arg = &args[j];                                \
-        push_string("uint64_t ");                                        \
+        const Record *record = GContext_findRecord(context, arg);        \
+        if (record && enum_Set == record->typeid) {                      \
+          push_string("const Entry *");                                  \
+        } else {                                                         \
+          push_string("uint64_t ");                                      \
+        }                                                                \
         push_string(arg->ptr);                                           \
         push_string(", ");                                               \
       }                                                                  \
@@ -46,8 +54,44 @@ const char_t ENCODING_DEF_FMT_TAIL[] = "  Array_append(buffer, bytes, sizeof(byt
     push_string("Array *buffer)");                                       \
   } while (false)
 
+// A fixed register is folded into a literal, so its operand is only kept for the signature.
+void gen_fixed_args_unused(GContext *context, Array *buffer, const InstrForm *form) {
+  if (!form->pattern->args) { return; }
+  const uint32_t n_args = Array_length(form->pattern->args);
+  const Identifier *args = Array_real_addr(form->pattern->args, 0);
+  for (uint32_t j = 0; j < n_args; j++) {
+    const Record *record = GContext_findRecord(context, &args[j]);
+    if (!record || enum_Register != record->typeid) { continue; }
+    push_string("  (void) ");
+    push_string(args[j].ptr);
+    push_string(";\n");
+  }
+}
+
+// An operand of a set indexes the table of the set, so one of another kind or outside the set
+// is rejected before: `reject` is the statement doing it.
+void gen_set_args_check(
+    GContext *context, Array *buffer, const InstrForm *form, const char_t *reject
+) {
+  if (!form->pattern->args) { return; }
+  const uint32_t n_args = Array_length(form->pattern->args);
+  const Identifier *args = Array_real_addr(form->pattern->args, 0);
+  for (uint32_t j = 0; j < n_args; j++) {
+    const Record *record = GContext_findRecord(context, &args[j]);
+    if (!record || enum_Set != record->typeid) { continue; }
+    push_string("  if (!SET_");
+    push_string(GContext_getSet(context, record->offset)->name->ptr);
+    push_string("_has(");
+    push_string(args[j].ptr);
+    push_string(")) { ");
+    push_string(reject);
+    push_string(" }\n");
+  }
+}
+
 int32_t gen_instr_encoding_dec(
-    GContext *, Array *buffer, const char_t *instr_op, const InstrForm forms[], uint32_t n_forms
+    GContext *context, Array *buffer, const char_t *instr_op, const InstrForm forms[],
+    uint32_t n_forms
 ) {
   for (uint32_t i = 0; i < n_forms; ++i) {
     gen_encoding_dec_core(forms[i]);
@@ -67,6 +111,8 @@ int32_t gen_instr_encoding_def(
     gen_encoding_dec_core(forms[i]);
     sprintf(head_buffer, ENCODING_DEF_FMT_HEAD, n_bytes, n_bytes);
     push_string(head_buffer);
+    gen_fixed_args_unused(context, buffer, &forms[i]);
+    gen_set_args_check(context, buffer, &forms[i], "return 0;");
     codegen_instr_form(context, temp_buffer, &forms[i]);
     uint32_t size = Array_length(temp_buffer);
     char_t *ptr = Array_real_addr(temp_buffer, 0);
@@ -78,7 +124,8 @@ int32_t gen_instr_encoding_def(
   return 0;
 }
 
-#define min(a, b) ((a) < (b)) ? (a) : (b)
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
 
 #define setEncodingNumber(val_str)       \
   do {                                   \
@@ -87,37 +134,44 @@ int32_t gen_instr_encoding_def(
     push_string(");\n");                 \
   } while (false)
 
-#define pushEncodingNumber(val_str, count_str) \
-  do {                                         \
-    push_string("  pushEncodingNumber(");      \
-    push_string(val_str);                      \
-    push_string(", ");                         \
-    push_string(count_str);                    \
-    push_string(");\n");                       \
+#define pushEncodingNumber(val_str, count_str, suffix) \
+  do {                                                 \
+    push_string("  pushEncodingNumber");               \
+    push_string(suffix);                               \
+    push_string("(");                                  \
+    push_string(val_str);                              \
+    push_string(", ");                                 \
+    push_string(count_str);                            \
+    push_string(");\n");                               \
   } while (false)
 
-#define pushEncodingNumberN(val_str, count) \
-  do {                                      \
-    char_t count_str[0x20] = {};            \
-    sprintf(count_str, "%d", count);        \
-    pushEncodingNumber(val_str, count_str); \
+#define pushEncodingNumberN(val_str, count, suffix) \
+  do {                                              \
+    char_t count_str[0x20] = {};                    \
+    sprintf(count_str, "%d", count);                \
+    pushEncodingNumber(val_str, count_str, suffix); \
   } while (false)
 
-#define numberToInstrBytes(number, count) \
-  do {                                    \
-    char_t buf1[0x20] = {};               \
-    char_t buf2[0x20] = {};               \
-    sprintf(buf1, "0x%lX", number);       \
-    sprintf(buf2, "%d", count);           \
-    pushEncodingNumber(buf1, buf2);       \
+#define numberToInstrBytes(number, count, suffix) \
+  do {                                            \
+    char_t buf1[0x20] = {};                       \
+    char_t buf2[0x20] = {};                       \
+    sprintf(buf1, "0x%lX", number);               \
+    sprintf(buf2, "%d", count);                   \
+    pushEncodingNumber(buf1, buf2, suffix);       \
   } while (false)
 
-#define getDefaultMappingBit(default_bit)                      \
-  do {                                                         \
-    if (items->default_eval) {                                 \
-      default_bit = ((uint64_t) items->default_eval->lhs) & 1; \
-      default_bit = default_bit ? -1 : 0;                      \
-    }                                                          \
+// suffixes of the generated store macros, indexed by `enum BYTE_ORDER`.
+static const char_t * const ORDER_SUFFIX[] = {
+    [ORDER_DEFAULT] = "", [ORDER_LITTLE] = "", [ORDER_BIG] = "BE", [ORDER_HALFWORD] = "HW"
+};
+
+#define getDefaultMappingBit(default_bit)                            \
+  do {                                                               \
+    if (items->default_eval) {                                       \
+      default_bit = Number_getLimb(items->default_eval->lhs, 0) & 1; \
+      default_bit = default_bit ? -1 : 0;                            \
+    }                                                                \
   } while (false)
 
 #define getMappingItem(_items, bf)                                                 \
@@ -128,36 +182,79 @@ int32_t gen_instr_encoding_def(
 
 static thread_local char_t FMT_BUFFER[1024] = {};
 
-#define MAX_IDENT_LEN 64
+// An operand of a set is passed as an `Entry`, whose type indexes the set's table. An
+// immediate is taken by `IMM_value`, sign-extended from its own type, and the field then
+// keeps its low bits, so a negative member fills a wider field with ones.
+int32_t set_operand_to_val(const Identifier *ident, const Set *set, char_t *buffer) {
+  const char_t *op = ident->ptr, *name = set->name->ptr;
+  switch (set->type) {
+    case enum_Register: {
+      return sprintf(buffer, "SET_%s[%s->type]", name, op);
+    }
+    case enum_Immediate: {
+      return sprintf(buffer, "IMM_value(%s)", op);
+    }
+    case enum_Memory: {
+      return sprintf(buffer, "%s->value", op);
+    }
+  }
+  return -1;
+}
+
+// A fixed register is folded into its code here; a register of a group is passed as its enum
+// and looked up in `REGISTER_TABLE`, which the C compiler folds when the register is constant.
+int32_t operand_to_val(
+    GContext *context, const Identifier *ident, const Record *record, char_t *buffer
+) {
+  switch (record->typeid) {
+    case enum_Register: {
+      return sprintf(buffer, "0x%lX", GContext_getRegister(context, record->offset)->code);
+    }
+    case enum_RegisterGroup: {
+      return sprintf(buffer, "REG_code(%s)", ident->ptr);
+    }
+  }
+  return sprintf(buffer, "%s", ident->ptr);
+}
+
 int32_t eval_to_val(GContext *context, Evaluable *evaluable, char_t *buffer) {
   if (enum_NUMBER == evaluable->type) {
-    uint64_t number = (uint64_t) evaluable->lhs;
+    if (Number_countLimbs(evaluable->lhs) > 1) { return -1; }
+    uint64_t number = Number_getLimb(evaluable->lhs, 0);
     return sprintf(buffer, "0x%lX", number);
   }
   Identifier *ident = (Identifier *) evaluable->lhs;
   if (ident->len > MAX_IDENT_LEN) { return -1; }
   Record *record = GContext_findRecord(context, ident);
+  Set *set = (enum_Set == record->typeid) ? GContext_getSet(context, record->offset) : nullptr;
+  if (set && set->name->len > MAX_IDENT_LEN) { return -1; }
   switch (evaluable->type) {
     case enum_NUMBER:
     case enum_IDENTIFIER: {
-      if (record->typeid == enum_Set) {
-        // TODO: codegen for set
-        return -1;
-      } else {
-        return sprintf(buffer, "%s", ident->ptr);
-      }
+      if (set) { return set_operand_to_val(ident, set, buffer); }
+      return operand_to_val(context, ident, record, buffer);
     }
     case enum_BIT_FIELD: {
       BitField *bf = evaluable->rhs;
       uint32_t width = bf->upper - bf->lower + 1;
-      if (record->typeid == enum_Set) {
-        // TODO: codegen for set
-        return -1;
-      } else {
-        return sprintf(buffer, "(%s >> %d) & UINT_N_MAX(%d)", ident->ptr, bf->lower, width);
-      }
+      char_t val[3 * MAX_IDENT_LEN + 32] = {};
+      const int32_t len =
+          set ? set_operand_to_val(ident, set, val) : operand_to_val(context, ident, record, val);
+      if (len < 0) { return -1; }
+      return sprintf(buffer, "(%s >> %d) & UINT_N_MAX(%d)", val, bf->lower, width);
     }
     case enum_MEM_KEY: {
+      const char_t *key = (((uint64_t) evaluable->rhs) == MEM_BASE) ? "base" : "offset";
+      if (set && enum_Memory == set->type) {
+        // the field of each memory in the set is at its own place.
+        return sprintf(
+            buffer,
+            "(%s->value >> SET_%s[%s->type].%s_lower) & "
+            "UINT_N_MAX(SET_%s[%s->type].%s_width)",
+            ident->ptr, set->name->ptr, ident->ptr, key, set->name->ptr, ident->ptr, key
+        );
+      }
+      if (record->typeid != enum_Memory) { return -1; }
       Memory *mem = GContext_getMemory(context, record->offset);
       BitField *bf = (((uint64_t) evaluable->rhs) == MEM_BASE) ? mem->base : mem->offset;
       uint32_t width = bf->upper - bf->lower + 1;
@@ -173,33 +270,53 @@ int32_t
   MappingItem *item = getMappingItem(items, bf);
   uint64_t default_bit = 0;
   getDefaultMappingBit(default_bit);
+  // bits are set relative to the 64-bit chunk which `bf` lies in.
+  const uint32_t base = bf->lower & ~63U;
   if (!item) {
     int len = sprintf(
-        FMT_BUFFER, "  number = numSetBits(number, %d, %d, %ld);\n", bf->lower, bf->upper + 1,
-        (int64_t) default_bit
+        FMT_BUFFER, "  number = numSetBits(number, %d, %d, %ld);\n", bf->lower - base,
+        bf->upper + 1 - base, (int64_t) default_bit
     );
     if (len > 0) { push_string(FMT_BUFFER); }
     return Array_length(buffer) - pre_len;
   }
 
-  uint32_t bu = item->field->upper;
-  uint32_t bl = item->field->lower;
+  // an item crossing the chunk only contributes the bits inside it.
+  uint32_t bu = min(item->field->upper, bf->upper);
+  uint32_t bl = max(item->field->lower, bf->lower);
 
   if (bl > bf->lower) {
     BitField lower_bf = {.lower = bf->lower, .upper = bl - 1};
     codegen_items_bf(context, buffer, items, &lower_bf);
   }
-  char_t *temp_buffer = nullptr;
-  if (item->evaluable->type != enum_NUMBER) {
-    size_t size = ((Identifier *) item->evaluable->lhs)->len;
-    temp_buffer = GContext_getAllocator(context)->malloc((2 * size + 128) * sizeof(char_t));
+  if (enum_NUMBER == item->evaluable->type) {
+    // a constant is cut to the bits of the chunk here, so it may have any number of limbs.
+    const uint64_t bits = Number_getBits(item->evaluable->lhs, bl - item->field->lower);
+    sprintf(
+        FMT_BUFFER, "  number = numSetBits(number, %d, %d, 0x%lX);\n", bl - base, bu + 1 - base,
+        bits
+    );
   } else {
-    temp_buffer = GContext_getAllocator(context)->malloc(128 * sizeof(char_t));
+    // a set operand repeats the operand's name thrice and the set's name twice.
+    const size_t size = ((Identifier *) item->evaluable->lhs)->len;
+    char_t *temp_buffer = GContext_getAllocator(context)->malloc(
+        (3 * size + 2 * MAX_IDENT_LEN + 128) * sizeof(char_t)
+    );
+    eval_to_val(context, item->evaluable, temp_buffer);
+    if (bl > item->field->lower) {
+      sprintf(
+          FMT_BUFFER, "  number = numSetBits(number, %d, %d, (%s) >> %d);\n", bl - base,
+          bu + 1 - base, temp_buffer, bl - item->field->lower
+      );
+    } else {
+      sprintf(
+          FMT_BUFFER, "  number = numSetBits(number, %d, %d, %s);\n", bl - base, bu + 1 - base,
+          temp_buffer
+      );
+    }
+    GContext_getAllocator(context)->free(temp_buffer);
   }
-  eval_to_val(context, item->evaluable, temp_buffer);
-  sprintf(FMT_BUFFER, "  number = numSetBits(number, %d, %d, %s);\n", bl, bu + 1, temp_buffer);
   push_string(FMT_BUFFER);
-  GContext_getAllocator(context)->free(temp_buffer);
 
   if (bu < bf->upper) {
     BitField upper_bf = {.lower = bu + 1, .upper = bf->upper};
@@ -208,39 +325,61 @@ int32_t
   return Array_length(buffer) - pre_len;
 }
 
-int32_t codegen_layout(GContext *context, Array *buffer, const Layout *layout, uint32_t width) {
+int32_t codegen_layout(
+    GContext *context, Array *buffer, const Layout *layout, uint32_t width, uint32_t order
+) {
   const uint32_t pre_len = Array_length(buffer);
+  const char_t *suffix = ORDER_SUFFIX[order];
+  // big-endian and halfword orders store the most significant chunk first.
+  const bool msb_first = ORDER_BIG == order || ORDER_HALFWORD == order;
+  const uint32_t n_chunks = (width + 63) / 64;
   switch (layout->type) {
     case enum_Evaluable: {
       Evaluable *evaluable = layout->target;
+      if (enum_NUMBER == evaluable->type && Number_countLimbs(evaluable->lhs) > 1) {
+        // a wide constant is emitted limb by limb.
+        for (uint32_t j = 0; j < n_chunks; j++) {
+          const uint32_t i = 64 * (msb_first ? n_chunks - 1 - j : j);
+          const uint64_t limb = Number_getLimb(evaluable->lhs, i / 64);
+          numberToInstrBytes(limb, min(64, width - i) / 8, suffix);
+        }
+        break;
+      }
       int32_t size = eval_to_val(context, evaluable, FMT_BUFFER);
       if (size < 0) { return size; }
-      pushEncodingNumberN(FMT_BUFFER, width / 8);
+      if (msb_first && width > 64) {
+        // the value only fills the lowest 64 bits, which come last.
+        pushEncodingNumberN("0", (width - 64) / 8, "");
+        pushEncodingNumberN(FMT_BUFFER, 8, suffix);
+      } else {
+        pushEncodingNumberN(FMT_BUFFER, width / 8, suffix);
+      }
       break;
     }
     case enum_MappingItems: {
       MappingItems *items = layout->target;
-      for (uint32_t i = 0; i < width; i += 64) {
+      for (uint32_t j = 0; j < n_chunks; j++) {
+        const uint32_t i = 64 * (msb_first ? n_chunks - 1 - j : j);
         BitField bf = {.lower = i, .upper = min(i + 63, width - 1)};
         codegen_items_bf(context, buffer, items, &bf);
-        sprintf(FMT_BUFFER, "  pushInstrBytes(%d);\n", min(64, width - i) / 8);
+        sprintf(FMT_BUFFER, "  pushInstrBytes%s(%d);\n", suffix, min(64, width - i) / 8);
         push_string(FMT_BUFFER);
-        push_string("  number = 0;\n");
       }
     }
   }
   return Array_length(buffer) - pre_len;
 }
 
-#define codegen_form_part(part)                       \
-  do {                                                \
-    uint32_t width;                                   \
-    const Layout *layout;                             \
-    width = form->parts[(part) - 1].width;            \
-    if (width > 0) {                                  \
-      layout = form->parts[(part) - 1].layout;        \
-      codegen_layout(context, buffer, layout, width); \
-    }                                                 \
+#define codegen_form_part(part)                              \
+  do {                                                       \
+    uint32_t width, order;                                   \
+    const Layout *layout;                                    \
+    width = form->parts[(part) - 1].width;                   \
+    if (width > 0) {                                         \
+      layout = form->parts[(part) - 1].layout;               \
+      order = form->parts[(part) - 1].order;                 \
+      codegen_layout(context, buffer, layout, width, order); \
+    }                                                        \
   } while (false)
 int32_t codegen_instr_form(GContext *context, Array *buffer, const InstrForm *form) {
   const uint32_t pre_len = Array_length(buffer);
@@ -23,12 +23,24 @@ int32_t gen_instr_encoding_def(
     uint32_t n_forms
 );
 
+void gen_fixed_args_unused(GContext *context, Array *buffer, const InstrForm *form);
+void gen_set_args_check(
+    GContext *context, Array *buffer, const InstrForm *form, const char_t *reject
+);
+
 int32_t codegen_instr_form(GContext *context, Array *buffer, const InstrForm *form);
 
-int32_t codegen_layout(GContext *context, Array *buffer, const Layout *layout, uint32_t width);
+int32_t codegen_layout(
+    GContext *context, Array *buffer, const Layout *layout, uint32_t width, uint32_t order
+);
 
 int32_t codegen_items_bf(GContext *context, Array *buffer, MappingItems *items, const BitField *bf);
 
+int32_t set_operand_to_val(const Identifier *ident, const Set *set, char_t *buffer);
+int32_t operand_to_val(
+    GContext *context, const Identifier *ident, const Record *record, char_t *buffer
+);
+
 int32_t eval_to_val(GContext *context, Evaluable *evaluable, char_t *buffer);
 
 #endif  // MACHINE_ENCODING_H
@@ -0,0 +1,142 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: estimate.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "estimate.h"
+#include "array.h"
+#include "define.h"
+#include "names.h"
+#include "tokens.gen.h"
+
+// Bytes of the formats around the names, rounded up: a low estimate costs the buffer a
+// growth, a high one only the unused end of its storage.
+#define ENUM_ITEM_BYTES     24
+#define ENUM_KIND_BYTES     40
+#define REG_DEF_BYTES       152
+#define REG_TABLE_BYTES     800
+#define REG_ROW_BYTES       32
+#define MEM_DEC_BYTES       384
+#define IMM_DEC_BYTES       272
+#define IMM_TABLE_BYTES     400
+#define IMM_ROW_BYTES       32
+#define SET_HEAD_BYTES      160
+#define SET_ITEM_BYTES      64
+#define FORM_DEC_BYTES      48
+#define FORM_ARG_BYTES      48
+#define FORM_BODY_BYTES     160
+#define LAYOUT_CHUNK_BYTES  64
+#define MAPPING_ITEM_BYTES  112
+#define SELECT_FORM_BYTES   128
+#define SELECT_ARG_BYTES    96
+#define FORM_ENUM_BYTES     24
+#define FORM_TIMING_BYTES   48
+#define FORM_SIZE_BYTES     32
+#define NAME_HEAD_BYTES     1200
+#define NAME_DEC_BYTES      120
+#define NAME_ITEM_BYTES     56
+
+void estimate_register_group(GContext *context, const RegisterGroup *grp, uint32_t sizes[]);
+void estimate_set(const Set *set, uint32_t sizes[]);
+uint32_t estimate_layout(const Layout *layout, uint32_t width);
+void estimate_instruction(const Instruction *instr, uint32_t sizes[]);
+
+void estimate_register_group(GContext *context, const RegisterGroup *grp, uint32_t sizes[]) {
+  const uint32_t n_regs = Array_length(grp->registers);
+  REFER(Register) *regs = Array_real_addr(grp->registers, 0);
+  for (uint32_t i = 0; i < n_regs; i++) {
+    const uint32_t len = ((Register *) Array_vert2real(context->regArray, regs[i]))->name->len;
+    sizes[CtxBuf_enum_item] += ENUM_ITEM_BYTES + len;
+    sizes[CtxBuf_register_dec] += REG_DEF_BYTES + 5 * len;
+    sizes[CtxBuf_register_table] += REG_TABLE_COLUMNS * (REG_ROW_BYTES + len);
+    sizes[CtxBuf_name_def] += 2 * NAME_ITEM_BYTES + 3 * len;
+  }
+}
+
+void estimate_set(const Set *set, uint32_t sizes[]) {
+  const uint32_t n_items = Array_length(set->items);
+  const SetItem *items = Array_real_addr(set->items, 0);
+  sizes[CtxBuf_set_def] += SET_HEAD_BYTES + 2 * set->name->len;
+  for (uint32_t i = 0; i < n_items; i++) {
+    sizes[CtxBuf_set_def] += SET_ITEM_BYTES + items[i].name->len;
+  }
+}
+
+// A layout is stored by 64-bit chunks, and each item of a mapping may leave a gap of default
+// bits on both of its sides.
+uint32_t estimate_layout(const Layout *layout, uint32_t width) {
+  const uint32_t n_chunks = (width + 63) / 64;
+  if (enum_MappingItems != layout->type) { return n_chunks * LAYOUT_CHUNK_BYTES; }
+  const MappingItems *items = layout->target;
+  return n_chunks * LAYOUT_CHUNK_BYTES + Array_length(items->itemArray) * MAPPING_ITEM_BYTES;
+}
+
+void estimate_instruction(const Instruction *instr, uint32_t sizes[]) {
+  const uint32_t n_forms = Array_length(instr->forms);
+  const InstrForm *forms = Array_real_addr(instr->forms, 0);
+  const uint32_t len = instr->name->len;
+  for (uint32_t i = 0; i < n_forms; i++) {
+    const uint32_t n_args = forms[i].pattern->args ? Array_length(forms[i].pattern->args) : 0;
+    const uint32_t dec = FORM_DEC_BYTES + len + n_args * FORM_ARG_BYTES;
+    uint32_t body = FORM_BODY_BYTES;
+    for (uint32_t p = 0; p < 3; p++) {
+      if (forms[i].parts[p].width) {
+        body += estimate_layout(forms[i].parts[p].layout, forms[i].parts[p].width);
+      }
+    }
+    sizes[CtxBuf_encoding_dec] += dec + SELECT_FORM_BYTES;
+    sizes[CtxBuf_encoding_def] += dec + body + SELECT_FORM_BYTES + n_args * SELECT_ARG_BYTES;
+    sizes[CtxBuf_form_enum] += FORM_ENUM_BYTES + len;
+    sizes[CtxBuf_timing_def] += FORM_TIMING_BYTES + len;
+    sizes[CtxBuf_form_size] += FORM_SIZE_BYTES + len;
+    sizes[CtxBuf_name_def] += NAME_ITEM_BYTES + len;
+  }
+  if (n_forms) { sizes[CtxBuf_name_def] += NAME_ITEM_BYTES + 2 * len; }
+}
+
+// The bytes every output of `codegen/C` takes for the machine, from the counts of its items,
+// the lengths of their names and the mapping items of the forms.
+void estimate_outputs(GContext *context, const Machine *machine, uint32_t sizes[N_CTX_BUFFERS]) {
+  sizes[CtxBuf_enum_item] = 3 * ENUM_KIND_BYTES;
+  sizes[CtxBuf_name_dec] = N_NAME_KINDS * NAME_DEC_BYTES;
+  sizes[CtxBuf_name_def] = NAME_HEAD_BYTES;
+  if (Array_length(context->grpArray)) { sizes[CtxBuf_register_table] = REG_TABLE_BYTES; }
+  if (Array_length(context->immArray)) { sizes[CtxBuf_immediate_dec] = IMM_TABLE_BYTES; }
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t i = 0; i < n_entries; i++) {
+    const Entry *entry = Array_real_addr(machine->entries, i);
+    switch (entry->type) {
+      case enum_Memory: {
+        const Memory *mem = Array_vert2real(context->memArray, entry->target);
+        sizes[CtxBuf_enum_item] += ENUM_ITEM_BYTES + mem->name->len;
+        sizes[CtxBuf_memory_dec] += MEM_DEC_BYTES + 2 * mem->name->len;
+        sizes[CtxBuf_name_def] += 2 * NAME_ITEM_BYTES + 3 * mem->name->len;
+        break;
+      }
+      case enum_Immediate: {
+        const Immediate *imm = Array_vert2real(context->immArray, entry->target);
+        sizes[CtxBuf_enum_item] += ENUM_ITEM_BYTES + imm->name->len;
+        sizes[CtxBuf_immediate_dec] += IMM_DEC_BYTES + 3 * imm->name->len;
+        sizes[CtxBuf_immediate_dec] += 2 * (IMM_ROW_BYTES + imm->name->len);
+        sizes[CtxBuf_name_def] += 2 * NAME_ITEM_BYTES + 3 * imm->name->len;
+        break;
+      }
+      case enum_RegisterGroup: {
+        estimate_register_group(context, Array_vert2real(context->grpArray, entry->target), sizes);
+        break;
+      }
+      case enum_Set: {
+        estimate_set(Array_vert2real(context->setArray, entry->target), sizes);
+        break;
+      }
+      case enum_Instruction: {
+        estimate_instruction(entry->target, sizes);
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,18 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: estimate.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_ESTIMATE_H
+#define MACHINE_ESTIMATE_H
+
+#include "context.h"
+#include "target.h"
+
+void estimate_outputs(GContext *context, const Machine *machine, uint32_t sizes[N_CTX_BUFFERS]);
+
+#endif  // MACHINE_ESTIMATE_H
@@ -13,7 +13,12 @@
 #include "context.h"
 #include "define.h"
 #include "encoding.h"
+#include "estimate.h"
+#include "ids.h"
+#include "names.h"
+#include "select.h"
 #include "target.h"
+#include "timing.h"
 #include "tokens.gen.h"
 #include <stdint.h>
 
@@ -21,12 +26,8 @@ int32_t codegen_memory(GContext *context, REFER(Memory) mem) {
   mem = Array_vert2real(context->memArray, mem);
 
   Array *dec_buffer = GContext_getOutputBuffer(context, CtxBuf_memory_dec);
-  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_memory_def);
-  Array *enum_buffer = GContext_getOutputBuffer(context, CtxBuf_enum_item);
 
   gen_memory_dec(context, dec_buffer, mem);
-  gen_memory_def(context, def_buffer, mem);
-  gen_memory_enum_item(context, enum_buffer, mem);
 
   return 0;
 }
@@ -35,12 +36,8 @@ int32_t codegen_immediate(GContext *context, REFER(Immediate) imm) {
   imm = Array_vert2real(context->immArray, imm);
 
   Array *dec_buffer = GContext_getOutputBuffer(context, CtxBuf_immediate_dec);
-  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_immediate_def);
-  Array *enum_buffer = GContext_getOutputBuffer(context, CtxBuf_enum_item);
 
   gen_immediate_dec(context, dec_buffer, imm);
-  gen_immediate_def(context, def_buffer, imm);
-  gen_immediate_enum_item(context, enum_buffer, imm);
 
   return 0;
 }
@@ -49,20 +46,27 @@ int32_t codegen_register_group(GContext *context, REFER(RegisterGroup) grp) {
   grp = Array_vert2real(context->grpArray, grp);
 
   Array *dec_buffer = GContext_getOutputBuffer(context, CtxBuf_register_dec);
-  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_register_def);
-  Array *enum_buffer = GContext_getOutputBuffer(context, CtxBuf_enum_item);
 
+  // the entries are `static` in the header, so `REG_code(REG_x->type)` folds to a constant.
   const uint32_t n_regs = Array_length(grp->registers);
   REFER(Register) *regs = Array_real_addr(grp->registers, 0);
   for (uint32_t i = 0; i < n_regs; i++) {
     const Register *reg = Array_vert2real(context->regArray, regs[i]);
-    gen_register_dec(context, dec_buffer, reg);
-    gen_register_def(context, def_buffer, reg);
-    gen_register_enum_item(context, enum_buffer, reg);
+    gen_register_def(context, dec_buffer, reg);
   }
   return 0;
 }
 
+int32_t codegen_set(GContext *context, REFER(Set) set) {
+  set = Array_vert2real(context->setArray, set);
+
+  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_set_def);
+
+  gen_set_def(context, def_buffer, set);
+
+  return 0;
+}
+
 int32_t codegen_instruction(GContext *context, Instruction *instr) {
   const InstrForm *forms = Array_real_addr(instr->forms, 0);
   const uint32_t n_forms = Array_length(instr->forms);
@@ -72,24 +76,72 @@ int32_t codegen_instruction(GContext *context, Instruction *instr) {
 
   gen_instr_encoding_dec(context, dec_buffer, instr->name->ptr, forms, n_forms);
   gen_instr_encoding_def(context, def_buffer, instr->name->ptr, forms, n_forms);
+  gen_instr_selectors(context, dec_buffer, def_buffer, instr->name->ptr, forms, n_forms);
+
+  Array *form_enum_buffer = GContext_getOutputBuffer(context, CtxBuf_form_enum);
+  Array *timing_buffer = GContext_getOutputBuffer(context, CtxBuf_timing_def);
+  Array *size_buffer = GContext_getOutputBuffer(context, CtxBuf_form_size);
+  for (uint32_t i = 0; i < n_forms; i++) {
+    gen_form_enum_item(context, form_enum_buffer, instr->name->ptr, i);
+    gen_form_timing_def(context, timing_buffer, instr->name->ptr, i, &forms[i]);
+    gen_form_size_def(context, size_buffer, instr->name->ptr, i, &forms[i]);
+  }
+  context->n_forms += n_forms;
 
   return 0;
 }
 
-codegen_t *get_codegen(uint32_t type) {
-  switch (type) {
-    case enum_Memory: {
-      return (codegen_t *) codegen_memory;
-    }
-    case enum_Immediate: {
-      return (codegen_t *) codegen_immediate;
-    }
-    case enum_RegisterGroup: {
-      return (codegen_t *) codegen_register_group;
-    }
-    case enum_Instruction: {
-      return (codegen_t *) codegen_instruction;
+// Runs once the whole machine is reduced. Every entry is generated here rather than when it
+// is reduced, so the outputs are sized from the whole machine first and each of them is
+// allocated once. Entries keep the order of the description, so the outputs are the same.
+int32_t codegen_machine(GContext *context, Machine *machine) {
+  uint32_t sizes[N_CTX_BUFFERS] = {};
+  estimate_outputs(context, machine, sizes);
+  for (uint32_t i = 0; i < N_CTX_BUFFERS; i++) { GContext_reserveOutput(context, i, sizes[i]); }
+
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t i = 0; i < n_entries; i++) {
+    const Entry *entry = Array_real_addr(machine->entries, i);
+    switch (entry->type) {
+      case enum_Memory: {
+        codegen_memory(context, entry->target);
+        break;
+      }
+      case enum_Immediate: {
+        codegen_immediate(context, entry->target);
+        break;
+      }
+      case enum_RegisterGroup: {
+        codegen_register_group(context, entry->target);
+        break;
+      }
+      case enum_Set: {
+        codegen_set(context, entry->target);
+        break;
+      }
+      case enum_Instruction: {
+        codegen_instruction(context, entry->target);
+        break;
+      }
     }
   }
+
+  Array *enum_buffer = GContext_getOutputBuffer(context, CtxBuf_enum_item);
+  Array *table_buffer = GContext_getOutputBuffer(context, CtxBuf_register_table);
+  Array *imm_buffer = GContext_getOutputBuffer(context, CtxBuf_immediate_dec);
+  Array *name_dec_buffer = GContext_getOutputBuffer(context, CtxBuf_name_dec);
+  Array *name_def_buffer = GContext_getOutputBuffer(context, CtxBuf_name_def);
+
+  gen_id_enums(context, enum_buffer, nullptr);
+  gen_register_table(context, table_buffer);
+  gen_immediate_table(context, imm_buffer);
+  gen_name_pool(context, name_dec_buffer, name_def_buffer, machine);
+
+  return 0;
+}
+
+// Only the machine is generated at its reduce, see `codegen_machine`.
+codegen_t *get_codegen(uint32_t type) {
+  if (enum_Machine == type) { return (codegen_t *) codegen_machine; }
   return nullptr;
 }
@@ -0,0 +1,149 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: ids.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "ids.h"
+#include "array.h"
+#include "char_t.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_ID_NAME 256
+
+const char_t *const ID_KIND_NAMES[N_ID_KINDS] = {"register", "memory", "immediate"};
+const char_t *const ID_ENUM_PREFIXES[N_ID_KINDS] = {"enum_REG_", "enum_MEM_", "enum_IMM_"};
+const char_t *const ID_COUNT_NAMES[N_ID_KINDS] = {
+    "REGISTER_ID_COUNT", "MEMORY_ID_COUNT", "IMMEDIATE_ID_COUNT"
+};
+
+uint32_t count_items(GContext *context, uint32_t kind);
+const char_t *item_name(GContext *context, uint32_t kind, uint32_t offset);
+void pin_name(IdMap *map, uint32_t kind, const char_t *name, uint32_t id);
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+uint32_t count_items(GContext *context, uint32_t kind) {
+  switch (kind) {
+    case ID_REGISTER: return Array_length(context->regArray);
+    case ID_MEMORY: return Array_length(context->memArray);
+  }
+  return Array_length(context->immArray);
+}
+
+const char_t *item_name(GContext *context, uint32_t kind, uint32_t offset) {
+  switch (kind) {
+    case ID_REGISTER: return GContext_getRegister(context, offset)->name->ptr;
+    case ID_MEMORY: return GContext_getMemory(context, offset)->name->ptr;
+  }
+  return GContext_getImmediate(context, offset)->name->ptr;
+}
+
+void pin_name(IdMap *map, uint32_t kind, const char_t *name, uint32_t id) {
+  const uint32_t length = strlen(name);
+  IdPin pin = {.name = map->allocator->malloc(length + 1), .id = id};
+  memcpy(pin.name, name, length + 1);
+  Array_append(map->pins[kind], &pin, 1);
+  void *ndx = (void *) (uint64_t) Array_length(map->pins[kind]);
+  Trie_set(map->index[kind], pin.name, ndx);
+  if (id >= map->counts[kind]) { map->counts[kind] = id + 1; }
+}
+
+IdMap *IdMap_new(const Allocator *allocator) {
+  IdMap *map = allocator->calloc(1, sizeof(IdMap));
+  map->allocator = allocator;
+  for (uint32_t k = 0; k < N_ID_KINDS; k++) {
+    map->pins[k] = Array_new(sizeof(IdPin), -1, allocator);
+    map->index[k] = Trie_new(allocator);
+  }
+  return map;
+}
+
+// Reads the lines `<kind> <name> <id>` written by `IdMap_store`. A map which gives one name
+// or one id twice is rejected, as its enums would not be valid C.
+int32_t IdMap_load(IdMap *map, const char_t *path) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) { return -1; }
+  char_t kind_name[16] = {}, name[MAX_ID_NAME] = {};
+  uint32_t id = 0;
+  int32_t result = 0;
+  while (0 == result && fscanf(fp, "%15s %255s %u", kind_name, name, &id) == 3) {
+    uint32_t kind = 0;
+    while (kind < N_ID_KINDS && strcmp(kind_name, ID_KIND_NAMES[kind]) != 0) { kind++; }
+    if (N_ID_KINDS == kind || IdMap_getId(map, kind, name) != UINT32_MAX) {
+      result = -2;
+      break;
+    }
+    for (uint32_t i = 0; i < Array_length(map->pins[kind]); i++) {
+      if (((IdPin *) Array_real_addr(map->pins[kind], i))->id == id) { result = -2; }
+    }
+    if (0 == result) { pin_name(map, kind, name, id); }
+  }
+  if (0 == result && !feof(fp)) { result = -2; }
+  fclose(fp);
+  return result;
+}
+
+// Pins every item of the context, in the order they are declared. Names of the map which
+// are gone from the machine keep their ids, so they are not given to another item.
+void IdMap_assign(IdMap *map, GContext *context) {
+  for (uint32_t k = 0; k < N_ID_KINDS; k++) {
+    const uint32_t n_items = count_items(context, k);
+    for (uint32_t i = 0; i < n_items; i++) {
+      const char_t *name = item_name(context, k, i);
+      if (IdMap_getId(map, k, name) == UINT32_MAX) { pin_name(map, k, name, map->counts[k]); }
+    }
+  }
+}
+
+uint32_t IdMap_getId(const IdMap *map, uint32_t kind, const char_t *name) {
+  uint32_t ndx = (uint64_t) Trie_get(map->index[kind], name);
+  if (!ndx) { return UINT32_MAX; }
+  return ((IdPin *) Array_real_addr(map->pins[kind], ndx - 1))->id;
+}
+
+int32_t IdMap_store(const IdMap *map, const char_t *path) {
+  FILE *fp = fopen(path, "w");
+  if (!fp) { return -1; }
+  for (uint32_t k = 0; k < N_ID_KINDS; k++) {
+    for (uint32_t i = 0; i < Array_length(map->pins[k]); i++) {
+      const IdPin *pin = Array_real_addr(map->pins[k], i);
+      fprintf(fp, "%s %s %u\n", ID_KIND_NAMES[k], pin->name, pin->id);
+    }
+  }
+  return fclose(fp) ? -1 : 0;
+}
+
+void IdMap_destroy(IdMap *map) {
+  for (uint32_t k = 0; k < N_ID_KINDS; k++) {
+    for (uint32_t i = 0; i < Array_length(map->pins[k]); i++) {
+      map->allocator->free(((IdPin *) Array_real_addr(map->pins[k], i))->name);
+    }
+    Array_destroy(map->pins[k]);
+    Trie_destroy(map->index[k]);
+  }
+  map->allocator->free(map);
+}
+
+// An enum per kind, with the value of every item written out and the count of ids last.
+// Without a map the ids are the offsets in the context, so the order of declaration.
+void gen_id_enums(GContext *context, Array *buffer, const IdMap *map) {
+  char_t temp_buffer[512] = {};
+  for (uint32_t k = 0; k < N_ID_KINDS; k++) {
+    const uint32_t n_items = count_items(context, k);
+    push_string("\nenum {\n");
+    for (uint32_t i = 0; i < n_items; i++) {
+      const char_t *name = item_name(context, k, i);
+      const uint32_t id = map ? IdMap_getId(map, k, name) : i;
+      sprintf(temp_buffer, "  %s%s = %u,\n", ID_ENUM_PREFIXES[k], name, id);
+      push_string(temp_buffer);
+    }
+    sprintf(temp_buffer, "  %s = %u,\n};\n", ID_COUNT_NAMES[k], map ? map->counts[k] : n_items);
+    push_string(temp_buffer);
+  }
+}
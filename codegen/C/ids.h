@@ -0,0 +1,46 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: ids.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_IDS_H
+#define MACHINE_IDS_H
+
+#include "context.h"
+
+// Registers, memories and immediates are numbered apart, each from zero.
+enum ID_KIND {
+  ID_REGISTER,
+  ID_MEMORY,
+  ID_IMMEDIATE,
+  N_ID_KINDS,
+};
+
+typedef struct IdPin {
+  char_t *name;
+  uint32_t id;
+} IdPin;
+
+// The ids given to names in earlier generations. A name keeps its id as long as it is in
+// the map, and a name the map does not know takes the id after the greatest one.
+typedef struct IdMap {
+  const Allocator *allocator;
+  Array /*<IdPin>*/ *pins[N_ID_KINDS];
+  Trie /*<uint32_t>*/ *index[N_ID_KINDS];
+  uint32_t counts[N_ID_KINDS];
+} IdMap;
+
+IdMap *IdMap_new(const Allocator *allocator);
+int32_t IdMap_load(IdMap *map, const char_t *path);
+void IdMap_assign(IdMap *map, GContext *context);
+uint32_t IdMap_getId(const IdMap *map, uint32_t kind, const char_t *name);
+int32_t IdMap_store(const IdMap *map, const char_t *path);
+void IdMap_destroy(IdMap *map);
+
+void gen_id_enums(GContext *context, Array *buffer, const IdMap *map);
+
+#endif  // MACHINE_IDS_H
@@ -0,0 +1,370 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: names.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "names.h"
+#include "array.h"
+#include "char_t.h"
+#include "tokens.gen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SEED (1U << 24)
+#define SEEDS_PER_LINE 8
+
+typedef struct NameKey {
+  uint32_t kind;
+  const char_t *name;
+  uint32_t length;
+  uint32_t n_forms;  // an instruction gives its op to all of its forms.
+  uint32_t offset;   // in the pool.
+  bool shared;       // the name is the end of the next one in the pool order.
+  bool unique;       // the first key of its kind and name, which the lookup finds.
+} NameKey;
+
+static const char_t *const NAME_KIND_NAMES[N_NAME_KINDS] = {
+    "NAME_REGISTER", "NAME_MEMORY", "NAME_IMMEDIATE", "NAME_INSTRUCTION"
+};
+static const char_t *const NAME_ID_PREFIXES[N_NAME_KINDS] = {
+    "enum_REG_", "enum_MEM_", "enum_IMM_", "enum_FORM_"
+};
+static const char_t *const NAME_TABLES[N_NAME_KINDS] = {
+    "REG_NAME", "MEM_NAME", "IMM_NAME", "FORM_OP"
+};
+static const char_t *const NAME_ACCESSORS[N_NAME_KINDS] = {
+    "REG_name", "MEM_name", "IMM_name", "FORM_op"
+};
+
+// The hash of the generated `NAME_lookup`: FNV-1a from a seeded basis, and a final mix so
+// that the low bits, which pick the slot, depend on every byte.
+const char_t NAME_HASH_DEF[] =
+    "static uint32_t NAME_hash(uint32_t kind, const char *name, uint32_t seed) {\n"
+    "  uint32_t hash = (0x811C9DC5U ^ seed) + kind;\n"
+    "  for (; *name; name++) { hash = (hash ^ (uint8_t) *name) * 0x01000193U; }\n"
+    "  hash ^= hash >> 15;\n"
+    "  hash *= 0x2C1B3C6DU;\n"
+    "  return hash ^ (hash >> 12);\n"
+    "}\n";
+
+// A bucket whose seed is negative holds one name, which is in the slot `-seed - 1`.
+const char_t NAME_LOOKUP_DEF[] =
+    "uint32_t NAME_lookup(uint32_t kind, const char *name) {\n"
+    "  const int32_t seed = NAME_SEEDS[NAME_hash(kind, name, 0) %% %u];\n"
+    "  const NameSlot *slot = &NAME_SLOTS[\n"
+    "      seed < 0 ? (uint32_t) (-seed - 1) : NAME_hash(kind, name, seed) %% %u\n"
+    "  ];\n"
+    "  const char *entry = NAME_POOL + slot->offset;\n"
+    "  while (*name && *name == *entry) {\n"
+    "    name++;\n"
+    "    entry++;\n"
+    "  }\n"
+    "  return (slot->kind == kind && *name == *entry) ? slot->id : UINT32_MAX;\n"
+    "}\n";
+
+const char_t NAME_SLOT_TYPE[] = "typedef struct {\n"
+                                "  uint32_t offset;\n"
+                                "  uint32_t kind;\n"
+                                "  uint32_t id;\n"
+                                "} NameSlot;\n";
+
+const char_t NAME_ACCESSOR_FMT[] =
+    "extern const uint32_t %s[];\n"
+    "static inline const char *%s(uint32_t id) { return NAME_POOL + %s[id]; }\n";
+
+void collect_keys(GContext *context, Machine *machine, Array *keys);
+int compare_reversed(const void *a, const void *b);
+void layout_pool(NameKey *sorted[], uint32_t n_keys);
+int32_t place_keys(
+    NameKey *keys[], uint32_t n_keys, int32_t seeds[], uint32_t slots[],
+    const Allocator *allocator
+);
+void gen_pool_def(Array *buffer, NameKey *sorted[], uint32_t n_keys);
+void gen_offset_def(Array *buffer, const NameKey keys[], uint32_t n_keys, uint32_t kind);
+void gen_lookup_def(
+    Array *buffer, NameKey *keys[], uint32_t n_keys, const int32_t seeds[], const uint32_t slots[]
+);
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+uint32_t name_hash(uint32_t kind, const char_t *name, uint32_t seed) {
+  uint32_t hash = (0x811C9DC5U ^ seed) + kind;
+  for (; *name; name++) { hash = (hash ^ (uint8_t) *name) * 0x01000193U; }
+  hash ^= hash >> 15;
+  hash *= 0x2C1B3C6DU;
+  return hash ^ (hash >> 12);
+}
+
+void collect_keys(GContext *context, Machine *machine, Array *keys) {
+  Array *arrays[3] = {context->regArray, context->memArray, context->immArray};
+  for (uint32_t k = 0; k < 3; k++) {
+    for (uint32_t i = 0; i < Array_length(arrays[k]); i++) {
+      const Identifier *name = nullptr;
+      if (NAME_REGISTER == k) { name = GContext_getRegister(context, i)->name; }
+      if (NAME_MEMORY == k) { name = GContext_getMemory(context, i)->name; }
+      if (NAME_IMMEDIATE == k) { name = GContext_getImmediate(context, i)->name; }
+      NameKey key = {.kind = k, .name = name->ptr, .length = name->len};
+      Array_append(keys, &key, 1);
+    }
+  }
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t e = 0; e < n_entries; e++) {
+    const Entry *entry = Array_real_addr(machine->entries, e);
+    if (enum_Instruction != entry->type) { continue; }
+    const Instruction *instr = entry->target;
+    if (0 == Array_length(instr->forms)) { continue; }
+    NameKey key = {
+        .kind = NAME_INSTRUCTION,
+        .name = instr->name->ptr,
+        .length = instr->name->len,
+        .n_forms = Array_length(instr->forms),
+    };
+    Array_append(keys, &key, 1);
+  }
+}
+
+// Orders the names from their last byte, so a name comes right before the names it ends.
+int compare_reversed(const void *a, const void *b) {
+  const NameKey *lhs = *(NameKey *const *) a, *rhs = *(NameKey *const *) b;
+  const uint32_t n = lhs->length < rhs->length ? lhs->length : rhs->length;
+  for (uint32_t i = 1; i <= n; i++) {
+    const int diff = (uint8_t) lhs->name[lhs->length - i] - (uint8_t) rhs->name[rhs->length - i];
+    if (diff) { return diff; }
+  }
+  if (lhs->length != rhs->length) { return lhs->length < rhs->length ? -1 : 1; }
+  return lhs->kind < rhs->kind ? -1 : lhs->kind > rhs->kind;
+}
+
+// A name which ends the next one in the order takes its last bytes, with the terminator,
+// instead of a place of its own; equal names share one place this way.
+void layout_pool(NameKey *sorted[], uint32_t n_keys) {
+  for (uint32_t i = 0; i + 1 < n_keys; i++) {
+    const NameKey *next = sorted[i + 1];
+    const uint32_t length = sorted[i]->length;
+    sorted[i]->shared = length <= next->length &&
+                        memcmp(next->name + next->length - length, sorted[i]->name, length) == 0;
+    sorted[i + 1]->unique =
+        !sorted[i]->shared || length != next->length || sorted[i]->kind != next->kind;
+  }
+  if (n_keys) { sorted[0]->unique = true; }
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i < n_keys; i++) {
+    if (sorted[i]->shared) { continue; }
+    sorted[i]->offset = offset;
+    offset += sorted[i]->length + 1;
+  }
+  for (uint32_t i = n_keys; i-- > 0;) {
+    if (!sorted[i]->shared) { continue; }
+    const NameKey *next = sorted[i + 1];
+    sorted[i]->offset = next->offset + next->length - sorted[i]->length;
+  }
+}
+
+// Hash and displace: the names are spread over `n_keys / 2 + 1` buckets, and the buckets,
+// largest first, get the first seed which puts all of their names in free slots. Returns -1
+// if no seed places a bucket or the scratch arrays can not be allocated.
+int32_t place_keys(
+    NameKey *keys[], uint32_t n_keys, int32_t seeds[], uint32_t slots[],
+    const Allocator *allocator
+) {
+  const uint32_t n_buckets = n_keys / 2 + 1;
+  uint32_t *buckets = allocator->calloc(n_keys, sizeof(uint32_t));
+  uint32_t *starts = allocator->calloc(n_buckets + 1, sizeof(uint32_t));
+  uint32_t *members = allocator->calloc(n_keys, sizeof(uint32_t));
+  uint32_t *order = allocator->calloc(n_buckets, sizeof(uint32_t));
+  uint32_t *candidates = allocator->calloc(n_keys, sizeof(uint32_t));
+  int32_t result = (buckets && starts && members && order && candidates) ? 0 : -1;
+  for (uint32_t i = 0; 0 == result && i < n_keys; i++) {
+    buckets[i] = name_hash(keys[i]->kind, keys[i]->name, 0) % n_buckets;
+    starts[buckets[i] + 1]++;
+  }
+  for (uint32_t b = 0; 0 == result && b < n_buckets; b++) { starts[b + 1] += starts[b]; }
+  // `order` counts the members placed in each bucket until it is sorted.
+  for (uint32_t i = 0; 0 == result && i < n_keys; i++) {
+    members[starts[buckets[i]] + order[buckets[i]]++] = i;
+  }
+  for (uint32_t b = 0; 0 == result && b < n_buckets; b++) {
+    const uint32_t size = starts[b + 1] - starts[b];
+    uint32_t k = b;
+    for (; k > 0 && starts[order[k - 1] + 1] - starts[order[k - 1]] < size; k--) {
+      order[k] = order[k - 1];
+    }
+    order[k] = b;
+  }
+
+  for (uint32_t i = 0; 0 == result && i < n_keys; i++) { slots[i] = UINT32_MAX; }
+  uint32_t next_free = 0;
+  for (uint32_t o = 0; 0 == result && o < n_buckets; o++) {
+    const uint32_t b = order[o], size = starts[b + 1] - starts[b];
+    const uint32_t *member = &members[starts[b]];
+    seeds[b] = 0;
+    if (1 == size) {
+      while (slots[next_free] != UINT32_MAX) { next_free++; }
+      slots[next_free] = member[0];
+      seeds[b] = -(int32_t) next_free - 1;
+      continue;
+    }
+    uint32_t seed = 1;
+    for (; size && seed < MAX_SEED; seed++) {
+      uint32_t j = 0;
+      for (; j < size; j++) {
+        const NameKey *key = keys[member[j]];
+        candidates[j] = name_hash(key->kind, key->name, seed) % n_keys;
+        bool taken = slots[candidates[j]] != UINT32_MAX;
+        for (uint32_t t = 0; !taken && t < j; t++) { taken = candidates[t] == candidates[j]; }
+        if (taken) { break; }
+      }
+      if (j == size) { break; }
+    }
+    if (size && seed == MAX_SEED) { result = -1; }
+    for (uint32_t j = 0; 0 == result && j < size; j++) { slots[candidates[j]] = member[j]; }
+    seeds[b] = size ? (int32_t) seed : 0;
+  }
+  allocator->free(candidates);
+  allocator->free(order);
+  allocator->free(members);
+  allocator->free(starts);
+  allocator->free(buckets);
+  return result;
+}
+
+// The pool is one string literal per place, which keeps a name from running into the
+// digits of an escape.
+void gen_pool_def(Array *buffer, NameKey *sorted[], uint32_t n_keys) {
+  push_string("\nconst char NAME_POOL[] =\n");
+  for (uint32_t i = 0; i < n_keys; i++) {
+    if (sorted[i]->shared) { continue; }
+    push_string("    \"");
+    Array_append(buffer, sorted[i]->name, sorted[i]->length);
+    push_string("\\0\"\n");
+  }
+  push_string("    ;\n");
+}
+
+void gen_offset_def(Array *buffer, const NameKey keys[], uint32_t n_keys, uint32_t kind) {
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, "\nconst uint32_t %s[] = {\n", NAME_TABLES[kind]);
+  push_string(temp_buffer);
+  for (uint32_t i = 0; i < n_keys; i++) {
+    if (keys[i].kind != kind) { continue; }
+    if (NAME_INSTRUCTION != kind) {
+      const char_t *prefix = NAME_ID_PREFIXES[kind];
+      sprintf(temp_buffer, "  [%s%s] = %u,\n", prefix, keys[i].name, keys[i].offset);
+      push_string(temp_buffer);
+      continue;
+    }
+    for (uint32_t f = 0; f < keys[i].n_forms; f++) {
+      sprintf(temp_buffer, "  [enum_FORM_%s_%u] = %u,\n", keys[i].name, f, keys[i].offset);
+      push_string(temp_buffer);
+    }
+  }
+  push_string("};\n");
+}
+
+void gen_lookup_def(
+    Array *buffer, NameKey *keys[], uint32_t n_keys, const int32_t seeds[], const uint32_t slots[]
+) {
+  char_t temp_buffer[512] = {};
+  const uint32_t n_buckets = n_keys / 2 + 1;
+  push_string("\n");
+  push_string(NAME_SLOT_TYPE);
+  sprintf(temp_buffer, "static const int32_t NAME_SEEDS[%u] = {", n_buckets);
+  push_string(temp_buffer);
+  for (uint32_t b = 0; b < n_buckets; b++) {
+    sprintf(temp_buffer, "%s%d,", (b % SEEDS_PER_LINE) ? " " : "\n   ", seeds[b]);
+    push_string(temp_buffer);
+  }
+  sprintf(temp_buffer, "\n};\nstatic const NameSlot NAME_SLOTS[%u] = {\n", n_keys);
+  push_string(temp_buffer);
+  for (uint32_t s = 0; s < n_keys; s++) {
+    const NameKey *key = keys[slots[s]];
+    const char_t *suffix = (NAME_INSTRUCTION == key->kind) ? "_0" : "";
+    sprintf(
+        temp_buffer, "  {%u, %s, %s%s%s},\n", key->offset, NAME_KIND_NAMES[key->kind],
+        NAME_ID_PREFIXES[key->kind], key->name, suffix
+    );
+    push_string(temp_buffer);
+  }
+  push_string("};\n");
+  push_string(NAME_HASH_DEF);
+  sprintf(temp_buffer, NAME_LOOKUP_DEF, n_buckets, n_keys);
+  push_string(temp_buffer);
+}
+
+// All the names of the machine are in one `NAME_POOL`, and the tables of names hold offsets
+// into it rather than pointers, so they need no relocation when loaded. `NAME_lookup` goes
+// back from a name to its id through a minimal perfect hash of the pool.
+int32_t gen_name_pool(GContext *context, Array *dec_buffer, Array *def_buffer, Machine *machine) {
+  const Allocator *allocator = GContext_getAllocator(context);
+  Array *key_array = Array_new(sizeof(NameKey), -1, allocator);
+  collect_keys(context, machine, key_array);
+  const uint32_t n_keys = Array_length(key_array);
+  if (0 == n_keys) {
+    releasePrimeArray(key_array);
+    return 0;
+  }
+  NameKey *keys = Array_real_addr(key_array, 0);
+  NameKey **sorted = allocator->calloc(n_keys, sizeof(NameKey *));
+  for (uint32_t i = 0; i < n_keys; i++) { sorted[i] = &keys[i]; }
+  qsort(sorted, n_keys, sizeof(NameKey *), compare_reversed);
+  layout_pool(sorted, n_keys);
+
+  uint32_t n_unique = 0;
+  bool has_kind[N_NAME_KINDS] = {};
+  for (uint32_t i = 0; i < n_keys; i++) {
+    if (sorted[i]->unique) { sorted[n_unique++] = sorted[i]; }
+    has_kind[keys[i].kind] = true;
+  }
+  int32_t *seeds = allocator->calloc(n_unique / 2 + 1, sizeof(int32_t));
+  uint32_t *slots = allocator->calloc(n_unique, sizeof(uint32_t));
+  const int32_t result =
+      (seeds && slots) ? place_keys(sorted, n_unique, seeds, slots, allocator) : -1;
+
+  // the pool is written in the order of `layout_pool`, which `sorted` no longer has.
+  for (uint32_t i = 0; i < n_keys; i++) { sorted[i] = &keys[i]; }
+  qsort(sorted, n_keys, sizeof(NameKey *), compare_reversed);
+
+  Array *buffer = dec_buffer;
+  char_t temp_buffer[512] = {};
+  push_string("\nenum {\n");
+  for (uint32_t k = 0; k < N_NAME_KINDS; k++) {
+    sprintf(temp_buffer, "  %s,\n", NAME_KIND_NAMES[k]);
+    push_string(temp_buffer);
+  }
+  push_string("};\nextern const char NAME_POOL[];\n");
+  for (uint32_t k = 0; k < N_NAME_KINDS; k++) {
+    if (!has_kind[k]) { continue; }
+    const char_t *table = NAME_TABLES[k];
+    sprintf(temp_buffer, NAME_ACCESSOR_FMT, table, NAME_ACCESSORS[k], table);
+    push_string(temp_buffer);
+  }
+  if (0 == result) {
+    push_string("// The id of `name` among the items of `kind`, the first form of an\n");
+    push_string("// instruction, or `UINT32_MAX` for a name which is not one of them.\n");
+    push_string("uint32_t NAME_lookup(uint32_t kind, const char *name);\n");
+  }
+
+  buffer = def_buffer;
+  gen_pool_def(buffer, sorted, n_keys);
+  for (uint32_t k = 0; k < N_NAME_KINDS; k++) {
+    if (has_kind[k]) { gen_offset_def(buffer, keys, n_keys, k); }
+  }
+  if (0 == result) {
+    for (uint32_t i = 0, n = 0; i < n_keys; i++) {
+      if (sorted[i]->unique) { sorted[n++] = sorted[i]; }
+    }
+    gen_lookup_def(buffer, sorted, n_unique, seeds, slots);
+  }
+
+  allocator->free(slots);
+  allocator->free(seeds);
+  allocator->free(sorted);
+  releasePrimeArray(key_array);
+  return result;
+}
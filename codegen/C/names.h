@@ -0,0 +1,29 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: names.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_NAMES_H
+#define MACHINE_NAMES_H
+
+#include "context.h"
+#include "target.h"
+
+// The kinds of names in the pool, which are also the kinds of `NAME_lookup`.
+enum NAME_KIND {
+  NAME_REGISTER,
+  NAME_MEMORY,
+  NAME_IMMEDIATE,
+  NAME_INSTRUCTION,
+  N_NAME_KINDS,
+};
+
+uint32_t name_hash(uint32_t kind, const char_t *name, uint32_t seed);
+
+int32_t gen_name_pool(GContext *context, Array *dec_buffer, Array *def_buffer, Machine *machine);
+
+#endif  // MACHINE_NAMES_H
@@ -0,0 +1,219 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: select.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "select.h"
+#include "char_t.h"
+#include "tokens.gen.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_SELECT_ARGS 8
+
+typedef char_t ArgKinds[MAX_SELECT_ARGS + 1];
+
+char_t select_arg_kind(GContext *context, const Identifier *arg);
+void gen_item_test(GContext *context, Array *buffer, const Record *record, uint32_t index);
+void gen_selector_head(Array *buffer, const char_t *instr_op, const char_t *kinds);
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+#define getFormArgs(form) \
+  ((form).pattern->args ? Array_real_addr((form).pattern->args, 0) : nullptr)
+#define countFormArgs(form) ((form).pattern->args ? Array_length((form).pattern->args) : 0)
+
+// The operand kinds of a selector are in its name, like `encode_add_ri`:
+// `r` for registers, `m` for memories and `i` for immediates.
+char_t select_arg_kind(GContext *context, const Identifier *arg) {
+  const Record *record = GContext_findRecord(context, arg);
+  uint32_t typeid = record->typeid;
+  if (enum_Set == typeid) { typeid = GContext_getSet(context, record->offset)->type; }
+  switch (typeid) {
+    case enum_Register:
+    case enum_RegisterGroup: return 'r';
+    case enum_Memory: return 'm';
+    case enum_Immediate: return 'i';
+  }
+  return '\0';
+}
+
+void gen_item_test(GContext *context, Array *buffer, const Record *record, uint32_t index) {
+  char_t temp_buffer[512] = {};
+  switch (record->typeid) {
+    case enum_Register: {
+      const Register *reg = GContext_getRegister(context, record->offset);
+      sprintf(temp_buffer, "a%d->type == enum_REG_%s", index, reg->name->ptr);
+      break;
+    }
+    case enum_Memory: {
+      const Memory *mem = GContext_getMemory(context, record->offset);
+      sprintf(temp_buffer, "a%d->type == enum_MEM_%s", index, mem->name->ptr);
+      break;
+    }
+    case enum_Immediate: {
+      const Immediate *imm = GContext_getImmediate(context, record->offset);
+      sprintf(temp_buffer, "IMM_%s_fits(IMM_value(a%d))", imm->name->ptr, index);
+      break;
+    }
+    case enum_RegisterGroup: {
+      const RegisterGroup *grp = GContext_getRegisterGroup(context, record->offset);
+      const uint32_t n_regs = Array_length(grp->registers);
+      REFER(Register) *regs = Array_real_addr(grp->registers, 0);
+      push_string("(");
+      for (uint32_t i = 0; i < n_regs; i++) {
+        const Register *reg = Array_vert2real(context->regArray, regs[i]);
+        sprintf(temp_buffer, "%sa%d->type == enum_REG_%s", i ? " || " : "", index, reg->name->ptr);
+        push_string(temp_buffer);
+      }
+      push_string(")");
+      return;
+    }
+    case enum_Set: {
+      // an immediate of a set is a member by its type and also has to fit in it.
+      const Set *set = GContext_getSet(context, record->offset);
+      const uint32_t n_items = Array_length(set->items);
+      const SetItem *items = Array_real_addr(set->items, 0);
+      push_string("(");
+      for (uint32_t i = 0; i < n_items; i++) {
+        const Record *item = GContext_findRecord(context, items[i].name);
+        const char_t *name = items[i].name->ptr;
+        if (i) { push_string(" || "); }
+        if (enum_Immediate == set->type) {
+          sprintf(
+              temp_buffer, "(a%d->type == enum_IMM_%s && IMM_%s_fits(IMM_value(a%d)))", index,
+              name, name, index
+          );
+          push_string(temp_buffer);
+        } else {
+          gen_item_test(context, buffer, item, index);
+        }
+      }
+      push_string(")");
+      return;
+    }
+  }
+  push_string(temp_buffer);
+}
+
+// The ids of registers, memories and immediates overlap, so every operand is tested for its
+// kind before its id or its value. Returns whether the test holds for every operand of the
+// right kinds, which is when the only arguments are immediates of 64 bits.
+bool gen_form_test(GContext *context, Array *buffer, const InstrForm *form) {
+  const uint32_t n_args = countFormArgs(*form);
+  const Identifier *args = getFormArgs(*form);
+  char_t temp_buffer[512] = {};
+  bool always = true;
+  for (uint32_t j = 0; j < n_args; j++) {
+    const char_t kind = select_arg_kind(context, &args[j]);
+    const char_t *kind_name = ('r' == kind)   ? "ENTRY_REGISTER"
+                              : ('m' == kind) ? "ENTRY_MEMORY"
+                                              : "ENTRY_IMMEDIATE";
+    sprintf(temp_buffer, "%sa%d->kind == %s", j ? " && " : "", j, kind_name);
+    push_string(temp_buffer);
+    const Record *record = GContext_findRecord(context, &args[j]);
+    if (enum_Immediate == record->typeid &&
+        GContext_getImmediate(context, record->offset)->width >= 64) {
+      continue;
+    }
+    always = false;
+    push_string(" && ");
+    gen_item_test(context, buffer, record, j);
+  }
+  return always;
+}
+
+void gen_selector_head(Array *buffer, const char_t *instr_op, const char_t *kinds) {
+  char_t temp_buffer[512] = {};
+  const uint32_t n_args = strlen(kinds);
+  sprintf(temp_buffer, "uint32_t encode_%s%s%s(", instr_op, n_args ? "_" : "", kinds);
+  push_string(temp_buffer);
+  for (uint32_t j = 0; j < n_args; j++) {
+    sprintf(temp_buffer, "const Entry *a%d, ", j);
+    push_string(temp_buffer);
+  }
+  push_string("Array *buffer)");
+}
+
+// Forms whose arguments are of the same kinds share a selector. It tries them from the
+// narrowest to the widest, and a form whose test holds for any operands of its kinds ends the
+// sequence.
+int32_t gen_instr_selectors(
+    GContext *context, Array *dec_buffer, Array *def_buffer, const char_t *instr_op,
+    const InstrForm forms[], uint32_t n_forms
+) {
+  const Allocator *allocator = GContext_getAllocator(context);
+  ArgKinds *kinds = allocator->calloc(n_forms, sizeof(ArgKinds));
+  uint32_t *order = allocator->calloc(n_forms, sizeof(uint32_t));
+  bool *done = allocator->calloc(n_forms, sizeof(bool));
+
+  for (uint32_t i = 0; i < n_forms; i++) {
+    const uint32_t n_args = countFormArgs(forms[i]);
+    const Identifier *args = getFormArgs(forms[i]);
+    done[i] = n_args > MAX_SELECT_ARGS;
+    for (uint32_t j = 0; !done[i] && j < n_args; j++) {
+      kinds[i][j] = select_arg_kind(context, &args[j]);
+      done[i] = '\0' == kinds[i][j];
+    }
+    // insertion sort by width, forms of the same width keep their order.
+    uint32_t k = i;
+    for (; k > 0 && forms[order[k - 1]].width > forms[i].width; k--) { order[k] = order[k - 1]; }
+    order[k] = i;
+  }
+
+  char_t temp_buffer[512] = {};
+  for (uint32_t p = 0; p < n_forms; p++) {
+    if (done[order[p]]) { continue; }
+    const char_t *group = kinds[order[p]];
+    Array *buffer = dec_buffer;
+    gen_selector_head(buffer, instr_op, group);
+    push_string(";\n");
+    buffer = def_buffer;
+    gen_selector_head(buffer, instr_op, group);
+    push_string(" {\n");
+    bool closed = false;
+    for (uint32_t q = p; q < n_forms; q++) {
+      const uint32_t i = order[q];
+      if (done[i] || strcmp(kinds[i], group) != 0) { continue; }
+      done[i] = true;
+      if (closed) { continue; }
+      const uint32_t n_args = countFormArgs(forms[i]);
+      const Identifier *args = getFormArgs(forms[i]);
+      bool always = true;
+      if (n_args) {
+        push_string("  if (");
+        always = gen_form_test(context, buffer, &forms[i]);
+        push_string(") { return ");
+      } else {
+        push_string("  return ");
+      }
+      sprintf(temp_buffer, "encoding_%s_%d(", instr_op, i);
+      push_string(temp_buffer);
+      for (uint32_t j = 0; j < n_args; j++) {
+        // an immediate of a narrower type than the form is passed sign-extended.
+        const Record *record = GContext_findRecord(context, &args[j]);
+        const char_t *fmt = (enum_Set == record->typeid)         ? "a%d, "
+                            : (enum_Immediate == record->typeid) ? "IMM_value(a%d), "
+                                                                 : "a%d->value, ";
+        sprintf(temp_buffer, fmt, j);
+        push_string(temp_buffer);
+      }
+      push_string(n_args ? "buffer); }\n" : "buffer);\n");
+      closed = always;
+    }
+    // operands of other kinds fall through every test.
+    if (group[0]) { push_string("  return 0;\n"); }
+    push_string("}\n");
+  }
+
+  allocator->free(done);
+  allocator->free(order);
+  allocator->free(kinds);
+  return 0;
+}
@@ -0,0 +1,22 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: select.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_SELECT_H
+#define MACHINE_SELECT_H
+
+#include "context.h"
+#include "target.h"
+
+bool gen_form_test(GContext *context, Array *buffer, const InstrForm *form);
+int32_t gen_instr_selectors(
+    GContext *context, Array *dec_buffer, Array *def_buffer, const char_t *instr_op,
+    const InstrForm forms[], uint32_t n_forms
+);
+
+#endif  // MACHINE_SELECT_H
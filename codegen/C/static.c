@@ -48,33 +48,79 @@ const char_t HEADER_FMT[] =
     " *\n"
     " **/";
 
-const char_t MACROS[] = "#define min(a, b)             ((a) < (b)) ? (a) : (b)\n"
-                        "#define UINT_N_MAX(n_bits)    ((1LLU << (n_bits)) - 1)\n"
-                        "#define LOW_BITS(val, n_bits) ((val) & UINT_N_MAX(n_bits))\n"
-                        "#define MASK_BITS(bl, bu)     (UINT_N_MAX(bu) - UINT_N_MAX(bl))\n"
-                        "#define numSetBits(num, bl, bu, val) \\\n"
-                        "  (((num) & ~MASK_BITS(bl, bu)) | (LOW_BITS(val, (bu) - (bl)) << (bl)))\n"
-                        "#define setEncodingNumber(val) \\\n"
-                        "  do { number = (val); } while (false)\n"
-                        "#define pushInstrBytes(_count)                 \\\n"
-                        "  do {                                         \\\n"
-                        "    uint32_t last = min(_count + index, size); \\\n"
-                        "    for (uint32_t i = index; i < last; i++) {  \\\n"
-                        "      bytes[i] = number & 0xFF;                \\\n"
-                        "      number >>= 8;                            \\\n"
-                        "    }                                          \\\n"
-                        "    index = last;                              \\\n"
+// The macros of the encoder bodies which do not store bytes, shared with `codegen/CXX`.
+const char_t FIELD_MACROS[] =
+    "#define UINT_N_MAX(n_bits) \\\n"
+    "  ((n_bits) >= 64 ? ~0LLU : (1LLU << (n_bits)) - 1)\n"
+    "#define LOW_BITS(val, n_bits) ((val) & UINT_N_MAX(n_bits))\n"
+    "#define MASK_BITS(bl, bu)     (UINT_N_MAX(bu) - UINT_N_MAX(bl))\n"
+    "#define FITS_UNSIGNED(val, n_bits) \\\n"
+    "  (((uint64_t) (val) & ~UINT_N_MAX(n_bits)) == 0)\n"
+    "#define FITS_SIGNED(val, n_bits) \\\n"
+    "  ((uint64_t) (val) + (1LLU << ((n_bits) - 1)) <= UINT_N_MAX(n_bits))\n"
+    "#define SIGN_EXTEND(val, n_bits) \\\n"
+    "  ((int64_t) ((uint64_t) (val) << (64 - (n_bits))) >> (64 - (n_bits)))\n"
+    "#define numSetBits(num, bl, bu, val) \\\n"
+    "  (((num) & ~MASK_BITS(bl, bu)) | (LOW_BITS(val, (bu) - (bl)) << (bl)))\n"
+    "#define HALFWORDS_REVERSE64(val)                             \\\n"
+    "  ((((val) >> 48) & 0xFFFF) | (((val) >> 16) & 0xFFFF0000) | \\\n"
+    "   (((val) & 0xFFFF0000) << 16) | ((val) << 48))\n"
+    "#define setEncodingNumber(val) \\\n"
+    "  do { number = (val); } while (false)\n"
+    "#define pushEncodingNumber(val, count) \\\n"
+    "  do {                                 \\\n"
+    "    setEncodingNumber(val);            \\\n"
+    "    pushInstrBytes(count);             \\\n"
+    "  } while (false)\n"
+    "#define pushEncodingNumberBE(val, count) \\\n"
+    "  do {                                   \\\n"
+    "    setEncodingNumber(val);              \\\n"
+    "    pushInstrBytesBE(count);             \\\n"
+    "  } while (false)\n"
+    "#define pushEncodingNumberHW(val, count) \\\n"
+    "  do {                                   \\\n"
+    "    setEncodingNumber(val);              \\\n"
+    "    pushInstrBytesHW(count);             \\\n"
+    "  } while (false)\n";
+
+const char_t MACROS[] = "#include <assert.h>\n"
+                        "#include <string.h>\n"
+                        "#define min(a, b)             (((a) < (b)) ? (a) : (b))\n"
+                        "#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__\n"
+                        "#define TO_LE64(val) __builtin_bswap64(val)\n"
+                        "#define TO_BE64(val) (val)\n"
+                        "#else\n"
+                        "#define TO_LE64(val) (val)\n"
+                        "#define TO_BE64(val) __builtin_bswap64(val)\n"
+                        "#endif\n"
+                        "#define storeInstrBytes(word, _count)               \\\n"
+                        "  do {                                              \\\n"
+                        "    const uint64_t stored = (word);                 \\\n"
+                        "    memcpy(&bytes[index], &stored, sizeof(stored)); \\\n"
+                        "    index = min((_count) + index, size);            \\\n"
+                        "    number = 0;                                     \\\n"
                         "  } while (false)\n"
-                        "#define pushEncodingNumber(val, count) \\\n"
-                        "  do {                                 \\\n"
-                        "    setEncodingNumber(val);            \\\n"
-                        "    pushInstrBytes(count);             \\\n"
-                        "  } while (false)\n";
+                        "#define pushInstrBytes(_count) storeInstrBytes(TO_LE64(number), _count)\n"
+                        "#define pushInstrBytesBE(_count) \\\n"
+                        "  storeInstrBytes(TO_BE64(number << (64 - 8 * (_count))), _count)\n"
+                        "#define pushInstrBytesHW(_count)                                   \\\n"
+                        "  storeInstrBytes(                                                \\\n"
+                        "      TO_LE64(HALFWORDS_REVERSE64(number << (64 - 8 * (_count)))), \\\n"
+                        "      _count                                                       \\\n"
+                        "  )\n";
 
-const char_t TYPE_DEFS[] = "typedef struct {\n"
+const char_t TYPE_DEFS[] = "enum { ENTRY_REGISTER = 1, ENTRY_MEMORY, ENTRY_IMMEDIATE };\n"
+                           "typedef struct {\n"
+                           "  uint32_t kind;\n"
                            "  uint32_t type;\n"
                            "  uint64_t value;\n"
-                           "} Entry;\n";
+                           "} Entry;\n"
+                           "typedef struct {\n"
+                           "  uint8_t base_lower;\n"
+                           "  uint8_t base_width;\n"
+                           "  uint8_t offset_lower;\n"
+                           "  uint8_t offset_width;\n"
+                           "} MemLayout;\n";
 
 const char_t JUMP_ITEM[] = "struct jump_item {\n"
                            "  uint32_t expected_type;\n"
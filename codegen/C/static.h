@@ -12,6 +12,11 @@
 
 #include "generate.h"
 
+extern const char_t HEADER_FMT[];
+extern const char_t FIELD_MACROS[];
+extern const char_t MACROS[];
+extern const char_t TYPE_DEFS[];
+
 int32_t set_header(Generator *generator, char_t *filename, int32_t year, char_t *cr_holder);
 
 #endif  // MACHINE_STATIC_H
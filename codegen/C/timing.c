@@ -0,0 +1,74 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: timing.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "timing.h"
+#include "char_t.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+const char_t FORM_ENUM_FMT[] = "  enum_FORM_%s_%u,\n";
+const char_t FORM_TIMING_FMT[] = "  [enum_FORM_%s_%u] = {.latency = %u},\n";
+const char_t FORM_SIZE_FMT[] = "  [enum_FORM_%s_%u] = %u,\n";
+
+// Emitted once ahead of `FORM_TIMING`, whose items come from `gen_form_timing_def`.
+// An entry takes 4 bytes, so one cache line holds the timing of 16 forms.
+const char_t TIMING_DEFS[] =
+    "typedef struct {\n"
+    "  uint32_t latency;\n"
+    "} FormTiming;\n"
+    "extern const FormTiming FORM_TIMING[];\n"
+    "extern const uint8_t FORM_SIZE[];\n"
+    "\n"
+    "static inline uint32_t FORM_latency(uint32_t form) {\n"
+    "  return FORM_TIMING[form].latency;\n"
+    "}\n"
+    "\n"
+    "// Picks the candidate to issue at `cycle`: the ready one with the longest latency.\n"
+    "// Returns `n` if no candidate is ready.\n"
+    "static inline uint32_t schedulePick(\n"
+    "    const uint32_t forms[], const uint32_t ready_at[], uint32_t n, uint32_t cycle\n"
+    ") {\n"
+    "  uint32_t picked = n, latency = 0;\n"
+    "  for (uint32_t i = 0; i < n; i++) {\n"
+    "    const FormTiming timing = FORM_TIMING[forms[i]];\n"
+    "    if (ready_at[i] > cycle) { continue; }\n"
+    "    if (picked == n || timing.latency > latency) {\n"
+    "      picked = i;\n"
+    "      latency = timing.latency;\n"
+    "    }\n"
+    "  }\n"
+    "  return picked;\n"
+    "}\n";
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+void gen_form_enum_item(GContext *, Array *buffer, const char_t *instr_op, uint32_t index) {
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, FORM_ENUM_FMT, instr_op, index);
+  push_string(temp_buffer);
+}
+
+void gen_form_timing_def(
+    GContext *, Array *buffer, const char_t *instr_op, uint32_t index, const InstrForm *form
+) {
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, FORM_TIMING_FMT, instr_op, index, form->tick);
+  push_string(temp_buffer);
+}
+
+// The size in bytes of a form, which the relaxation of branches in `runtime/relax.h` takes.
+void gen_form_size_def(
+    GContext *, Array *buffer, const char_t *instr_op, uint32_t index, const InstrForm *form
+) {
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, FORM_SIZE_FMT, instr_op, index, form->width / 8);
+  push_string(temp_buffer);
+}
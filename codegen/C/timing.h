@@ -0,0 +1,27 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/C
+ * Filename: timing.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_TIMING_H
+#define MACHINE_TIMING_H
+
+#include "context.h"
+
+extern const char_t TIMING_DEFS[];
+
+void gen_form_enum_item(GContext *context, Array *buffer, const char_t *instr_op, uint32_t index);
+void gen_form_timing_def(
+    GContext *context, Array *buffer, const char_t *instr_op, uint32_t index,
+    const InstrForm *form
+);
+void gen_form_size_def(
+    GContext *context, Array *buffer, const char_t *instr_op, uint32_t index,
+    const InstrForm *form
+);
+
+#endif  // MACHINE_TIMING_H
@@ -0,0 +1,169 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: backend.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "backend.h"
+#include "context.h"
+#include "define.h"
+#include "emit.h"
+#include "encoder.h"
+#include "ids.h"
+#include "operand.h"
+#include "prelude.h"
+#include "static.h"
+#include "target.h"
+#include "tokens.gen.h"
+#include <stdio.h>
+#include <string.h>
+
+// The outputs share the buffers of `codegen/C`, as one parse only runs one backend.
+// `emit_cxx_header` puts them in one header in the order: the prelude, id enums, register
+// table, register, memory, immediate and set definitions, the encoders and then the epilogue.
+
+int32_t codegen_cxx_memory(GContext *context, REFER(Memory) mem) {
+  mem = Array_vert2real(context->memArray, mem);
+
+  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_memory_def);
+
+  gen_cxx_memory_def(context, def_buffer, mem);
+
+  return 0;
+}
+
+int32_t codegen_cxx_immediate(GContext *context, REFER(Immediate) imm) {
+  imm = Array_vert2real(context->immArray, imm);
+
+  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_immediate_def);
+
+  gen_cxx_immediate_def(context, def_buffer, imm);
+
+  return 0;
+}
+
+int32_t codegen_cxx_register_group(GContext *context, REFER(RegisterGroup) grp) {
+  grp = Array_vert2real(context->grpArray, grp);
+
+  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_register_def);
+
+  const uint32_t n_regs = Array_length(grp->registers);
+  REFER(Register) *regs = Array_real_addr(grp->registers, 0);
+  for (uint32_t i = 0; i < n_regs; i++) {
+    const Register *reg = Array_vert2real(context->regArray, regs[i]);
+    gen_cxx_register_def(context, def_buffer, reg);
+  }
+  return 0;
+}
+
+int32_t codegen_cxx_set(GContext *context, REFER(Set) set) {
+  set = Array_vert2real(context->setArray, set);
+
+  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_set_def);
+
+  gen_cxx_set_def(context, def_buffer, set);
+
+  return 0;
+}
+
+int32_t codegen_cxx_instruction(GContext *context, Instruction *instr) {
+  const InstrForm *forms = Array_real_addr(instr->forms, 0);
+  const uint32_t n_forms = Array_length(instr->forms);
+
+  Array *def_buffer = GContext_getOutputBuffer(context, CtxBuf_encoding_def);
+
+  gen_cxx_instr_encoders(context, def_buffer, instr->name->ptr, forms, n_forms);
+
+  return 0;
+}
+
+int32_t codegen_cxx_machine(GContext *context, Machine *) {
+  Array *enum_buffer = GContext_getOutputBuffer(context, CtxBuf_enum_item);
+  Array *table_buffer = GContext_getOutputBuffer(context, CtxBuf_register_table);
+  Array *imm_buffer = GContext_getOutputBuffer(context, CtxBuf_immediate_def);
+
+  gen_id_enums(context, enum_buffer, nullptr);
+  gen_cxx_register_table(context, table_buffer);
+  gen_cxx_immediate_value(context, imm_buffer);
+
+  return 0;
+}
+
+codegen_t *get_cxx_codegen(uint32_t type) {
+  switch (type) {
+    case enum_Memory: {
+      return (codegen_t *) codegen_cxx_memory;
+    }
+    case enum_Immediate: {
+      return (codegen_t *) codegen_cxx_immediate;
+    }
+    case enum_RegisterGroup: {
+      return (codegen_t *) codegen_cxx_register_group;
+    }
+    case enum_Instruction: {
+      return (codegen_t *) codegen_cxx_instruction;
+    }
+    case enum_Set: {
+      return (codegen_t *) codegen_cxx_set;
+    }
+    case enum_Machine: {
+      return (codegen_t *) codegen_cxx_machine;
+    }
+  }
+  return nullptr;
+}
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+// Everything is `constexpr` or `consteval`, so the whole backend is one header.
+// With `ids`, the enums of the items take the ids of the map, as in `emit_c_header`.
+int32_t emit_cxx_header(Generator *generator, const char_t *guard, const IdMap *ids) {
+  Array *buffer = generator->buffer;
+  char_t temp_buffer[512] = {};
+  sprintf(temp_buffer, "\n#ifndef %s\n#define %s\n\n", guard, guard);
+  push_string(temp_buffer);
+  push_string(CXX_PRELUDE);
+  push_string(FIELD_MACROS);
+  push_string("\n");
+  push_string(CXX_TYPE_DEFS);
+  push_string("\n");
+  if (ids) {
+    gen_id_enums(generator->context, buffer, ids);
+  } else {
+    emit_output(generator, CtxBuf_enum_item);
+  }
+  push_string("\n");
+  emit_output(generator, CtxBuf_register_table);
+  emit_output(generator, CtxBuf_register_def);
+  emit_output(generator, CtxBuf_memory_def);
+  emit_output(generator, CtxBuf_immediate_def);
+  emit_output(generator, CtxBuf_set_def);
+  push_string("\n");
+  emit_output(generator, CtxBuf_encoding_def);
+  push_string("\n");
+  push_string(CXX_EPILOGUE);
+  sprintf(temp_buffer, "\n#endif  // %s\n", guard);
+  push_string(temp_buffer);
+  return (int32_t) Array_length(buffer);
+}
+
+// Writes `<name>.hpp` into `header` after the license header.
+int32_t emit_cxx_file(
+    GContext *context, const char_t *name, int32_t year, char_t *holder, const IdMap *ids,
+    Array *header
+) {
+  if (strlen(name) + 5 > MAX_NAME) { return -1; }
+  char_t header_name[MAX_NAME] = {}, guard[MAX_GUARD] = {};
+  sprintf(header_name, "%s.hpp", name);
+  header_guard(header_name, guard);
+
+  Generator generator = {.allocator = GContext_getAllocator(context), .context = context};
+  generator.buffer = header;
+  if (set_header(&generator, header_name, year, holder) < 0) { return -1; }
+  emit_cxx_header(&generator, guard, ids);
+  return 0;
+}
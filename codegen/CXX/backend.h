@@ -0,0 +1,26 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: backend.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_BACKEND_H
+#define MACHINE_BACKEND_H
+
+#include "codegen.h"
+#include "generate.h"
+#include "ids.h"
+#include <stdint.h>
+
+codegen_t *get_cxx_codegen(uint32_t type);
+
+int32_t emit_cxx_header(Generator *generator, const char_t *guard, const IdMap *ids);
+int32_t emit_cxx_file(
+    GContext *context, const char_t *name, int32_t year, char_t *holder, const IdMap *ids,
+    Array *header
+);
+
+#endif  // MACHINE_BACKEND_H
@@ -0,0 +1,96 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: encoder.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "encoder.h"
+#include "encoding.h"
+#include "select.h"
+#include "tokens.gen.h"
+#include <stdio.h>
+#include <string.h>
+
+const char_t CXX_ENCODER_HEAD_FMT[] = "constexpr std::array<uint8_t, %d> encoding_%s_%d(";
+const char_t CXX_DETAIL_OPEN[] = "namespace machine_detail {\n";
+const char_t CXX_DETAIL_CLOSE[] = "}  // namespace machine_detail\n";
+const char_t CXX_ENCODER_BODY_HEAD_FMT[] =
+    ") {\n"
+    "  constexpr uint32_t size = %d;\n"
+    "  std::array<uint8_t, size + sizeof(uint64_t)> bytes {};\n"
+    "  uint64_t number = 0;\n"
+    "  uint32_t index = 0;\n";
+const char_t CXX_ENCODER_TAIL[] =
+    "  std::array<uint8_t, size> encoded {};\n"
+    "  for (uint32_t i = 0; i < size; i++) { encoded[i] = bytes[i]; }\n"
+    "  return encoded;\n"
+    "}\n";
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+// The body of an encoder is the one of `codegen/C`, evaluated over a local `std::array`,
+// so a call whose operands are constants is encoded at compile time. It is kept in
+// `machine_detail` over the raw operand values: the encoder of the same name takes every operand
+// as an `Entry` and checks it by the test of the selectors, so an operand of another kind or out
+// of its range is a compile error in a constant evaluation and an abort out of one.
+int32_t gen_cxx_instr_encoders(
+    GContext *context, Array *buffer, const char_t *instr_op, const InstrForm forms[],
+    uint32_t n_forms
+) {
+  char_t temp_buffer[sizeof(CXX_ENCODER_BODY_HEAD_FMT) + 64] = {};
+  Array *body_buffer = Array_new(sizeof(char_t), -1, context->allocator);
+  for (uint32_t i = 0; i < n_forms; i++) {
+    const uint32_t n_bytes = forms[i].width / 8;
+    const uint32_t n_args = forms[i].pattern->args ? Array_length(forms[i].pattern->args) : 0;
+    const Identifier *args = n_args ? Array_real_addr(forms[i].pattern->args, 0) : nullptr;
+    push_string(CXX_DETAIL_OPEN);
+    sprintf(temp_buffer, CXX_ENCODER_HEAD_FMT, n_bytes, instr_op, i);
+    push_string(temp_buffer);
+    for (uint32_t j = 0; j < n_args; j++) {
+      const Record *record = GContext_findRecord(context, &args[j]);
+      push_string(j ? ", " : "");
+      push_string((record && enum_Set == record->typeid) ? "const Entry *" : "uint64_t ");
+      push_string(args[j].ptr);
+    }
+    sprintf(temp_buffer, CXX_ENCODER_BODY_HEAD_FMT, n_bytes);
+    push_string(temp_buffer);
+    gen_fixed_args_unused(context, buffer, &forms[i]);
+    codegen_instr_form(context, body_buffer, &forms[i]);
+    Array_append(buffer, Array_real_addr(body_buffer, 0), Array_length(body_buffer));
+    push_string(CXX_ENCODER_TAIL);
+    push_string(CXX_DETAIL_CLOSE);
+    Array_reset(body_buffer, nullptr);
+
+    sprintf(temp_buffer, CXX_ENCODER_HEAD_FMT, n_bytes, instr_op, i);
+    push_string(temp_buffer);
+    for (uint32_t j = 0; j < n_args; j++) {
+      sprintf(temp_buffer, "%sconst Entry *a%d", j ? ", " : "", j);
+      push_string(temp_buffer);
+    }
+    push_string(") {\n");
+    if (n_args) {
+      push_string("  if (!(");
+      gen_form_test(context, buffer, &forms[i]);
+      push_string(")) { machine_operand_out_of_range(); }\n");
+    }
+    sprintf(temp_buffer, "  return machine_detail::encoding_%s_%d(", instr_op, i);
+    push_string(temp_buffer);
+    for (uint32_t j = 0; j < n_args; j++) {
+      // as in the selectors, an immediate of a narrower type is passed sign-extended.
+      const Record *record = GContext_findRecord(context, &args[j]);
+      const char_t *fmt = (enum_Set == record->typeid)         ? "a%d"
+                          : (enum_Immediate == record->typeid) ? "IMM_value(a%d)"
+                                                               : "a%d->value";
+      push_string(j ? ", " : "");
+      sprintf(temp_buffer, fmt, j);
+      push_string(temp_buffer);
+    }
+    push_string(");\n}\n");
+  }
+  Array_destroy(body_buffer);
+  return 0;
+}
@@ -0,0 +1,21 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: encoder.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_ENCODER_H
+#define MACHINE_ENCODER_H
+
+#include "context.h"
+#include "target.h"
+
+int32_t gen_cxx_instr_encoders(
+    GContext *context, Array *buffer, const char_t *instr_op, const InstrForm forms[],
+    uint32_t n_forms
+);
+
+#endif  // MACHINE_ENCODER_H
@@ -0,0 +1,163 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: operand.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "operand.h"
+#include "char_t.h"
+#include "define.h"
+#include "enum.h"
+#include "tokens.gen.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+const char_t CXX_REG_DEF_FMT[] =
+    "inline constexpr Entry Entry_REG_%s = {ENTRY_REGISTER, enum_REG_%s, enum_REG_%s};\n"
+    "inline constexpr const Entry *REG_%s = &Entry_REG_%s;\n";
+const char_t CXX_MEM_DEF_FMT[] =
+    "consteval Entry MEM_%s(uint64_t base, uint64_t offset) {\n"
+    "  if (!FITS_UNSIGNED(base, %d) || !FITS_UNSIGNED(offset, %d)) {\n"
+    "    machine_operand_out_of_range();\n"
+    "  }\n"
+    "  uint64_t number = 0;\n"
+    "  number = numSetBits(number, %d, %d, base);\n"
+    "  number = numSetBits(number, %d, %d, offset);\n"
+    "  return Entry {ENTRY_MEMORY, enum_MEM_%s, number};\n"
+    "}\n";
+const char_t CXX_IMM_DEF_FMT[] = "constexpr bool IMM_%s_fits(uint64_t val) {\n"
+                                 "  return FITS_%s(val, %d);\n"
+                                 "}\n"
+                                 "consteval Entry IMM_%s(uint64_t val) {\n"
+                                 "  if (!IMM_%s_fits(val)) { machine_operand_out_of_range(); }\n"
+                                 "  return Entry {ENTRY_IMMEDIATE, enum_IMM_%s, LOW_BITS(val, %d)};\n"
+                                 "}\n";
+const char_t CXX_IMM_VALUE_HEAD[] = "constexpr uint64_t IMM_value(const Entry *imm) {\n"
+                                    "  if (imm->kind != ENTRY_IMMEDIATE) { return imm->value; }\n"
+                                    "  switch (imm->type) {\n";
+const char_t CXX_IMM_VALUE_CASE_FMT[] =
+    "    case enum_IMM_%s: return (uint64_t) ((int64_t) (imm->value << %d) >> %d);\n";
+const char_t CXX_REG_COLUMN_HEAD_FMT[] = "constexpr uint64_t REG_%s(uint32_t reg) {\n"
+                                         "  switch (reg) {\n";
+const char_t CXX_SET_HEAD_FMT[] = "inline constexpr struct {\n"
+                                  "  constexpr %s operator[](uint32_t type) const {\n"
+                                  "    switch (type) {\n";
+const char_t CXX_SET_TAIL_FMT[] = "    }\n"
+                                  "    return {};\n"
+                                  "  }\n"
+                                  "} SET_%s;\n";
+const char_t CXX_CASE_FMT[] = "    case enum_%s_%s: return 0x%lX;\n";
+
+#define push_string(s) \
+  do { Array_append(buffer, s, strlen(s)); } while (false)
+
+#define fieldWidth(bf) ((bf)->upper - (bf)->lower + 1)
+
+void gen_cxx_register_def(GContext *, Array *buffer, const Register *reg) {
+  char_t temp_buffer[512] = {};
+  const char_t *name = reg->name->ptr;
+  sprintf(temp_buffer, CXX_REG_DEF_FMT, name, name, name, name, name);
+  push_string(temp_buffer);
+}
+
+// Operands are built by `consteval` constructors, so an operand out of its range is a
+// compile error instead of a wrong encoding.
+void gen_cxx_memory_def(GContext *, Array *buffer, const Memory *mem) {
+  char_t temp_buffer[512] = {};
+  sprintf(
+      temp_buffer, CXX_MEM_DEF_FMT, mem->name->ptr, fieldWidth(mem->base),
+      fieldWidth(mem->offset), mem->base->lower, mem->base->upper + 1, mem->offset->lower,
+      mem->offset->upper + 1, mem->name->ptr
+  );
+  push_string(temp_buffer);
+}
+
+void gen_cxx_immediate_def(GContext *, Array *buffer, const Immediate *imm) {
+  char_t temp_buffer[512] = {};
+  const char_t *name = imm->name->ptr;
+  const char_t *kind = (IT_SIGNED == imm->type) ? "SIGNED" : "UNSIGNED";
+  sprintf(temp_buffer, CXX_IMM_DEF_FMT, name, kind, imm->width, name, name, name, imm->width);
+  push_string(temp_buffer);
+}
+
+// `IMM_value` of `codegen/C`, with the widths of the signed immediates in a switch instead of
+// `IMMEDIATE_TABLE`.
+void gen_cxx_immediate_value(GContext *context, Array *buffer) {
+  const uint32_t n_imms = Array_length(context->immArray);
+  if (0 == n_imms) { return; }
+  char_t temp_buffer[512] = {};
+  push_string(CXX_IMM_VALUE_HEAD);
+  for (uint32_t i = 0; i < n_imms; i++) {
+    const Immediate *imm = GContext_getImmediate(context, i);
+    if (IT_SIGNED != imm->type || imm->width >= 64) { continue; }
+    const uint32_t shift = 64 - imm->width;
+    sprintf(temp_buffer, CXX_IMM_VALUE_CASE_FMT, imm->name->ptr, shift, shift);
+    push_string(temp_buffer);
+  }
+  push_string("  }\n  return imm->value;\n}\n");
+}
+
+// Designated array initializers are not C++, so every column of the register table is a
+// `constexpr` switch over the register enum instead.
+void gen_cxx_register_table(GContext *context, Array *buffer) {
+  char_t temp_buffer[512] = {};
+  const uint32_t n_groups = Array_length(context->grpArray);
+  for (uint32_t c = 0; c < REG_TABLE_COLUMNS; c++) {
+    sprintf(temp_buffer, CXX_REG_COLUMN_HEAD_FMT, REG_TABLE_COLUMN_NAMES[c]);
+    push_string(temp_buffer);
+    for (uint32_t g = 0; g < n_groups; g++) {
+      const RegisterGroup *grp = GContext_getRegisterGroup(context, g);
+      const uint32_t n_regs = Array_length(grp->registers);
+      REFER(Register) *regs = Array_real_addr(grp->registers, 0);
+      for (uint32_t i = 0; i < n_regs; i++) {
+        const Register *reg = Array_vert2real(context->regArray, regs[i]);
+        sprintf(temp_buffer, CXX_CASE_FMT, "REG", reg->name->ptr, register_column(reg, g, c));
+        push_string(temp_buffer);
+      }
+    }
+    push_string("  }\n  return 0;\n}\n");
+  }
+}
+
+// A set keeps the `SET_<name>[type]` form of the C tables, so the encoder bodies are shared.
+void gen_cxx_set_def(GContext *context, Array *buffer, const Set *set) {
+  char_t temp_buffer[512] = {};
+  const bool is_mem = enum_Memory == set->type;
+  sprintf(temp_buffer, CXX_SET_HEAD_FMT, is_mem ? "MemLayout" : "uint64_t");
+  push_string(temp_buffer);
+  const uint32_t n_items = Array_length(set->items);
+  const SetItem *items = Array_real_addr(set->items, 0);
+  for (uint32_t i = 0; i < n_items; i++) {
+    const Record *record = GContext_findRecord(context, items[i].name);
+    const char_t *name = items[i].name->ptr;
+    switch (record->typeid) {
+      case enum_Register: {
+        const Register *reg = GContext_getRegister(context, record->offset);
+        sprintf(temp_buffer, CXX_CASE_FMT, "REG", name, reg->code);
+        break;
+      }
+      case enum_Immediate: {
+        const Immediate *imm = GContext_getImmediate(context, record->offset);
+        const uint64_t mask = imm->width >= 64 ? UINT64_MAX : (1UL << imm->width) - 1;
+        sprintf(temp_buffer, CXX_CASE_FMT, "IMM", name, mask);
+        break;
+      }
+      case enum_Memory: {
+        const Memory *mem = GContext_getMemory(context, record->offset);
+        sprintf(
+            temp_buffer, "    case enum_MEM_%s: return {%d, %d, %d, %d};\n", name,
+            mem->base->lower, fieldWidth(mem->base), mem->offset->lower, fieldWidth(mem->offset)
+        );
+        break;
+      }
+    }
+    push_string(temp_buffer);
+  }
+  sprintf(temp_buffer, CXX_SET_TAIL_FMT, set->name->ptr);
+  push_string(temp_buffer);
+  gen_set_has(context, buffer, set, "constexpr bool");
+}
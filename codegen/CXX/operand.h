@@ -0,0 +1,22 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: operand.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_OPERAND_H
+#define MACHINE_OPERAND_H
+
+#include "context.h"
+
+void gen_cxx_register_def(GContext *context, Array *buffer, const Register *reg);
+void gen_cxx_memory_def(GContext *context, Array *buffer, const Memory *mem);
+void gen_cxx_immediate_def(GContext *context, Array *buffer, const Immediate *imm);
+void gen_cxx_immediate_value(GContext *context, Array *buffer);
+void gen_cxx_register_table(GContext *context, Array *buffer);
+void gen_cxx_set_def(GContext *context, Array *buffer, const Set *set);
+
+#endif  // MACHINE_OPERAND_H
@@ -0,0 +1,68 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: prelude.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "prelude.h"
+
+// The macros storing the bytes of the encoder bodies of `codegen/C`, redefined so that they are
+// usable in constant evaluation: bytes are stored one by one instead of by `memcpy`. The other
+// macros are the `FIELD_MACROS` of `codegen/C`.
+const char_t CXX_PRELUDE[] =
+    "#include <array>\n"
+    "#include <cstdint>\n"
+    "#include <cstdlib>\n"
+    "#define storeInstrBytes(word, _count)                                     \\\n"
+    "  do {                                                                    \\\n"
+    "    const uint64_t stored = (word);                                       \\\n"
+    "    for (uint32_t k = 0; k < sizeof(stored); k++) {                       \\\n"
+    "      bytes[index + k] = (uint8_t) (stored >> (8 * k));                   \\\n"
+    "    }                                                                     \\\n"
+    "    index = ((_count) + index < size) ? (_count) + index : size;          \\\n"
+    "    number = 0;                                                           \\\n"
+    "  } while (false)\n"
+    "#define pushInstrBytes(_count) storeInstrBytes(number, _count)\n"
+    "#define pushInstrBytesBE(_count) \\\n"
+    "  storeInstrBytes(__builtin_bswap64(number << (64 - 8 * (_count))), _count)\n"
+    "#define pushInstrBytesHW(_count) \\\n"
+    "  storeInstrBytes(HALFWORDS_REVERSE64(number << (64 - 8 * (_count))), _count)\n";
+
+const char_t CXX_TYPE_DEFS[] =
+    "enum { ENTRY_REGISTER = 1, ENTRY_MEMORY, ENTRY_IMMEDIATE };\n"
+    "struct Entry {\n"
+    "  uint32_t kind;\n"
+    "  uint32_t type;\n"
+    "  uint64_t value;\n"
+    "};\n"
+    "struct MemLayout {\n"
+    "  uint8_t base_lower;\n"
+    "  uint8_t base_width;\n"
+    "  uint8_t offset_lower;\n"
+    "  uint8_t offset_width;\n"
+    "};\n"
+    "\n"
+    "// not `constexpr`: a constant evaluation reaching it fails to compile.\n"
+    "[[noreturn]] inline void machine_operand_out_of_range() { std::abort(); }\n";
+
+// Every macro of the prelude is only for the definitions of the header, so none is left to
+// the files including it.
+const char_t CXX_EPILOGUE[] = "#undef UINT_N_MAX\n"
+                              "#undef LOW_BITS\n"
+                              "#undef MASK_BITS\n"
+                              "#undef FITS_UNSIGNED\n"
+                              "#undef FITS_SIGNED\n"
+                              "#undef SIGN_EXTEND\n"
+                              "#undef numSetBits\n"
+                              "#undef HALFWORDS_REVERSE64\n"
+                              "#undef setEncodingNumber\n"
+                              "#undef pushEncodingNumber\n"
+                              "#undef pushEncodingNumberBE\n"
+                              "#undef pushEncodingNumberHW\n"
+                              "#undef storeInstrBytes\n"
+                              "#undef pushInstrBytes\n"
+                              "#undef pushInstrBytesBE\n"
+                              "#undef pushInstrBytesHW\n";
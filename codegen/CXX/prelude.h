@@ -0,0 +1,19 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/CXX
+ * Filename: prelude.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_PRELUDE_H
+#define MACHINE_PRELUDE_H
+
+#include "char_t.h"
+
+extern const char_t CXX_PRELUDE[];
+extern const char_t CXX_TYPE_DEFS[];
+extern const char_t CXX_EPILOGUE[];
+
+#endif  // MACHINE_PRELUDE_H
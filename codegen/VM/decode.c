@@ -0,0 +1,397 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: decode.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "decode.h"
+#include "context.h"
+#include "enum.h"
+#include "tokens.gen.h"
+#include <stdlib.h>
+#include <string.h>
+
+// A bit of a form is a constant, or a bit of an argument: `arg * 64 + bit`.
+#define BIT_ZERO          (-1)
+#define BIT_ONE           (-2)
+#define argBit(arg, bit)  ((int32_t) ((arg) * 64 + (bit)))
+#define labelArg(label)   ((uint32_t) (label) / 64)
+#define labelBit(label)   ((uint32_t) (label) % 64)
+
+typedef struct FormOrder {
+  uint32_t n_fixed;
+  uint32_t form;
+} FormOrder;
+
+int32_t trace_form(const EncodingVM *vm, uint32_t form, int32_t bits[]);
+void trace_store(const int32_t number[64], uint32_t count, uint32_t order, int32_t bits[]);
+void add_form(
+    Disassembler *disasm, GContext *context, const InstrForm *form, const char_t *name,
+    const int32_t bits[], uint32_t size
+);
+void add_arg(Disassembler *disasm, GContext *context, const Identifier *ident);
+void add_names(Disassembler *disasm, GContext *context, const Record *record);
+void build_buckets(Disassembler *disasm);
+int compare_form_order(const void *a, const void *b);
+bool put_text(char_t *text, uint32_t capacity, uint32_t *length, const char_t *s, uint32_t n);
+bool put_hex(char_t *text, uint32_t capacity, uint32_t *length, uint64_t value);
+
+// Runs the micro-ops of a form on labels instead of values, which tells for every bit of
+// the form whether it is fixed or which argument bit it holds.
+int32_t trace_form(const EncodingVM *vm, uint32_t form, int32_t bits[]) {
+  const VMForm *vm_form = Array_real_addr(vm->forms, form);
+  if (VM_INVALID_FORM == vm_form->start || 0 == vm_form->size) { return -1; }
+  const uint64_t *pc = Array_real_addr(vm->code, vm_form->start);
+  int32_t number[64];
+  for (uint32_t k = 0; k < 64; k++) { number[k] = BIT_ZERO; }
+  uint32_t index = 0;
+  for (uint64_t op = *pc++; VM_END != opCode(op); op = *pc++) {
+    switch (opCode(op)) {
+      case VM_CONST: {
+        const uint64_t value = *pc++;
+        for (uint32_t k = 0; k < opHi(op) - opLo(op); k++) {
+          number[opLo(op) + k] = ((value >> k) & 1) ? BIT_ONE : BIT_ZERO;
+        }
+        break;
+      }
+      case VM_ARG:
+      case VM_REG:
+      case VM_IMM_SET: {
+        // the bits a set of immediates masks off by type are read back as they are.
+        for (uint32_t k = 0; k < opHi(op) - opLo(op); k++) {
+          const uint32_t bit = opShift(op) + k;
+          const bool in_field = k < opWidth(op) && bit < 64;
+          number[opLo(op) + k] = in_field ? argBit(opArg(op), bit) : BIT_ZERO;
+        }
+        break;
+      }
+      case VM_STORE: {
+        trace_store(number, opLo(op), opArg(op), &bits[index * 8]);
+        index += opLo(op);
+        for (uint32_t k = 0; k < 64; k++) { number[k] = BIT_ZERO; }
+        break;
+      }
+      // the field of a set of memories depends on its type, which the bytes do not tell.
+      default: return -1;
+    }
+  }
+  return 0;
+}
+
+// Follows `op_store`: the bits of the low `count` bytes, in their order in memory.
+void trace_store(const int32_t number[64], uint32_t count, uint32_t order, int32_t bits[]) {
+  const uint32_t shift = 64 - 8 * count;
+  for (uint32_t j = 0; j < count; j++) {
+    uint32_t byte = j;
+    if (ORDER_BIG == order) { byte = 7 - j; }
+    if (ORDER_HALFWORD == order) { byte = (3 - j / 2) * 2 + j % 2; }
+    if (ORDER_BIG == order || ORDER_HALFWORD == order) { byte -= shift / 8; }
+    for (uint32_t t = 0; t < 8; t++) {
+      bits[j * 8 + t] = (byte < 8) ? number[byte * 8 + t] : BIT_ZERO;
+    }
+  }
+}
+
+void add_names(Disassembler *disasm, GContext *context, const Record *record) {
+  switch (record->typeid) {
+    case enum_Register: {
+      const Register *reg = GContext_getRegister(context, record->offset);
+      const DecodeName name = {.code = reg->code, .name = reg->name->ptr};
+      Array_append(disasm->names, &name, 1);
+      return;
+    }
+    case enum_RegisterGroup: {
+      const RegisterGroup *grp = GContext_getRegisterGroup(context, record->offset);
+      const uint32_t n_regs = Array_length(grp->registers);
+      REFER(Register) *regs = Array_real_addr(grp->registers, 0);
+      for (uint32_t i = 0; i < n_regs; i++) {
+        const Register *reg = Array_vert2real(context->regArray, regs[i]);
+        const DecodeName name = {.code = reg->code, .name = reg->name->ptr};
+        Array_append(disasm->names, &name, 1);
+      }
+      return;
+    }
+    case enum_Set: {
+      const Set *set = GContext_getSet(context, record->offset);
+      const uint32_t n_items = Array_length(set->items);
+      const SetItem *items = Array_real_addr(set->items, 0);
+      for (uint32_t i = 0; i < n_items; i++) {
+        add_names(disasm, context, GContext_findRecord(context, items[i].name));
+      }
+      return;
+    }
+  }
+}
+
+void add_arg(Disassembler *disasm, GContext *context, const Identifier *ident) {
+  const Record *record = GContext_findRecord(context, ident);
+  DecodeArg arg = {.typeid = record->typeid, .start = Array_length(disasm->names)};
+  if (enum_Set == record->typeid) { arg.typeid = GContext_getSet(context, record->offset)->type; }
+  if (enum_Register == record->typeid) {
+    arg.name = GContext_getRegister(context, record->offset)->name->ptr;
+  } else if (enum_Immediate == record->typeid) {
+    const Immediate *imm = GContext_getImmediate(context, record->offset);
+    if (IT_SIGNED == imm->type && imm->width) { arg.sign = 1LLU << (imm->width - 1); }
+  } else if (enum_RegisterGroup == arg.typeid || enum_Register == arg.typeid) {
+    add_names(disasm, context, record);
+    arg.typeid = enum_RegisterGroup;
+  }
+  arg.count = Array_length(disasm->names) - arg.start;
+  Array_append(disasm->args, &arg, 1);
+}
+
+// The fixed bits become a mask and a value per byte; the argument bits become runs, each
+// the longest stretch of a byte which holds consecutive bits of one argument.
+void add_form(
+    Disassembler *disasm, GContext *context, const InstrForm *form, const char_t *name,
+    const int32_t bits[], uint32_t size
+) {
+  DecodeForm decode_form = {
+      .name = name,
+      .size = size,
+      .pattern = Array_length(disasm->masks),
+      .start_run = Array_length(disasm->runs),
+      .start_arg = Array_length(disasm->args),
+      .n_args = form->pattern->args ? Array_length(form->pattern->args) : 0,
+  };
+  for (uint32_t k = 0; k < size; k++) {
+    uint8_t mask = 0, value = 0;
+    for (uint32_t t = 0; t < 8; t++) {
+      const int32_t label = bits[k * 8 + t];
+      if (label >= 0) {
+        DecodeRun run = {
+            .byte = k, .bit = t, .length = 1, .arg = labelArg(label), .arg_bit = labelBit(label)
+        };
+        while (t + 1 < 8 && labelBit(label) + run.length < 64 &&
+               bits[k * 8 + t + 1] == label + run.length) {
+          run.length++;
+          t++;
+        }
+        Array_append(disasm->runs, &run, 1);
+        continue;
+      }
+      mask |= 1U << t;
+      if (BIT_ONE == label) { value |= 1U << t; }
+      decode_form.n_fixed++;
+    }
+    Array_append(disasm->masks, &mask, 1);
+    Array_append(disasm->values, &value, 1);
+  }
+  decode_form.n_runs = Array_length(disasm->runs) - decode_form.start_run;
+  const Identifier *args = decode_form.n_args ? Array_real_addr(form->pattern->args, 0) : nullptr;
+  for (uint32_t j = 0; j < decode_form.n_args; j++) { add_arg(disasm, context, &args[j]); }
+  Array_append(disasm->forms, &decode_form, 1);
+}
+
+int compare_form_order(const void *a, const void *b) {
+  const FormOrder *lhs = a, *rhs = b;
+  if (lhs->n_fixed != rhs->n_fixed) { return lhs->n_fixed < rhs->n_fixed ? 1 : -1; }
+  return lhs->form < rhs->form ? -1 : (lhs->form > rhs->form);
+}
+
+// A form goes to the bucket of every first byte its mask and value accept, and a bucket
+// tries its forms from the most fixed bits, so a form which fixes fewer bits is the fallback.
+void build_buckets(Disassembler *disasm) {
+  const Allocator *allocator = disasm->allocator;
+  const uint32_t n_forms = Array_length(disasm->forms);
+  const DecodeForm *forms = Array_real_addr(disasm->forms, 0);
+  const uint8_t *masks = Array_real_addr(disasm->masks, 0);
+  const uint8_t *values = Array_real_addr(disasm->values, 0);
+  FormOrder *order = allocator->calloc(n_forms + 1, sizeof(FormOrder));
+  uint32_t n_order = 0;
+  for (uint32_t i = 0; i < n_forms; i++) {
+    if (forms[i].size) { order[n_order++] = (FormOrder) {forms[i].n_fixed, i}; }
+  }
+  qsort(order, n_order, sizeof(FormOrder), compare_form_order);
+
+  uint32_t counts[256] = {};
+  for (uint32_t i = 0; i < n_order; i++) {
+    const DecodeForm *form = &forms[order[i].form];
+    for (uint32_t byte = 0; byte < 256; byte++) {
+      if ((byte & masks[form->pattern]) == values[form->pattern]) { counts[byte]++; }
+    }
+  }
+  for (uint32_t byte = 0; byte < 256; byte++) {
+    disasm->bucketStart[byte + 1] = disasm->bucketStart[byte] + counts[byte];
+    counts[byte] = disasm->bucketStart[byte];
+  }
+  disasm->bucketForms = allocator->calloc(disasm->bucketStart[256] + 1, sizeof(uint32_t));
+  for (uint32_t i = 0; i < n_order; i++) {
+    const DecodeForm *form = &forms[order[i].form];
+    for (uint32_t byte = 0; byte < 256; byte++) {
+      if ((byte & masks[form->pattern]) == values[form->pattern]) {
+        disasm->bucketForms[counts[byte]++] = order[i].form;
+      }
+    }
+  }
+  allocator->free(order);
+}
+
+// The forms are read back from the programs of `vm`, so their ids are the ids of the VM.
+// Names point into `machine`, which has to outlive the disassembler.
+Disassembler *Disassembler_new(const Machine *machine, const EncodingVM *vm) {
+  const Allocator *allocator = vm->allocator;
+  GContext *context = machine->context;
+  Disassembler *disasm = allocator->calloc(1, sizeof(Disassembler));
+  disasm->allocator = allocator;
+  disasm->forms = Array_new(sizeof(DecodeForm), -1, allocator);
+  disasm->masks = Array_new(sizeof(uint8_t), -1, allocator);
+  disasm->values = Array_new(sizeof(uint8_t), -1, allocator);
+  disasm->runs = Array_new(sizeof(DecodeRun), -1, allocator);
+  disasm->args = Array_new(sizeof(DecodeArg), -1, allocator);
+  disasm->names = Array_new(sizeof(DecodeName), -1, allocator);
+  int32_t *bits = allocator->calloc(MAX_VM_FORM_BYTES * 8, sizeof(int32_t));
+
+  uint32_t id = 0;
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t e = 0; e < n_entries; e++) {
+    const Entry *entry = Array_real_addr(machine->entries, e);
+    if (enum_Instruction != entry->type) { continue; }
+    const Instruction *instr = entry->target;
+    const uint32_t n_forms = Array_length(instr->forms);
+    const InstrForm *forms = Array_real_addr(instr->forms, 0);
+    for (uint32_t i = 0; i < n_forms; i++, id++) {
+      const uint32_t n_args = forms[i].pattern->args ? Array_length(forms[i].pattern->args) : 0;
+      const VMForm *vm_form = Array_real_addr(vm->forms, id);
+      if (n_args <= MAX_DECODE_ARGS && trace_form(vm, id, bits) == 0) {
+        add_form(disasm, context, &forms[i], instr->name->ptr, bits, vm_form->size);
+      } else {
+        const DecodeForm decode_form = {.name = instr->name->ptr};
+        Array_append(disasm->forms, &decode_form, 1);
+      }
+    }
+  }
+  allocator->free(bits);
+  build_buckets(disasm);
+  return disasm;
+}
+
+// Decodes `code[*consumed ..]` until the code ends or the ring is full, and returns the
+// count of appended records. A byte which starts no form becomes a record of `DECODE_UNKNOWN`
+// with the byte in its first argument, so the stream never stops on garbage.
+uint32_t Disassembler_decode(
+    const Disassembler *disasm, const uint8_t *code, size_t size, uint64_t base,
+    size_t *consumed, DecodeRing *ring
+) {
+  const DecodeForm *forms = Array_real_addr(disasm->forms, 0);
+  const uint8_t *masks = Array_real_addr(disasm->masks, 0);
+  const uint8_t *values = Array_real_addr(disasm->values, 0);
+  const DecodeRun *runs = Array_real_addr(disasm->runs, 0);
+  size_t pos = *consumed;
+  uint32_t n_records = 0;
+  while (pos < size && ring->count < ring->capacity) {
+    const uint8_t *bytes = &code[pos];
+    const size_t remain = size - pos;
+    const uint32_t *candidate = &disasm->bucketForms[disasm->bucketStart[bytes[0]]];
+    const uint32_t *end = &disasm->bucketForms[disasm->bucketStart[bytes[0] + 1]];
+    const DecodeForm *form = nullptr;
+    for (; candidate < end && !form; candidate++) {
+      const DecodeForm *f = &forms[*candidate];
+      if (f->size > remain) { continue; }
+      uint32_t k = 1;
+      while (k < f->size && (bytes[k] & masks[f->pattern + k]) == values[f->pattern + k]) { k++; }
+      if (k == f->size) { form = f; }
+    }
+
+    DecodedRecord *record = &ring->records[(ring->head + ring->count) % ring->capacity];
+    record->offset = base + pos;
+    if (!form) {
+      record->form = DECODE_UNKNOWN;
+      record->length = 1;
+      record->args[0] = bytes[0];
+    } else {
+      record->form = candidate[-1];
+      record->length = form->size;
+      for (uint32_t j = 0; j < form->n_args; j++) { record->args[j] = 0; }
+      for (uint32_t r = form->start_run; r < form->start_run + form->n_runs; r++) {
+        const uint64_t field = (bytes[runs[r].byte] >> runs[r].bit) & ((1U << runs[r].length) - 1);
+        record->args[runs[r].arg] |= field << runs[r].arg_bit;
+      }
+    }
+    pos += record->length;
+    ring->count++;
+    n_records++;
+  }
+  *consumed = pos;
+  return n_records;
+}
+
+bool put_text(char_t *text, uint32_t capacity, uint32_t *length, const char_t *s, uint32_t n) {
+  if (*length + n >= capacity) { return false; }
+  memcpy(&text[*length], s, n * sizeof(char_t));
+  *length += n;
+  return true;
+}
+
+bool put_hex(char_t *text, uint32_t capacity, uint32_t *length, uint64_t value) {
+  static const char_t DIGITS[] = "0123456789abcdef";
+  char_t digits[2 + 16];
+  uint32_t n = sizeof(digits) / sizeof(char_t);
+  do {
+    digits[--n] = DIGITS[value & 0xF];
+    value >>= 4;
+  } while (value);
+  digits[--n] = 'x';
+  digits[--n] = '0';
+  return put_text(text, capacity, length, &digits[n], sizeof(digits) / sizeof(char_t) - n);
+}
+
+// Writes a record as `name arg, arg` into `text`, ended by a '\0', without allocating.
+// Returns the length of the text, or 0 if it does not fit in `capacity`.
+uint32_t Disassembler_format(
+    const Disassembler *disasm, const DecodedRecord *record, char_t *text, uint32_t capacity
+) {
+  uint32_t length = 0;
+  if (DECODE_UNKNOWN == record->form) {
+    if (!put_text(text, capacity, &length, ".byte ", 6) ||
+        !put_hex(text, capacity, &length, record->args[0])) {
+      return 0;
+    }
+    text[length] = '\0';
+    return length;
+  }
+  const DecodeForm *form = Array_real_addr(disasm->forms, record->form);
+  const DecodeArg *args = Array_real_addr(disasm->args, form->start_arg);
+  const DecodeName *names = Array_real_addr(disasm->names, 0);
+  if (!put_text(text, capacity, &length, form->name, strlen(form->name))) { return 0; }
+  for (uint32_t j = 0; j < form->n_args; j++) {
+    if (!put_text(text, capacity, &length, j ? ", " : " ", j ? 2 : 1)) { return 0; }
+    const char_t *name = args[j].name;
+    for (uint32_t i = args[j].start; !name && i < args[j].start + args[j].count; i++) {
+      if (names[i].code == record->args[j]) { name = names[i].name; }
+    }
+    bool fits = true;
+    if (name) {
+      fits = put_text(text, capacity, &length, name, strlen(name));
+    } else if (enum_Memory == args[j].typeid) {
+      fits = put_text(text, capacity, &length, "[", 1) &&
+             put_hex(text, capacity, &length, record->args[j]) &&
+             put_text(text, capacity, &length, "]", 1);
+    } else if (record->args[j] & args[j].sign) {
+      // sign-extended from the width of the immediate: -(2 * sign - value).
+      const uint64_t magnitude = args[j].sign - (record->args[j] & (args[j].sign - 1));
+      fits = put_text(text, capacity, &length, "-", 1) &&
+             put_hex(text, capacity, &length, magnitude);
+    } else {
+      fits = put_hex(text, capacity, &length, record->args[j]);
+    }
+    if (!fits) { return 0; }
+  }
+  text[length] = '\0';
+  return length;
+}
+
+void Disassembler_destroy(Disassembler *disasm) {
+  const Allocator *allocator = disasm->allocator;
+  allocator->free(disasm->bucketForms);
+  Array_destroy(disasm->names);
+  Array_destroy(disasm->args);
+  Array_destroy(disasm->runs);
+  Array_destroy(disasm->values);
+  Array_destroy(disasm->masks);
+  Array_destroy(disasm->forms);
+  allocator->free(disasm);
+}
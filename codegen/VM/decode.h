@@ -0,0 +1,99 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: decode.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_DECODE_H
+#define MACHINE_DECODE_H
+
+#include "char_t.h"
+#include "vm.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#define MAX_DECODE_ARGS 8
+#define DECODE_UNKNOWN  UINT32_MAX
+
+// A decoded instruction: the form id, its offset in the decoded stream, its length, and the
+// raw value of every argument (the code of a register).
+typedef struct DecodedRecord {
+  uint64_t offset;
+  uint32_t form;  // `DECODE_UNKNOWN` for a byte no form matches
+  uint32_t length;
+  uint64_t args[MAX_DECODE_ARGS];
+} DecodedRecord;
+
+// Records are appended at `head + count` and consumed by the caller from `head`.
+typedef struct DecodeRing {
+  DecodedRecord *records;
+  uint32_t capacity;
+  uint32_t head;
+  uint32_t count;
+} DecodeRing;
+
+typedef struct DecodeRun {
+  uint16_t byte;
+  uint8_t bit;
+  uint8_t length;
+  uint8_t arg;
+  uint8_t arg_bit;
+} DecodeRun;
+
+typedef struct DecodeName {
+  uint64_t code;
+  const char_t *name;
+} DecodeName;
+
+// How the formatter prints an argument: a fixed register by its name, a register of a group
+// or a set by the first of its candidate names with the decoded code, and others in hex.
+typedef struct DecodeArg {
+  uint32_t typeid;
+  const char_t *name;  // the name of a fixed register
+  uint32_t start;      // the candidate names of a group or a set of registers
+  uint32_t count;
+  uint64_t sign;  // the sign bit of a signed immediate, 0 otherwise
+} DecodeArg;
+
+typedef struct DecodeForm {
+  const char_t *name;
+  uint32_t size;  // 0 if the form can not be decoded
+  uint32_t pattern;  // offset of the mask and value bytes
+  uint32_t start_run;
+  uint32_t n_runs;
+  uint32_t start_arg;
+  uint32_t n_args;
+  uint32_t n_fixed;  // count of bits the form fixes, forms with more are tried first
+} DecodeForm;
+
+typedef struct Disassembler {
+  const Allocator *allocator;
+  Array /*<DecodeForm>*/ *forms;
+  Array /*<uint8_t>*/ *masks;
+  Array /*<uint8_t>*/ *values;
+  Array /*<DecodeRun>*/ *runs;
+  Array /*<DecodeArg>*/ *args;
+  Array /*<DecodeName>*/ *names;
+  // the forms a first byte can start, most fixed bits first, are
+  // `bucketForms[bucketStart[byte] .. bucketStart[byte + 1]]`.
+  uint32_t bucketStart[256 + 1];
+  uint32_t *bucketForms;
+} Disassembler;
+
+Disassembler *Disassembler_new(const Machine *machine, const EncodingVM *vm);
+
+uint32_t Disassembler_decode(
+    const Disassembler *disasm, const uint8_t *code, size_t size, uint64_t base,
+    size_t *consumed, DecodeRing *ring
+);
+
+uint32_t Disassembler_format(
+    const Disassembler *disasm, const DecodedRecord *record, char_t *text, uint32_t capacity
+);
+
+void Disassembler_destroy(Disassembler *disasm);
+
+#endif  // MACHINE_DECODE_H
@@ -0,0 +1,102 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: execute.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "enum.h"
+#include "vm.h"
+#include <string.h>
+
+#define UINT_N_MAX(n_bits)    ((n_bits) >= 64 ? ~0LLU : (1LLU << (n_bits)) - 1)
+#define LOW_BITS(val, n_bits) ((val) & UINT_N_MAX(n_bits))
+#define MASK_BITS(bl, bu)     (UINT_N_MAX(bu) - UINT_N_MAX(bl))
+#define numSetBits(num, bl, bu, val) \
+  (((num) & ~MASK_BITS(bl, bu)) | (LOW_BITS(val, (bu) - (bl)) << (bl)))
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define TO_LE64(val) __builtin_bswap64(val)
+#else
+#define TO_LE64(val) (val)
+#endif
+#define HALFWORDS_REVERSE64(val)                             \
+  ((((val) >> 48) & 0xFFFF) | (((val) >> 16) & 0xFFFF0000) | \
+   (((val) & 0xFFFF0000) << 16) | ((val) << 48))
+
+#define dispatch()                    \
+  do {                                \
+    op = *pc++;                       \
+    goto *DISPATCH_TABLE[opCode(op)]; \
+  } while (false)
+
+// Runs the micro-ops of a form with a threaded dispatch: every op jumps straight to the
+// next one, so there is no loop or switch between them.
+uint32_t EncodingVM_encode(
+    const EncodingVM *vm, uint32_t form, const Operand args[], Array *buffer
+) {
+  static void *const DISPATCH_TABLE[] = {
+      [VM_END] = &&op_end,
+      [VM_CONST] = &&op_const,
+      [VM_ARG] = &&op_arg,
+      [VM_REG] = &&op_reg,
+      [VM_IMM_SET] = &&op_imm_set,
+      [VM_MEM_BASE] = &&op_mem_base,
+      [VM_MEM_OFFSET] = &&op_mem_offset,
+      [VM_STORE] = &&op_store,
+  };
+  if (form >= Array_length(vm->forms)) { return 0; }
+  const VMForm *vm_form = Array_real_addr(vm->forms, form);
+  if (VM_INVALID_FORM == vm_form->start) { return 0; }
+  const uint64_t *pc = Array_real_addr(vm->code, vm_form->start);
+  const uint32_t size = vm_form->size;
+  uint8_t bytes[MAX_VM_FORM_BYTES + sizeof(uint64_t)];
+  uint64_t number = 0, value = 0, op = 0;
+  uint32_t index = 0;
+  dispatch();
+
+op_const:
+  value = *pc++;
+  goto op_insert;
+op_arg:
+  value = args[opArg(op)].value;
+  goto op_insert;
+op_reg:
+  value = vm->regCodes[args[opArg(op)].type];
+  goto op_insert;
+op_imm_set: {
+  const VMImmediate imm = vm->immediates[args[opArg(op)].type];
+  value = ((args[opArg(op)].value & imm.mask) ^ imm.sign) - imm.sign;
+  goto op_insert;
+}
+op_mem_base: {
+  const VMMemLayout layout = vm->memLayouts[args[opArg(op)].type];
+  value = LOW_BITS(args[opArg(op)].value >> layout.base_lower, layout.base_width);
+  goto op_insert;
+}
+op_mem_offset: {
+  const VMMemLayout layout = vm->memLayouts[args[opArg(op)].type];
+  value = LOW_BITS(args[opArg(op)].value >> layout.offset_lower, layout.offset_width);
+  goto op_insert;
+}
+op_insert:
+  value = LOW_BITS(value >> opShift(op), opWidth(op));
+  number = numSetBits(number, opLo(op), opHi(op), value);
+  dispatch();
+op_store: {
+  const uint32_t count = opLo(op);
+  uint64_t word = number;
+  if (ORDER_BIG == opArg(op)) { word = __builtin_bswap64(number << (64 - 8 * count)); }
+  if (ORDER_HALFWORD == opArg(op)) { word = HALFWORDS_REVERSE64(number << (64 - 8 * count)); }
+  word = TO_LE64(word);
+  memcpy(&bytes[index], &word, sizeof(word));
+  index += count;
+  number = 0;
+  dispatch();
+}
+op_end:
+  Array_append(buffer, bytes, size);
+  return size;
+}
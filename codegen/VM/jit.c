@@ -0,0 +1,262 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: jit.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+// for `MAP_ANONYMOUS` of <sys/mman.h>.
+#define _DEFAULT_SOURCE
+
+#include "jit.h"
+#include "enum.h"
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__unix__)
+#define MACHINE_JIT_X86_64
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define UINT_N_MAX(n_bits) ((n_bits) >= 64 ? ~0LLU : (1LLU << (n_bits)) - 1)
+#define MASK_BITS(bl, bu)  (UINT_N_MAX(bu) - UINT_N_MAX(bl))
+#define min(a, b)          (((a) < (b)) ? (a) : (b))
+
+#ifdef MACHINE_JIT_X86_64
+
+// The code of a form is a function of (rdi: args, rsi: bytes), which keeps the number in rax
+// and uses rcx and rdx as scratch registers.
+#define emit(...)                               \
+  do {                                          \
+    const uint8_t _bytes[] = {__VA_ARGS__};     \
+    Array_append(code, _bytes, sizeof(_bytes)); \
+  } while (false)
+#define emit32(val)                          \
+  do {                                       \
+    const uint32_t _val = (val);             \
+    Array_append(code, &_val, sizeof(_val)); \
+  } while (false)
+#define emit64(val)                          \
+  do {                                       \
+    const uint64_t _val = (val);             \
+    Array_append(code, &_val, sizeof(_val)); \
+  } while (false)
+
+#define argType(arg)  ((uint32_t) ((arg) * sizeof(Operand) + offsetof(Operand, type)))
+#define argValue(arg) ((uint32_t) ((arg) * sizeof(Operand) + offsetof(Operand, value)))
+
+// `VM_IMM_SET` finds the `VMImmediate` of a type by shifting the type by 4.
+_Static_assert(sizeof(VMImmediate) == 16, "a VMImmediate is 16 bytes");
+
+void jit_insert(Array *code, uint64_t op, uint64_t *dirty);
+void jit_store(Array *code, uint64_t op, uint32_t index);
+int32_t jit_form(Array *code, const EncodingVM *vm, const VMForm *form);
+
+// Inserts rcx into the bits [lo, hi) of rax: the value is shifted and masked the way
+// `op_insert` of the VM does, and the bits are only cleared if an insert touched them.
+void jit_insert(Array *code, uint64_t op, uint64_t *dirty) {
+  const uint32_t lo = opLo(op), hi = opHi(op);
+  const uint32_t width = min(opWidth(op), hi - lo);
+  const uint64_t mask = MASK_BITS(lo, hi);
+  if (opShift(op)) { emit(0x48, 0xC1, 0xE9, opShift(op)); }  // shr rcx, shift
+  if (width < 64) {
+    emit(0x48, 0xBA);  // mov rdx, imm64
+    emit64(UINT_N_MAX(width));
+    emit(0x48, 0x21, 0xD1);  // and rcx, rdx
+  }
+  if (lo) { emit(0x48, 0xC1, 0xE1, lo); }  // shl rcx, lo
+  if (*dirty & mask) {
+    emit(0x48, 0xBA);  // mov rdx, imm64
+    emit64(~mask);
+    emit(0x48, 0x21, 0xD0);  // and rax, rdx
+  }
+  emit(0x48, 0x09, 0xC8);  // or rax, rcx
+  *dirty |= mask;
+}
+
+void jit_store(Array *code, uint64_t op, uint32_t index) {
+  const uint32_t count = opLo(op);
+  if (ORDER_BIG == opArg(op) || ORDER_HALFWORD == opArg(op)) {
+    if (count < 8) { emit(0x48, 0xC1, 0xE0, 64 - 8 * count); }  // shl rax, 64 - 8 * count
+  }
+  if (ORDER_BIG == opArg(op)) { emit(0x48, 0x0F, 0xC8); }  // bswap rax
+  if (ORDER_HALFWORD == opArg(op)) {
+    emit(0x48, 0xC1, 0xC0, 32);    // rol rax, 32
+    emit(0x48, 0x89, 0xC1);        // mov rcx, rax
+    emit(0x48, 0xC1, 0xE9, 16);    // shr rcx, 16
+    emit(0x48, 0xBA);              // mov rdx, imm64
+    emit64(0x0000FFFF0000FFFFLLU);
+    emit(0x48, 0x21, 0xD1);        // and rcx, rdx
+    emit(0x48, 0x21, 0xD0);        // and rax, rdx
+    emit(0x48, 0xC1, 0xE0, 16);    // shl rax, 16
+    emit(0x48, 0x09, 0xC8);        // or rax, rcx
+  }
+  emit(0x48, 0x89, 0x86);  // mov [rsi + index], rax
+  emit32(index);
+  emit(0x31, 0xC0);  // xor eax, eax
+}
+
+// Returns -1 for a form with an op which is left to the VM.
+int32_t jit_form(Array *code, const EncodingVM *vm, const VMForm *form) {
+  const uint64_t *pc = Array_real_addr(vm->code, form->start);
+  uint64_t dirty = 0;
+  uint32_t index = 0;
+  emit(0x31, 0xC0);  // xor eax, eax
+  while (true) {
+    const uint64_t op = *pc++;
+    switch (opCode(op)) {
+      case VM_END: {
+        emit(0xB8);  // mov eax, size
+        emit32(form->size);
+        emit(0xC3);  // ret
+        return 0;
+      }
+      case VM_CONST: {
+        // a constant is shifted and masked here, so it is only or-ed in.
+        const uint64_t mask = MASK_BITS(opLo(op), opHi(op));
+        const uint64_t bits = (*pc++ << opLo(op)) & mask;
+        if (dirty & mask) {
+          emit(0x48, 0xBA);  // mov rdx, imm64
+          emit64(~mask);
+          emit(0x48, 0x21, 0xD0);  // and rax, rdx
+        }
+        if (bits) {
+          emit(0x48, 0xB9);  // mov rcx, imm64
+          emit64(bits);
+          emit(0x48, 0x09, 0xC8);  // or rax, rcx
+        }
+        dirty |= mask;
+        break;
+      }
+      case VM_ARG: {
+        emit(0x48, 0x8B, 0x8F);  // mov rcx, [rdi + value]
+        emit32(argValue(opArg(op)));
+        jit_insert(code, op, &dirty);
+        break;
+      }
+      case VM_REG: {
+        emit(0x8B, 0x8F);  // mov ecx, [rdi + type]
+        emit32(argType(opArg(op)));
+        emit(0x48, 0xBA);  // mov rdx, table
+        emit64((uint64_t) vm->regCodes);
+        emit(0x48, 0x8B, 0x0C, 0xCA);  // mov rcx, [rdx + rcx * 8]
+        jit_insert(code, op, &dirty);
+        break;
+      }
+      case VM_IMM_SET: {
+        emit(0x8B, 0x8F);  // mov ecx, [rdi + type]
+        emit32(argType(opArg(op)));
+        emit(0xC1, 0xE1, 4);  // shl ecx, 4
+        emit(0x48, 0xBA);     // mov rdx, table
+        emit64((uint64_t) vm->immediates);
+        emit(0x48, 0x01, 0xCA);  // add rdx, rcx
+        emit(0x48, 0x8B, 0x8F);  // mov rcx, [rdi + value]
+        emit32(argValue(opArg(op)));
+        emit(0x48, 0x23, 0x0A);        // and rcx, [rdx]
+        emit(0x48, 0x33, 0x4A, 0x08);  // xor rcx, [rdx + 8]
+        emit(0x48, 0x2B, 0x4A, 0x08);  // sub rcx, [rdx + 8]
+        jit_insert(code, op, &dirty);
+        break;
+      }
+      case VM_STORE: {
+        jit_store(code, op, index);
+        index += opLo(op);
+        dirty = 0;
+        break;
+      }
+      default: return -1;
+    }
+  }
+}
+
+// Compiles every form into one buffer first, then maps it writable, copies it in and turns
+// the page executable, so it is never writable and executable at once.
+EncodingJIT *EncodingJIT_new(const EncodingVM *vm) {
+  const Allocator *allocator = vm->allocator;
+  const uint32_t n_forms = Array_length(vm->forms);
+  Array *code = Array_new(sizeof(uint8_t), -1, allocator);
+  // a form is compiled on its own, so the code of a form which falls back to the VM is
+  // dropped by resetting `form_code` rather than cutting it out of `code`.
+  Array *form_code = Array_new(sizeof(uint8_t), -1, allocator);
+  uint32_t *offsets = allocator->calloc(n_forms + 1, sizeof(uint32_t));
+  for (uint32_t i = 0; i < n_forms; i++) {
+    const VMForm *form = Array_real_addr(vm->forms, i);
+    offsets[i] = UINT32_MAX;
+    if (VM_INVALID_FORM == form->start) { continue; }
+    if (jit_form(form_code, vm, form) == 0) {
+      offsets[i] = Array_length(code);
+      Array_append(code, Array_real_addr(form_code, 0), Array_length(form_code));
+    }
+    Array_reset(form_code, nullptr);
+  }
+  Array_destroy(form_code);
+
+  const size_t length = Array_length(code);
+  const size_t page = sysconf(_SC_PAGESIZE);
+  EncodingJIT *jit = allocator->calloc(1, sizeof(EncodingJIT));
+  jit->vm = vm;
+  jit->n_forms = n_forms;
+  jit->entries = allocator->calloc(n_forms + 1, sizeof(fn_jit_encode *));
+  jit->page_size = (length + page - 1) / page * page;
+  if (jit->page_size) {
+    const int prot = PROT_READ | PROT_WRITE;
+    void *mapped = mmap(nullptr, jit->page_size, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED != mapped) {
+      memcpy(mapped, Array_real_addr(code, 0), length);
+      if (0 == mprotect(mapped, jit->page_size, PROT_READ | PROT_EXEC)) {
+        jit->page = mapped;
+      } else {
+        munmap(mapped, jit->page_size);
+      }
+    }
+  }
+  for (uint32_t i = 0; jit->page && i < n_forms; i++) {
+    if (UINT32_MAX == offsets[i]) { continue; }
+    jit->entries[i] = (fn_jit_encode *) (jit->page + offsets[i]);
+  }
+  allocator->free(offsets);
+  Array_destroy(code);
+  return jit;
+}
+
+uint32_t EncodingJIT_encode(
+    const EncodingJIT *jit, uint32_t form, const Operand args[], Array *buffer
+) {
+  if (form >= jit->n_forms) { return 0; }
+  fn_jit_encode *entry = jit->entries[form];
+  if (!entry) { return EncodingVM_encode(jit->vm, form, args, buffer); }
+  uint8_t bytes[MAX_VM_FORM_BYTES + sizeof(uint64_t)];
+  const uint32_t size = entry(args, bytes);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+
+void EncodingJIT_destroy(EncodingJIT *jit) {
+  const Allocator *allocator = jit->vm->allocator;
+  if (jit->page) { munmap(jit->page, jit->page_size); }
+  allocator->free(jit->entries);
+  allocator->free(jit);
+}
+
+#else
+
+// Without the x86-64 backend every form runs on the VM.
+EncodingJIT *EncodingJIT_new(const EncodingVM *vm) {
+  EncodingJIT *jit = vm->allocator->calloc(1, sizeof(EncodingJIT));
+  jit->vm = vm;
+  return jit;
+}
+
+uint32_t EncodingJIT_encode(
+    const EncodingJIT *jit, uint32_t form, const Operand args[], Array *buffer
+) {
+  return EncodingVM_encode(jit->vm, form, args, buffer);
+}
+
+void EncodingJIT_destroy(EncodingJIT *jit) {
+  jit->vm->allocator->free(jit);
+}
+
+#endif  // MACHINE_JIT_X86_64
@@ -0,0 +1,36 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: jit.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_JIT_H
+#define MACHINE_JIT_H
+
+#include "vm.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// `bytes` has room for `sizeof(uint64_t)` bytes past the form, as stores are 8 bytes wide.
+typedef uint32_t fn_jit_encode(const Operand args[], uint8_t *bytes);
+
+typedef struct EncodingJIT {
+  const EncodingVM *vm;
+  uint8_t *page;
+  size_t page_size;
+  fn_jit_encode **entries;  // nullptr for a form which runs on the VM
+  uint32_t n_forms;
+} EncodingJIT;
+
+EncodingJIT *EncodingJIT_new(const EncodingVM *vm);
+
+uint32_t EncodingJIT_encode(
+    const EncodingJIT *jit, uint32_t form, const Operand args[], Array *buffer
+);
+
+void EncodingJIT_destroy(EncodingJIT *jit);
+
+#endif  // MACHINE_JIT_H
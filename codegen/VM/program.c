@@ -0,0 +1,281 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: program.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "avl-tree.h"
+#include "context.h"
+#include "enum.h"
+#include "number.h"
+#include "tokens.gen.h"
+#include "vm.h"
+#include <string.h>
+
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+
+#define getMappingItem(_items, bf)                                                 \
+  Array_real_addr(                                                                 \
+      (_items)->itemArray,                                                         \
+      ((uint32_t) (uint64_t) AVLTree_get((_items)->itemTree, (uint64_t) (bf)) - 1) \
+  )
+
+#define pushOp(op)                        \
+  do {                                    \
+    const uint64_t _op = (op);            \
+    Array_append(program->code, &_op, 1); \
+  } while (false)
+
+typedef struct Program {
+  GContext *context;
+  Array *code;
+  const Identifier *args;
+  uint32_t n_args;
+  uint32_t n_stored;
+} Program;
+
+int32_t arg_index(const Program *program, const Identifier *ident);
+int32_t compile_insert(
+    Program *program, const Evaluable *evaluable, uint32_t lo, uint32_t hi, uint32_t shift
+);
+int32_t compile_items_bf(Program *program, const MappingItems *items, const BitField *bf);
+int32_t compile_store(Program *program, uint32_t count, uint32_t order);
+int32_t compile_layout(Program *program, const Layout *layout, uint32_t width, uint32_t order);
+int32_t compile_form(Program *program, const InstrForm *form);
+void fill_operand_tables(EncodingVM *vm, GContext *context);
+
+int32_t arg_index(const Program *program, const Identifier *ident) {
+  for (uint32_t i = 0; i < program->n_args; i++) {
+    if (0 == strcmp(program->args[i].ptr, ident->ptr)) { return (int32_t) i; }
+  }
+  return -1;
+}
+
+// Inserts `(value >> shift)` into the bits [lo, hi) of the number, the way `numSetBits` of
+// the generated C does; the value of an operand is looked up the way `eval_to_val` does.
+int32_t compile_insert(
+    Program *program, const Evaluable *evaluable, uint32_t lo, uint32_t hi, uint32_t shift
+) {
+  if (enum_NUMBER == evaluable->type) {
+    pushOp(VM_OP(VM_CONST, lo, hi, 0, 0, 64));
+    pushOp(Number_getBits(evaluable->lhs, shift));
+    return 0;
+  }
+  const Identifier *ident = evaluable->lhs;
+  const Record *record = GContext_findRecord(program->context, ident);
+  const int32_t arg = arg_index(program, ident);
+  if (!record || arg < 0) { return -1; }
+  uint32_t typeid = record->typeid;
+  if (enum_Set == typeid) { typeid = GContext_getSet(program->context, record->offset)->type; }
+
+  uint32_t opcode = VM_ARG, field_lower = 0, field_width = 64;
+  if (enum_BIT_FIELD == evaluable->type) {
+    const BitField *bf = evaluable->rhs;
+    field_lower = bf->lower;
+    field_width = bf->upper - bf->lower + 1;
+  }
+  switch (typeid) {
+    case enum_Register: {
+      if (enum_Set == record->typeid) {
+        opcode = VM_REG;
+        break;
+      }
+      // a fixed register is folded into its code.
+      const uint64_t code = GContext_getRegister(program->context, record->offset)->code;
+      pushOp(VM_OP(VM_CONST, lo, hi, 0, 0, 64));
+      pushOp(((code >> field_lower) & UINT64_MAX >> (64 - field_width)) >> shift);
+      return 0;
+    }
+    case enum_RegisterGroup: {
+      opcode = VM_REG;
+      break;
+    }
+    case enum_Immediate: {
+      if (enum_Set == record->typeid) { opcode = VM_IMM_SET; }
+      break;
+    }
+    case enum_Memory: {
+      if (enum_MEM_KEY != evaluable->type) { break; }
+      const bool is_base = MEM_BASE == (uint64_t) evaluable->rhs;
+      if (enum_Set == record->typeid) {
+        opcode = is_base ? VM_MEM_BASE : VM_MEM_OFFSET;
+        break;
+      }
+      const Memory *mem = GContext_getMemory(program->context, record->offset);
+      const BitField *bf = is_base ? mem->base : mem->offset;
+      field_lower = bf->lower;
+      field_width = bf->upper - bf->lower + 1;
+      break;
+    }
+  }
+  const uint32_t width = (field_width > shift) ? field_width - shift : 0;
+  pushOp(VM_OP(opcode, lo, hi, arg, field_lower + shift, width));
+  return 0;
+}
+
+// Follows `codegen_items_bf`: bits are relative to the 64-bit chunk which `bf` lies in.
+int32_t compile_items_bf(Program *program, const MappingItems *items, const BitField *bf) {
+  const uint32_t base = bf->lower & ~63U;
+  const MappingItem *item = getMappingItem(items, bf);
+  if (!item) {
+    uint64_t default_bit = 0;
+    if (items->default_eval) {
+      default_bit = (Number_getLimb(items->default_eval->lhs, 0) & 1) ? UINT64_MAX : 0;
+    }
+    pushOp(VM_OP(VM_CONST, bf->lower - base, bf->upper + 1 - base, 0, 0, 64));
+    pushOp(default_bit);
+    return 0;
+  }
+  const uint32_t bu = min(item->field->upper, bf->upper);
+  const uint32_t bl = max(item->field->lower, bf->lower);
+  if (bl > bf->lower) {
+    const BitField lower_bf = {.lower = bf->lower, .upper = bl - 1};
+    if (compile_items_bf(program, items, &lower_bf) < 0) { return -1; }
+  }
+  const uint32_t shift = bl - item->field->lower;
+  if (compile_insert(program, item->evaluable, bl - base, bu + 1 - base, shift) < 0) { return -1; }
+  if (bu < bf->upper) {
+    const BitField upper_bf = {.lower = bu + 1, .upper = bf->upper};
+    if (compile_items_bf(program, items, &upper_bf) < 0) { return -1; }
+  }
+  return 0;
+}
+
+int32_t compile_store(Program *program, uint32_t count, uint32_t order) {
+  if (0 == count || count > 8) { return -1; }
+  pushOp(VM_OP(VM_STORE, count, 0, order, 0, 0));
+  program->n_stored += count;
+  return 0;
+}
+
+// Follows `codegen_layout`, chunk by chunk.
+int32_t compile_layout(Program *program, const Layout *layout, uint32_t width, uint32_t order) {
+  const bool msb_first = ORDER_BIG == order || ORDER_HALFWORD == order;
+  const uint32_t n_chunks = (width + 63) / 64;
+  if (enum_MappingItems == layout->type) {
+    const MappingItems *items = layout->target;
+    for (uint32_t j = 0; j < n_chunks; j++) {
+      const uint32_t i = 64 * (msb_first ? n_chunks - 1 - j : j);
+      const BitField bf = {.lower = i, .upper = min(i + 63, width - 1)};
+      if (compile_items_bf(program, items, &bf) < 0) { return -1; }
+      if (compile_store(program, min(64, width - i) / 8, order) < 0) { return -1; }
+    }
+    return 0;
+  }
+  const Evaluable *evaluable = layout->target;
+  for (uint32_t j = 0; j < n_chunks; j++) {
+    const uint32_t i = 64 * (msb_first ? n_chunks - 1 - j : j);
+    const uint32_t limb = i / 64;
+    if (enum_NUMBER == evaluable->type) {
+      if (limb < Number_countLimbs(evaluable->lhs)) {
+        pushOp(VM_OP(VM_CONST, 0, 64, 0, 0, 64));
+        pushOp(Number_getLimb(evaluable->lhs, limb));
+      }
+    } else if (0 == limb) {
+      // an operand only fills the lowest 64 bits.
+      if (compile_insert(program, evaluable, 0, 64, 0) < 0) { return -1; }
+    }
+    if (compile_store(program, min(64, width - i) / 8, order) < 0) { return -1; }
+  }
+  return 0;
+}
+
+int32_t compile_form(Program *program, const InstrForm *form) {
+  program->args = form->pattern->args ? Array_real_addr(form->pattern->args, 0) : nullptr;
+  program->n_args = form->pattern->args ? Array_length(form->pattern->args) : 0;
+  program->n_stored = 0;
+  for (uint32_t part = 0; part < 3; part++) {
+    if (0 == form->parts[part].width) { continue; }
+    const Layout *layout = form->parts[part].layout;
+    if (compile_layout(program, layout, form->parts[part].width, form->parts[part].order) < 0) {
+      return -1;
+    }
+  }
+  // every byte of the form has to be stored, as the bytes are not cleared before a run.
+  if (program->n_stored != form->width / 8) { return -1; }
+  pushOp(VM_OP(VM_END, 0, 0, 0, 0, 0));
+  return 0;
+}
+
+void fill_operand_tables(EncodingVM *vm, GContext *context) {
+  const Allocator *allocator = vm->allocator;
+  const uint32_t n_regs = Array_length(context->regArray);
+  const uint32_t n_imms = Array_length(context->immArray);
+  const uint32_t n_mems = Array_length(context->memArray);
+  vm->regCodes = allocator->calloc(n_regs + 1, sizeof(uint64_t));
+  vm->immediates = allocator->calloc(n_imms + 1, sizeof(VMImmediate));
+  vm->memLayouts = allocator->calloc(n_mems + 1, sizeof(VMMemLayout));
+  for (uint32_t i = 0; i < n_regs; i++) {
+    vm->regCodes[i] = GContext_getRegister(context, i)->code;
+  }
+  for (uint32_t i = 0; i < n_imms; i++) {
+    const Immediate *imm = GContext_getImmediate(context, i);
+    vm->immediates[i] = (VMImmediate) {
+        .mask = (imm->width >= 64) ? UINT64_MAX : (1LLU << imm->width) - 1,
+        .sign = (IT_SIGNED == imm->type) ? 1LLU << (imm->width - 1) : 0,
+    };
+  }
+  for (uint32_t i = 0; i < n_mems; i++) {
+    const Memory *mem = GContext_getMemory(context, i);
+    vm->memLayouts[i] = (VMMemLayout) {
+        .base_lower = mem->base->lower,
+        .base_width = mem->base->upper - mem->base->lower + 1,
+        .offset_lower = mem->offset->lower,
+        .offset_width = mem->offset->upper - mem->offset->lower + 1,
+    };
+  }
+}
+
+// Forms are numbered in the order they are defined, like the ids of `FORM_TIMING`.
+// A form the machine can not run is kept with `VM_INVALID_FORM`, so the ids stay the same.
+EncodingVM *EncodingVM_new(const Machine *machine, const Allocator *allocator) {
+  EncodingVM *vm = allocator->calloc(1, sizeof(EncodingVM));
+  vm->allocator = allocator;
+  vm->code = Array_new(sizeof(uint64_t), -1, allocator);
+  vm->forms = Array_new(sizeof(VMForm), -1, allocator);
+  // a form is compiled aside, so a form which fails leaves nothing in the code.
+  Program program = {
+      .context = machine->context,
+      .code = Array_new(sizeof(uint64_t), -1, allocator),
+  };
+  fill_operand_tables(vm, program.context);
+
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t e = 0; e < n_entries; e++) {
+    const Entry *entry = Array_real_addr(machine->entries, e);
+    if (enum_Instruction != entry->type) { continue; }
+    const Instruction *instr = entry->target;
+    const uint32_t n_forms = Array_length(instr->forms);
+    const InstrForm *forms = Array_real_addr(instr->forms, 0);
+    for (uint32_t i = 0; i < n_forms; i++) {
+      VMForm form = {.start = VM_INVALID_FORM, .size = forms[i].width / 8};
+      if (form.size <= MAX_VM_FORM_BYTES && compile_form(&program, &forms[i]) == 0) {
+        form.start = Array_length(vm->code);
+        const uint32_t length = Array_length(program.code);
+        Array_append(vm->code, Array_real_addr(program.code, 0), length);
+      }
+      Array_reset(program.code, nullptr);
+      Array_append(vm->forms, &form, 1);
+    }
+  }
+  Array_destroy(program.code);
+  return vm;
+}
+
+uint32_t EncodingVM_countForms(const EncodingVM *vm) {
+  return Array_length(vm->forms);
+}
+
+void EncodingVM_destroy(EncodingVM *vm) {
+  const Allocator *allocator = vm->allocator;
+  allocator->free(vm->memLayouts);
+  allocator->free(vm->immediates);
+  allocator->free(vm->regCodes);
+  Array_destroy(vm->forms);
+  Array_destroy(vm->code);
+  allocator->free(vm);
+}
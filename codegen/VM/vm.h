@@ -0,0 +1,89 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen/VM
+ * Filename: vm.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_VM_H
+#define MACHINE_VM_H
+
+#include "allocator.h"
+#include "array.h"
+#include "target.h"
+#include <stdint.h>
+
+#define MAX_VM_FORM_BYTES 256
+#define VM_INVALID_FORM   UINT32_MAX
+
+// An operand as the generated C takes it: `type` is the offset of the register, memory or
+// immediate in its array of the context, and `value` is its value.
+typedef struct Operand {
+  uint32_t type;
+  uint64_t value;
+} Operand;
+
+enum VM_OPCODE {
+  VM_END,
+  VM_CONST,
+  VM_ARG,
+  VM_REG,
+  VM_IMM_SET,
+  VM_MEM_BASE,
+  VM_MEM_OFFSET,
+  VM_STORE,
+};
+
+// A micro-op is one word: the opcode and the fields of a bit insertion or a store.
+// `VM_CONST` takes the constant from the word after it.
+#define VM_OP(op, lo, hi, arg, shift, width)                        \
+  ((uint64_t) (op) | (uint64_t) (lo) << 8 | (uint64_t) (hi) << 16 | \
+   (uint64_t) (arg) << 24 | (uint64_t) (shift) << 32 | (uint64_t) (width) << 40)
+#define opCode(op)  ((op) & 0xFF)
+#define opLo(op)    (((op) >> 8) & 0xFF)
+#define opHi(op)    (((op) >> 16) & 0xFF)
+#define opArg(op)   (((op) >> 24) & 0xFF)
+#define opShift(op) (((op) >> 32) & 0xFF)
+#define opWidth(op) (((op) >> 40) & 0xFF)
+
+typedef struct VMForm {
+  uint32_t start;  // `VM_INVALID_FORM` if the form can not be run
+  uint32_t size;
+} VMForm;
+
+typedef struct VMMemLayout {
+  uint8_t base_lower;
+  uint8_t base_width;
+  uint8_t offset_lower;
+  uint8_t offset_width;
+} VMMemLayout;
+
+// An immediate of a set is taken as `((value & mask) ^ sign) - sign`: masked to the width of
+// its own type and, with `sign` the top bit of a signed type and 0 otherwise, sign-extended.
+typedef struct VMImmediate {
+  uint64_t mask;
+  uint64_t sign;
+} VMImmediate;
+
+typedef struct EncodingVM {
+  const Allocator *allocator;
+  Array /*<uint64_t>*/ *code;
+  Array /*<VMForm>*/ *forms;
+  uint64_t *regCodes;
+  VMImmediate *immediates;
+  VMMemLayout *memLayouts;
+} EncodingVM;
+
+EncodingVM *EncodingVM_new(const Machine *machine, const Allocator *allocator);
+
+uint32_t EncodingVM_countForms(const EncodingVM *vm);
+
+uint32_t EncodingVM_encode(
+    const EncodingVM *vm, uint32_t form, const Operand args[], Array *buffer
+);
+
+void EncodingVM_destroy(EncodingVM *vm);
+
+#endif  // MACHINE_VM_H
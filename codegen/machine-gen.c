@@ -0,0 +1,144 @@
+/**
+ * Project Name: machine
+ * Module Name: codegen
+ * Filename: machine-gen.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "backend.h"
+#include "char_t.h"
+#include "emit.h"
+#include "generate.h"
+#include "ids.h"
+#include "parse.h"
+#include "source.h"
+#include "target.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_PATH 1024
+
+Machine *load_machine(const char_t *path, codegen_t *(*getCodegen)(uint32_t type));
+int32_t write_output(const char_t *path, Array *buffer);
+
+Machine *load_machine(const char_t *path, codegen_t *(*getCodegen)(uint32_t type)) {
+  uint32_t cost = 0, stage = 0;
+  Array *diagnostics = Array_new(sizeof(Diagnostic), -1, &STDAllocator);
+  Machine *machine =
+      parse_file(path, &cost, &stage, diagnostics, (void *) getCodegen, &STDAllocator);
+  if (LOAD_READ == stage) { fprintf(stderr, "failed to read %s.\n", path); }
+  if (LOAD_LEX == stage) { fprintf(stderr, "failed to lex %s at <%u>.\n", path, cost); }
+  const uint32_t n_diags = Array_length(diagnostics);
+  for (uint32_t i = 0; i < n_diags; i++) {
+    const Diagnostic *diag = Array_real_addr(diagnostics, i);
+    fprintf(
+        stderr, "%s: error %u at <%u:%u>: %u.\n", path, diag->kind, diag->lineno, diag->column,
+        diag->detail
+    );
+  }
+  releasePrimeArray(diagnostics);
+  if (machine && n_diags) {
+    // an entry dropped by the recovery would be missing from the outputs.
+    releaseMachine(machine, &STDAllocator);
+    STDAllocator.free(machine);
+    return nullptr;
+  }
+  return machine;
+}
+
+int32_t write_output(const char_t *path, Array *buffer) {
+  FILE *fp = fopen(path, "w");
+  if (!fp) {
+    fprintf(stderr, "failed to open %s.\n", path);
+    return -1;
+  }
+  const uint32_t length = Array_length(buffer);
+  const bool written = fwrite(Array_real_addr(buffer, 0), sizeof(char_t), length, fp) == length;
+  if (fclose(fp) || !written) {
+    fprintf(stderr, "failed to write %s.\n", path);
+    return -1;
+  }
+  return 0;
+}
+
+// usage: machine-gen [--year=<n>] [--holder=<name>] [--ids=<file>] [--cxx] <machine> <stem>
+// Writes the C backend of the machine into `<stem>.h` and `<stem>.c`, or with `--cxx` the
+// C++ backend into `<stem>.hpp`.
+// The year and the holder of the license header are options rather than the date of the
+// run, so the outputs of one description are the same on every run.
+// With `--ids=`, the ids of registers, memories and immediates are read from the file and
+// the new ones are written back to it, so an item keeps its id when others are added.
+int main(int argc, char *argv[]) {
+  int32_t year = 2024;
+  char_t *holder = "xMachine";
+  const char_t *ids_path = nullptr;
+  bool cxx = false;
+  const char_t *paths[2] = {};
+  uint32_t n_paths = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--year=", 7) == 0) {
+      year = (int32_t) strtol(argv[i] + 7, nullptr, 10);
+    } else if (strncmp(argv[i], "--holder=", 9) == 0) {
+      holder = argv[i] + 9;
+    } else if (strncmp(argv[i], "--ids=", 6) == 0) {
+      ids_path = argv[i] + 6;
+    } else if (strcmp(argv[i], "--cxx") == 0) {
+      cxx = true;
+    } else if (n_paths < 2) {
+      paths[n_paths++] = argv[i];
+    }
+  }
+  if (n_paths < 2 || strlen(paths[1]) + 5 > MAX_PATH) {
+    fprintf(
+        stderr, "usage: %s [--year=] [--holder=] [--ids=] [--cxx] <machine> <stem>\n", argv[0]
+    );
+    return -1;
+  }
+
+  Machine *machine = load_machine(paths[0], cxx ? get_cxx_codegen : get_codegen);
+  if (!machine) { return -2; }
+  IdMap *ids = nullptr;
+  if (ids_path) {
+    ids = IdMap_new(&STDAllocator);
+    // a missing file is the first generation, which pins every item.
+    if (IdMap_load(ids, ids_path) < -1) {
+      fprintf(stderr, "%s is not a valid id map.\n", ids_path);
+      IdMap_destroy(ids);
+      releaseMachine(machine, &STDAllocator);
+      STDAllocator.free(machine);
+      return -2;
+    }
+    IdMap_assign(ids, machine->context);
+  }
+
+  char_t header_path[MAX_PATH] = {}, source_path[MAX_PATH] = {};
+  sprintf(header_path, cxx ? "%s.hpp" : "%s.h", paths[1]);
+  sprintf(source_path, "%s.c", paths[1]);
+  const char_t *slash = strrchr(paths[1], '/');
+  const char_t *name = slash ? slash + 1 : paths[1];
+
+  Array *header = Array_new(sizeof(char_t), -1, &STDAllocator);
+  Array *source = Array_new(sizeof(char_t), -1, &STDAllocator);
+  int32_t result = cxx ? emit_cxx_file(machine->context, name, year, holder, ids, header)
+                       : emit_c_files(machine->context, name, year, holder, ids, header, source);
+  if (result < 0) { fprintf(stderr, "failed to generate %s.\n", paths[1]); }
+  result = result ? result : write_output(header_path, header);
+  if (!cxx) { result = result ? result : write_output(source_path, source); }
+  if (0 == result && ids && IdMap_store(ids, ids_path) < 0) {
+    fprintf(stderr, "failed to write %s.\n", ids_path);
+    result = -1;
+  }
+
+  releasePrimeArray(source);
+  releasePrimeArray(header);
+  if (ids) { IdMap_destroy(ids); }
+  releaseMachine(machine, &STDAllocator);
+  STDAllocator.free(machine);
+  return result ? -3 : 0;
+}
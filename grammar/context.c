@@ -9,6 +9,7 @@
 
 #include "context.h"
 #include "avl-tree.h"
+#include "enum.h"
 #include "stack.h"
 #include "target.h"
 #include "terminal.h"
@@ -27,7 +28,9 @@ inline GContext *GContext_new(const Allocator *allocator) {
   context->recordArray = Array_new(sizeof(Record), INT32_MAX - 1, allocator);
   context->objectMap = Trie_new(allocator);
   context->opcodeMap = Trie_new(allocator);
+  context->scopeMap = Trie_new(allocator);
   for (uint32_t i = 0; i < 16; i++) { context->outputs[i] = nullptr; }
+  context->n_forms = 0;
   context->widthStack = Stack_new(allocator);
   context->identStack = Stack_new(allocator);
   context->mappingTree = nullptr;
@@ -59,6 +62,7 @@ inline void GContext_destroy(GContext *context) {
   }
   Trie_destroy(context->objectMap);
   Trie_destroy(context->opcodeMap);
+  Trie_destroy(context->scopeMap);
   contextReleaseStack(widthStack);
   contextReleaseStack(identStack);
   context->allocator->free(context);
@@ -75,6 +79,26 @@ inline Array *GContext_getOutputBuffer(GContext *context, uint32_t index) {
   return context->outputs[index];
 }
 
+// meman's `Array` has no reserve, but keeps its storage over a reset: the room is made by
+// appending zeros from a static block and resetting, which needs no scratch allocation.
+#define RESERVE_BLOCK 4096
+static const char_t RESERVE_ZEROS[RESERVE_BLOCK] = {};
+
+void reserve_array(Array *array, uint32_t size) {
+  for (uint32_t done = 0; done < size; done += RESERVE_BLOCK) {
+    const uint32_t count = (size - done < RESERVE_BLOCK) ? size - done : RESERVE_BLOCK;
+    Array_append(array, RESERVE_ZEROS, count);
+  }
+  Array_reset(array, nullptr);
+}
+
+// Creates the output `index` with storage for `size` bytes, so it takes a single allocation
+// when `size` is not exceeded. An output which is already created is left as it is.
+inline void GContext_reserveOutput(GContext *context, uint32_t index, uint32_t size) {
+  if (context->outputs[index] || 0 == size) { return; }
+  reserve_array(GContext_getOutputBuffer(context, index), size);
+}
+
 inline void GContext_setCodegen(GContext *context, codegen_t *(*getCodegen)(uint32_t token_type)) {
   context->getCodegen = getCodegen;
 }
@@ -128,14 +152,8 @@ contextGetFromOffset_DEF(Memory, memArray);
 contextGetFromOffset_DEF(RegisterGroup, grpArray);
 contextGetFromOffset_DEF(Set, setArray);
 
-inline void *GContext_findIdentInStack(GContext *context, Identifier *ident) {
-  const uint32_t length = Stack_size(context->identStack) / sizeof(Identifier *);
-  const Identifier * const * const idents = Stack_get(context->identStack, 0);
-  for (uint32_t i = 0; i < length; i++) {
-    const Identifier *id = idents[i];
-    if (Identifier_cmp(ident, id) == 0) { return (void *) id; }
-  }
-  return nullptr;
+inline void *GContext_findIdentInStack(GContext *context, const Identifier *ident) {
+  return Trie_get(context->scopeMap, ident->ptr);
 }
 
 inline void GContext_addPattern(GContext *context, Pattern *pattern) {
@@ -162,6 +180,97 @@ uint64_t GContext_getLastWidth(GContext *context) {
   return width;
 }
 
+// Remembers the temporary state of an entry boundary and how many objects the context holds,
+// the parser rolls back to it when it drops a malformed entry.
+void GContext_checkpoint(GContext *context) {
+  context->checkpoint.scopeDepth = Stack_size(context->identStack) / sizeof(ScopeMark);
+  context->checkpoint.widthDepth = Stack_size(context->widthStack) / sizeof(uint64_t);
+  context->checkpoint.n_patterns = context->patterns ? Array_length(context->patterns) : 0;
+  context->checkpoint.n_records = Array_length(context->recordArray);
+  context->checkpoint.n_regs = Array_length(context->regArray);
+  context->checkpoint.n_imms = Array_length(context->immArray);
+  context->checkpoint.n_mems = Array_length(context->memArray);
+  context->checkpoint.n_sets = Array_length(context->setArray);
+  context->checkpoint.n_grps = Array_length(context->grpArray);
+}
+
+void pop_context_ident(GContext *context, void *);
+void pop_context_width(GContext *context, void *);
+void destroy_context_map_item_tree(GContext *context, void *);
+const Identifier *record_name(GContext *context, const Record *record);
+void truncate_context_array(
+    GContext *context, Array **array, uint32_t ele_size, uint32_t type, uint32_t length,
+    destruct_t *destructor
+);
+
+const Identifier *record_name(GContext *context, const Record *record) {
+  switch (record->typeid) {
+    case enum_Register: return GContext_getRegister(context, record->offset)->name;
+    case enum_Immediate: return GContext_getImmediate(context, record->offset)->name;
+    case enum_Memory: return GContext_getMemory(context, record->offset)->name;
+    case enum_Set: return GContext_getSet(context, record->offset)->name;
+    case enum_RegisterGroup: return GContext_getRegisterGroup(context, record->offset)->name;
+  }
+  return nullptr;
+}
+
+// Keeps the first `length` items of `*array` and releases the others. The kept items stay at
+// their offsets, so their virtual addresses still refer to them.
+void truncate_context_array(
+    GContext *context, Array **array, uint32_t ele_size, uint32_t type, uint32_t length,
+    destruct_t *destructor
+) {
+  const uint32_t n_items = Array_length(*array);
+  if (n_items <= length) { return; }
+  Array *kept = Array_new(ele_size, type, context->allocator);
+  if (length > 0) { Array_append(kept, Array_real_addr(*array, 0), length); }
+  if (destructor) {
+    Array *dropped = Array_new(ele_size, -1, context->allocator);
+    Array_append(dropped, Array_real_addr(*array, length), n_items - length);
+    Array_reset(dropped, destructor);
+    Array_destroy(dropped);
+  }
+  releasePrimeArray(*array);
+  *array = kept;
+}
+
+#define contextTruncateArray(array, type, length, destructor)                               \
+  truncate_context_array(                                                                   \
+      context, &context->array, sizeof(type), enum_##type, length, (destruct_t *) destructor \
+  )
+
+void GContext_rollback(GContext *context) {
+  while (Stack_size(context->identStack) / sizeof(ScopeMark) > context->checkpoint.scopeDepth) {
+    pop_context_ident(context, nullptr);
+  }
+  while (Stack_size(context->widthStack) / sizeof(uint64_t) > context->checkpoint.widthDepth) {
+    pop_context_width(context, nullptr);
+  }
+  destroy_context_map_item_tree(context, nullptr);
+  // patterns of dropped forms are released with their tokens.
+  if (context->patterns) {
+    truncate_context_array(
+        context, &context->patterns, sizeof(Pattern *), enum_Pattern,
+        context->checkpoint.n_patterns, nullptr
+    );
+  }
+  // names of dropped objects are unbound before the objects, which own them, are released.
+  const uint32_t n_records = Array_length(context->recordArray);
+  for (uint32_t i = context->checkpoint.n_records; i < n_records; i++) {
+    const Identifier *name = record_name(context, Array_real_addr(context->recordArray, i));
+    Trie_set(context->objectMap, name->ptr, nullptr);
+  }
+  truncate_context_array(
+      context, &context->recordArray, sizeof(Record), INT32_MAX - 1,
+      context->checkpoint.n_records, nullptr
+  );
+  contextTruncateArray(regArray, Register, context->checkpoint.n_regs, releaseRegister);
+  contextTruncateArray(immArray, Immediate, context->checkpoint.n_imms, releaseImmediate);
+  contextTruncateArray(memArray, Memory, context->checkpoint.n_mems, releaseMemory);
+  contextTruncateArray(setArray, Set, context->checkpoint.n_sets, releaseSet);
+  contextTruncateArray(grpArray, RegisterGroup, context->checkpoint.n_grps, releaseRegisterGroup);
+}
+
 inline void GContext_addMapItem(GContext *context, MappingItem *item) {
   AVLTree_set(context->mappingTree, (uint64_t) item->field, item->evaluable);
 }
@@ -170,8 +279,16 @@ inline MappingItem *GContext_getMapItem(GContext *context, BitField *bf) {
   return AVLTree_get(context->mappingTree, (uint64_t) bf);
 }
 
+// Identifiers in scope are kept in `scopeMap`; each mark remembers the identifier it shadowed,
+// so leaving a scope restores the outer binding without scanning the stack.
 void push_context_ident(GContext *context, void *token) {
-  Stack_push(context->identStack, &token, sizeof(uint64_t));
+  const Identifier *ident = token;
+  ScopeMark mark = {
+      .ident = ident,
+      .shadowed = Trie_get(context->scopeMap, ident->ptr),
+  };
+  Stack_push(context->identStack, &mark, sizeof(ScopeMark));
+  Trie_set(context->scopeMap, ident->ptr, (void *) ident);
 }
 
 void realloc_context_map_item_tree(GContext *context, void *) {
@@ -184,11 +301,13 @@ void destroy_context_map_item_tree(GContext *context, void *) {
 }
 
 void pop_context_ident(GContext *context, void *) {
-  Stack_pop(context->identStack, nullptr, sizeof(void *));
+  ScopeMark mark = {};
+  Stack_pop(context->identStack, &mark, sizeof(ScopeMark));
+  Trie_set(context->scopeMap, mark.ident->ptr, (void *) mark.shadowed);
 }
 
 void push_context_width(GContext *context, void *token) {
-  uint64_t width = (uint64_t) token;
+  uint64_t width = widthBits((uint64_t) token);
   Stack_push(context->widthStack, &width, sizeof(uint64_t));
 }
 void pop_context_width(GContext *context, void *) {
@@ -238,6 +357,11 @@ fn_ctx_act *get_after_stack_actions(int32_t state) {
   }
   return nullptr;
 }
+// States at an entry boundary of a machine, where a new entry may start.
+inline bool is_recovery_state(int32_t state) {
+  return state == __MACHINE_IDENTIFIER_LEFT_BRACKET || state == IN_MACHINE(Entries);
+}
+
 fn_ctx_act *get_after_reduce_actions(int32_t state) {
   switch (state) {
     case __Machine: {
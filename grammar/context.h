@@ -22,6 +22,11 @@ typedef struct Record {
   uint32_t offset;
 } Record;
 
+typedef struct ScopeMark {
+  const Identifier *ident;
+  const Identifier *shadowed;
+} ScopeMark;
+
 enum Ctx_ByteBuffer {
   CtxBuf_enum_item,
   CtxBuf_encoding_def,
@@ -32,6 +37,14 @@ enum Ctx_ByteBuffer {
   CtxBuf_register_def,
   CtxBuf_memory_def,
   CtxBuf_immediate_def,
+  CtxBuf_form_enum,
+  CtxBuf_timing_def,
+  CtxBuf_set_def,
+  CtxBuf_form_size,
+  CtxBuf_register_table,
+  CtxBuf_name_dec,
+  CtxBuf_name_def,
+  N_CTX_BUFFERS,
 };
 
 typedef struct GContext {
@@ -44,14 +57,28 @@ typedef struct GContext {
   Array /*<Record>*/ *recordArray;
   Trie /*<uint32_t>*/ *objectMap;
   Trie /*<uint32_t>*/ *opcodeMap;
+  Trie /*<Identifier *>*/ *scopeMap;
   codegen_t *(*getCodegen)(uint32_t token_type);
 
   Array *outputs[16];
+  // ids given to instruction forms in the order they are generated.
+  uint32_t n_forms;
 
   // temporary variable
+  struct {
+    uint32_t scopeDepth;
+    uint32_t widthDepth;
+    uint32_t n_patterns;
+    uint32_t n_records;
+    uint32_t n_regs;
+    uint32_t n_imms;
+    uint32_t n_mems;
+    uint32_t n_sets;
+    uint32_t n_grps;
+  } checkpoint;
   Array *patterns;
   Stack *widthStack;
-  Stack *identStack;
+  Stack /*<ScopeMark>*/ *identStack;
   AVLTree *mappingTree;
 } GContext;
 
@@ -63,6 +90,8 @@ const Allocator *GContext_getAllocator(GContext *context);
 
 Array *GContext_getOutputBuffer(GContext *context, uint32_t index);
 
+void GContext_reserveOutput(GContext *context, uint32_t index, uint32_t size);
+
 void GContext_setCodegen(GContext *context, codegen_t *(*getCodegen)(uint32_t token_type));
 
 codegen_t *GContext_getCodegen(GContext *context, uint32_t token_type);
@@ -87,7 +116,7 @@ Memory *GContext_getMemory(GContext *context, uint32_t offset);
 RegisterGroup *GContext_getRegisterGroup(GContext *context, uint32_t offset);
 Set *GContext_getSet(GContext *context, uint32_t offset);
 
-void *GContext_findIdentInStack(GContext *context, Identifier *ident);
+void *GContext_findIdentInStack(GContext *context, const Identifier *ident);
 
 void GContext_addPattern(GContext *context, Pattern *pattern);
 
@@ -99,6 +128,10 @@ MappingItem *GContext_getMapItem(GContext *context, BitField *bf);
 
 uint64_t GContext_getLastWidth(GContext *context);
 
+void GContext_checkpoint(GContext *context);
+
+void GContext_rollback(GContext *context);
+
 void GContext_destroy(GContext *context);
 
 typedef void fn_ctx_act(GContext *context, void *token);
@@ -106,4 +139,6 @@ typedef void fn_ctx_act(GContext *context, void *token);
 fn_ctx_act *get_after_stack_actions(int32_t state);
 fn_ctx_act *get_after_reduce_actions(int32_t state);
 
+bool is_recovery_state(int32_t state);
+
 #endif  // MACHINE_CONTEXT_H
@@ -26,6 +26,21 @@ enum WIDTH_TYPE {
   WIDTH_BYTE
 };
 
+// byte order of an instruction part, given as a width suffix like `[32-bit-be]`.
+// ORDER_HALFWORD stores 16-bit halfwords most significant first, each little-endian (Thumb-2).
+enum BYTE_ORDER {
+  ORDER_DEFAULT,
+  ORDER_LITTLE,
+  ORDER_BIG,
+  ORDER_HALFWORD,
+};
+
+// the byte order is packed above the bits of a WIDTH token.
+#define WIDTH_ORDER_SHIFT            28
+#define widthBits(width)             ((width) & ((1U << WIDTH_ORDER_SHIFT) - 1))
+#define widthOrder(width)            ((width) >> WIDTH_ORDER_SHIFT)
+#define widthWithOrder(width, order) ((width) | ((uint32_t) (order) << WIDTH_ORDER_SHIFT))
+
 enum IMMEDIATE_TYPE {
   IT_UNSIGNED,
   IT_SIGNED,
@@ -0,0 +1,277 @@
+/**
+ * Project Name: machine
+ * Module Name: grammar
+ * Filename: instrument.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "instrument.h"
+
+#include <stdatomic.h>
+#include <threads.h>
+
+// Calls of the wrapped allocators, over all phases and never reset.
+static struct {
+  atomic_uint_fast64_t n_malloc;
+  atomic_uint_fast64_t n_calloc;
+  atomic_uint_fast64_t n_realloc;
+  atomic_uint_fast64_t n_free;
+} ALLOCATIONS;
+
+#ifdef MACHINE_INSTRUMENT
+typedef struct PhaseCounter {
+  atomic_uint_fast64_t nanos;
+  atomic_uint_fast64_t cycles;
+  atomic_uint_fast64_t n_malloc;
+  atomic_uint_fast64_t n_calloc;
+  atomic_uint_fast64_t n_realloc;
+  atomic_uint_fast64_t n_free;
+} PhaseCounter;
+
+static PhaseCounter PHASES[N_INSTRUMENT_PHASES];
+static thread_local uint32_t current_phase = PHASE_NONE;
+#endif
+
+#define countAllocation(field)                                              \
+  do {                                                                      \
+    atomic_fetch_add_explicit(&ALLOCATIONS.field, 1, memory_order_relaxed); \
+    INSTRUMENT(atomic_fetch_add_explicit(                                   \
+        &PHASES[current_phase].field, 1, memory_order_relaxed               \
+    ));                                                                     \
+  } while (false)
+
+#define MAX_WRAPPED_ALLOCATORS 4
+
+// An `Allocator` has no state to find the allocator it wraps from, so each wrapped allocator
+// takes a slot with its own forwarding functions. The slots are filled under `wrappers_lock`,
+// since the lexing threads wrap their allocators at the same time.
+static struct {
+  const Allocator *wrapped;
+  Allocator counting;
+} WRAPPERS[MAX_WRAPPED_ALLOCATORS];
+static uint32_t n_wrappers = 0;
+static mtx_t wrappers_lock;
+static once_flag wrappers_once = ONCE_FLAG_INIT;
+
+void init_wrappers_lock();
+
+void init_wrappers_lock() { mtx_init(&wrappers_lock, mtx_plain); }
+
+#define defineCountingSlot(n)                            \
+  void *counting_malloc_##n(size_t size) {               \
+    countAllocation(n_malloc);                           \
+    return WRAPPERS[n].wrapped->malloc(size);            \
+  }                                                      \
+  void *counting_calloc_##n(size_t count, size_t size) { \
+    countAllocation(n_calloc);                           \
+    return WRAPPERS[n].wrapped->calloc(count, size);     \
+  }                                                      \
+  void *counting_realloc_##n(void *ptr, size_t size) {   \
+    countAllocation(n_realloc);                          \
+    return WRAPPERS[n].wrapped->realloc(ptr, size);      \
+  }                                                      \
+  void counting_free_##n(void *ptr) {                    \
+    countAllocation(n_free);                             \
+    WRAPPERS[n].wrapped->free(ptr);                      \
+  }
+
+defineCountingSlot(0)
+defineCountingSlot(1)
+defineCountingSlot(2)
+defineCountingSlot(3)
+
+#define countingSlot(n)                                                       \
+  {                                                                           \
+      .malloc = (typeof(WRAPPERS[n].counting.malloc)) counting_malloc_##n,    \
+      .calloc = (typeof(WRAPPERS[n].counting.calloc)) counting_calloc_##n,    \
+      .realloc = (typeof(WRAPPERS[n].counting.realloc)) counting_realloc_##n, \
+      .free = (typeof(WRAPPERS[n].counting.free)) counting_free_##n,          \
+  }
+
+static const Allocator COUNTING_SLOTS[MAX_WRAPPED_ALLOCATORS] = {
+    countingSlot(0), countingSlot(1), countingSlot(2), countingSlot(3)
+};
+
+// An allocator wrapped before gets its counting allocator back, and a counting allocator is
+// returned as it is. Past `MAX_WRAPPED_ALLOCATORS`, allocators are left uncounted.
+const Allocator *Instrument_wrapAllocator(const Allocator *allocator) {
+  call_once(&wrappers_once, init_wrappers_lock);
+  mtx_lock(&wrappers_lock);
+  const Allocator *result = allocator;
+  uint32_t i = 0;
+  for (; i < n_wrappers; i++) {
+    if (allocator == &WRAPPERS[i].counting) { break; }
+    if (allocator == WRAPPERS[i].wrapped) {
+      result = &WRAPPERS[i].counting;
+      break;
+    }
+  }
+  if (i == n_wrappers && n_wrappers < MAX_WRAPPED_ALLOCATORS) {
+    WRAPPERS[i].wrapped = allocator;
+    WRAPPERS[i].counting = *allocator;
+    WRAPPERS[i].counting.malloc = COUNTING_SLOTS[i].malloc;
+    WRAPPERS[i].counting.calloc = COUNTING_SLOTS[i].calloc;
+    WRAPPERS[i].counting.realloc = COUNTING_SLOTS[i].realloc;
+    WRAPPERS[i].counting.free = COUNTING_SLOTS[i].free;
+    result = &WRAPPERS[n_wrappers++].counting;
+  }
+  mtx_unlock(&wrappers_lock);
+  return result;
+}
+
+#define loadCounter(counter) atomic_load_explicit(&(counter), memory_order_relaxed)
+
+InstrumentAllocations Instrument_allocations() {
+  return (InstrumentAllocations) {
+      .n_malloc = loadCounter(ALLOCATIONS.n_malloc),
+      .n_calloc = loadCounter(ALLOCATIONS.n_calloc),
+      .n_realloc = loadCounter(ALLOCATIONS.n_realloc),
+      .n_free = loadCounter(ALLOCATIONS.n_free),
+  };
+}
+
+#ifdef MACHINE_INSTRUMENT
+
+#include "context.h"
+#include "tokens.gen.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define read_cycles() __rdtsc()
+#else
+#define read_cycles() 0ULL
+#endif
+
+static struct {
+  atomic_uint_fast64_t tokens[MAX_INSTRUMENT_SLOTS];
+  atomic_uint_fast64_t reduces[MAX_INSTRUMENT_SLOTS];
+} COUNTERS;
+
+static const char *PHASE_NAMES[N_INSTRUMENT_PHASES] = {
+    [PHASE_NONE] = "none",
+    [PHASE_TOKENIZE] = "tokenize",
+    [PHASE_PARSE] = "parse",
+    [PHASE_CODEGEN] = "codegen",
+};
+
+static const char *BUFFER_NAMES[] = {
+    [CtxBuf_enum_item] = "enum_item",
+    [CtxBuf_encoding_def] = "encoding_def",
+    [CtxBuf_encoding_dec] = "encoding_dec",
+    [CtxBuf_register_dec] = "register_dec",
+    [CtxBuf_memory_dec] = "memory_dec",
+    [CtxBuf_immediate_dec] = "immediate_dec",
+    [CtxBuf_register_def] = "register_def",
+    [CtxBuf_memory_def] = "memory_def",
+    [CtxBuf_immediate_def] = "immediate_def",
+    [CtxBuf_form_enum] = "form_enum",
+    [CtxBuf_timing_def] = "timing_def",
+    [CtxBuf_set_def] = "set_def",
+    [CtxBuf_form_size] = "form_size",
+    [CtxBuf_register_table] = "register_table",
+    [CtxBuf_name_dec] = "name_dec",
+    [CtxBuf_name_def] = "name_def",
+};
+
+static thread_local uint64_t phase_nanos = 0;
+static thread_local uint64_t phase_cycles = 0;
+
+uint64_t instrument_nanos();
+
+uint64_t instrument_nanos() {
+  struct timespec ts = {};
+  timespec_get(&ts, TIME_UTC);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+uint32_t Instrument_switch(uint32_t phase) {
+  const uint64_t nanos = instrument_nanos();
+  const uint64_t cycles = read_cycles();
+  PhaseCounter *counter = &PHASES[current_phase];
+  if (phase_nanos) {
+    atomic_fetch_add_explicit(&counter->nanos, nanos - phase_nanos, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counter->cycles, cycles - phase_cycles, memory_order_relaxed);
+  }
+  const uint32_t previous = current_phase;
+  current_phase = phase;
+  phase_nanos = nanos;
+  phase_cycles = cycles;
+  return previous;
+}
+
+void Instrument_countToken(uint32_t type) {
+  if (type >= MAX_INSTRUMENT_SLOTS) { return; }
+  atomic_fetch_add_explicit(&COUNTERS.tokens[type], 1, memory_order_relaxed);
+}
+
+void Instrument_countReduce(uint32_t rule) {
+  if (rule >= MAX_INSTRUMENT_SLOTS) { return; }
+  atomic_fetch_add_explicit(&COUNTERS.reduces[rule], 1, memory_order_relaxed);
+}
+
+void Instrument_dump(void *context) {
+  const char *path = getenv("MACHINE_INSTRUMENT_FILE");
+  FILE *fp = path ? fopen(path, "w") : stderr;
+  if (!fp) { return; }
+
+  fprintf(fp, "{\n  \"tokens\": {");
+  const char *sep = "";
+  for (uint32_t i = 0; i < MAX_INSTRUMENT_SLOTS; i++) {
+    const uint64_t count = loadCounter(COUNTERS.tokens[i]);
+    if (!count) { continue; }
+    fprintf(fp, "%s\n    \"%s\": %" PRIu64, sep, MACHINE_TOKEN_NAMES[i], count);
+    sep = ",";
+  }
+  fprintf(fp, "\n  },\n  \"reduces\": {");
+  sep = "";
+  for (uint32_t i = 0; i < MAX_INSTRUMENT_SLOTS; i++) {
+    const uint64_t count = loadCounter(COUNTERS.reduces[i]);
+    if (!count) { continue; }
+    fprintf(fp, "%s\n    \"%u\": %" PRIu64, sep, i, count);
+    sep = ",";
+  }
+  fprintf(fp, "\n  },\n  \"phases\": {");
+  sep = "";
+  for (uint32_t i = PHASE_TOKENIZE; i < N_INSTRUMENT_PHASES; i++) {
+    const PhaseCounter *counter = &PHASES[i];
+    fprintf(
+        fp,
+        "%s\n    \"%s\": {\"nanos\": %" PRIu64 ", \"cycles\": %" PRIu64 ", \"malloc\": %" PRIu64
+        ", \"calloc\": %" PRIu64 ", \"realloc\": %" PRIu64 ", \"free\": %" PRIu64 "}",
+        sep, PHASE_NAMES[i], loadCounter(counter->nanos), loadCounter(counter->cycles),
+        loadCounter(counter->n_malloc), loadCounter(counter->n_calloc),
+        loadCounter(counter->n_realloc), loadCounter(counter->n_free)
+    );
+    sep = ",";
+  }
+  fprintf(fp, "\n  },\n  \"outputs\": {");
+  sep = "";
+  for (uint32_t i = 0; context && i < sizeof(BUFFER_NAMES) / sizeof(BUFFER_NAMES[0]); i++) {
+    Array *buffer = ((GContext *) context)->outputs[i];
+    fprintf(fp, "%s\n    \"%s\": %u", sep, BUFFER_NAMES[i], buffer ? Array_length(buffer) : 0);
+    sep = ",";
+  }
+  fprintf(fp, "\n  }\n}\n");
+  if (fp != stderr) { fclose(fp); }
+
+  for (uint32_t i = 0; i < MAX_INSTRUMENT_SLOTS; i++) {
+    atomic_store_explicit(&COUNTERS.tokens[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&COUNTERS.reduces[i], 0, memory_order_relaxed);
+  }
+  for (uint32_t i = 0; i < N_INSTRUMENT_PHASES; i++) {
+    PhaseCounter *counter = &PHASES[i];
+    atomic_store_explicit(&counter->nanos, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter->cycles, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter->n_malloc, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter->n_calloc, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter->n_realloc, 0, memory_order_relaxed);
+    atomic_store_explicit(&counter->n_free, 0, memory_order_relaxed);
+  }
+}
+
+#endif  // MACHINE_INSTRUMENT
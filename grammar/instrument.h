@@ -0,0 +1,63 @@
+/**
+ * Project Name: machine
+ * Module Name: grammar
+ * Filename: instrument.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_INSTRUMENT_H
+#define MACHINE_INSTRUMENT_H
+
+#include "allocator.h"
+#include <stdint.h>
+
+typedef struct InstrumentAllocations {
+  uint64_t n_malloc;
+  uint64_t n_calloc;
+  uint64_t n_realloc;
+  uint64_t n_free;
+} InstrumentAllocations;
+
+// Returns an allocator which forwards to `allocator` and counts its calls, also per phase
+// with `MACHINE_INSTRUMENT` defined.
+const Allocator *Instrument_wrapAllocator(const Allocator *allocator);
+
+// Returns the calls of the wrapped allocators so far, which `Instrument_dump` doesn't reset.
+InstrumentAllocations Instrument_allocations();
+
+// Counters of the lexer, the parser and the codegen callbacks, only compiled in with
+// `MACHINE_INSTRUMENT` defined (cmake -DENABLE_INSTRUMENT=ON).
+#ifdef MACHINE_INSTRUMENT
+
+#define INSTRUMENT(statement) statement
+
+#define MAX_INSTRUMENT_SLOTS 0x100
+
+enum INSTRUMENT_PHASE {
+  PHASE_NONE,
+  PHASE_TOKENIZE,
+  PHASE_PARSE,
+  PHASE_CODEGEN,
+  N_INSTRUMENT_PHASES,
+};
+
+// Switches the phase of the current thread and returns the previous one, elapsed time
+// is charged to the phase being left, so nested phases are counted exclusively.
+uint32_t Instrument_switch(uint32_t phase);
+
+void Instrument_countToken(uint32_t type);
+void Instrument_countReduce(uint32_t rule);
+
+// Writes the counters as JSON to the file named by `$MACHINE_INSTRUMENT_FILE`, or to
+// stderr, then resets them. `context` may be null.
+void Instrument_dump(void *context);
+
+#else
+
+#define INSTRUMENT(statement)
+
+#endif  // MACHINE_INSTRUMENT
+
+#endif  // MACHINE_INSTRUMENT_H
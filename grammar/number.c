@@ -0,0 +1,108 @@
+/**
+ * Project Name: machine
+ * Module Name: grammar
+ * Filename: number.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "number.h"
+#include <string.h>
+
+#define SWAR_DIGITS 8
+
+uint64_t swar_decimal_8(const char_t *input);
+uint64_t swar_hexadecimal_8(const char_t *input);
+uint32_t digit_value(char_t digit);
+bool limbs_mul_add(uint64_t limbs[], uint32_t *n_limbs, uint64_t factor, uint64_t addend);
+
+// The SWAR conversions load the digits little-endian, so the first digit is the low byte.
+inline uint64_t swar_decimal_8(const char_t *input) {
+  uint64_t chunk = 0;
+  memcpy(&chunk, input, SWAR_DIGITS);
+  chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+  chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+  return ((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32;
+}
+
+inline uint64_t swar_hexadecimal_8(const char_t *input) {
+  uint64_t chunk = 0;
+  memcpy(&chunk, input, SWAR_DIGITS);
+  // '0'-'9' keep the low nibble, 'a'-'f' and 'A'-'F' have bit 6 set and need 9 more.
+  chunk = (chunk & 0x0F0F0F0F0F0F0F0F) + 9 * ((chunk >> 6) & 0x0101010101010101);
+  chunk = ((chunk & 0x000F000F000F000F) << 4) | ((chunk >> 8) & 0x000F000F000F000F);
+  chunk = ((chunk & 0x000000FF000000FF) << 8) | ((chunk >> 16) & 0x000000FF000000FF);
+  return ((chunk & 0xFFFF) << 16) | ((chunk >> 32) & 0xFFFF);
+}
+
+inline uint32_t digit_value(char_t digit) {
+  if ('0' <= digit && digit <= '9') { return digit - '0'; }
+  if ('a' <= digit && digit <= 'f') { return digit - 'a' + 0xa; }
+  return digit - 'A' + 0xA;
+}
+
+bool limbs_mul_add(uint64_t limbs[], uint32_t *n_limbs, uint64_t factor, uint64_t addend) {
+  uint64_t carry = addend;
+  for (uint32_t i = 0; i < *n_limbs; i++) {
+    const unsigned __int128 product = (unsigned __int128) limbs[i] * factor + carry;
+    limbs[i] = (uint64_t) product;
+    carry = (uint64_t) (product >> 64);
+  }
+  if (carry) {
+    if (*n_limbs == MAX_NUMBER_LIMBS) { return false; }
+    limbs[(*n_limbs)++] = carry;
+  }
+  return true;
+}
+
+bool Number_fromDigits(
+    const char_t *input, uint32_t length, uint32_t radix, void **value, const Allocator *allocator
+) {
+  uint64_t limbs[MAX_NUMBER_LIMBS] = {};
+  uint32_t n_limbs = 1;
+  uint32_t i = 0;
+
+  // leading digits one by one, so the rest splits into whole SWAR chunks.
+  const bool swar = (10 == radix || 16 == radix);
+  const uint32_t head = swar ? length % SWAR_DIGITS : length;
+  for (; i < head; i++) {
+    if (!limbs_mul_add(limbs, &n_limbs, radix, digit_value(input[i]))) { return false; }
+  }
+  for (; i < length; i += SWAR_DIGITS) {
+    const bool fits = (10 == radix)
+                        ? limbs_mul_add(limbs, &n_limbs, 100000000, swar_decimal_8(&input[i]))
+                        : limbs_mul_add(limbs, &n_limbs, 1LLU << 32, swar_hexadecimal_8(&input[i]));
+    if (!fits) { return false; }
+  }
+
+  if (1 == n_limbs && !isWideNumber(limbs[0])) {
+    *value = (void *) limbs[0];
+    return true;
+  }
+  WideNumber *wide = allocator->malloc(sizeof(WideNumber) + n_limbs * sizeof(uint64_t));
+  wide->n_limbs = n_limbs;
+  allocator->memcpy(wide->limbs, limbs, n_limbs * sizeof(uint64_t));
+  *value = (void *) ((uint64_t) wide | NUMBER_WIDE_TAG);
+  return true;
+}
+
+inline uint32_t Number_countLimbs(const void *value) {
+  return isWideNumber(value) ? asWideNumber(value)->n_limbs : 1;
+}
+
+inline uint64_t Number_getLimb(const void *value, uint32_t index) {
+  if (!isWideNumber(value)) { return index == 0 ? (uint64_t) value : 0; }
+  const WideNumber *wide = asWideNumber(value);
+  return index < wide->n_limbs ? wide->limbs[index] : 0;
+}
+
+uint64_t Number_getBits(const void *value, uint32_t lower) {
+  const uint32_t index = lower / 64, shift = lower % 64;
+  const uint64_t low = Number_getLimb(value, index) >> shift;
+  return shift ? low | Number_getLimb(value, index + 1) << (64 - shift) : low;
+}
+
+void releaseNumber(void *value, const Allocator *allocator) {
+  if (isWideNumber(value)) { allocator->free(asWideNumber(value)); }
+}
@@ -0,0 +1,43 @@
+/**
+ * Project Name: machine
+ * Module Name: grammar
+ * Filename: number.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_NUMBER_H
+#define MACHINE_NUMBER_H
+
+#include "allocator.h"
+#include "char_t.h"
+#include <stdint.h>
+
+// Numbers under 2^63 are held inline in a token's value. Wider ones are held in a
+// `WideNumber` whose address is tagged with the top bit, user space addresses never set it.
+#define NUMBER_WIDE_TAG  (1LLU << 63)
+#define MAX_NUMBER_LIMBS 8  // 512 bits
+
+typedef struct WideNumber {
+  uint32_t n_limbs;
+  uint64_t limbs[];  // least significant first
+} WideNumber;
+
+#define isWideNumber(value) ((((uint64_t) (value)) & NUMBER_WIDE_TAG) != 0)
+#define asWideNumber(value) ((WideNumber *) (((uint64_t) (value)) & ~NUMBER_WIDE_TAG))
+
+// Converts `length` digits of `radix` (2, 8, 10 or 16) at `input` into a token value,
+// returns false if the number needs more than `MAX_NUMBER_LIMBS` limbs.
+bool Number_fromDigits(
+    const char_t *input, uint32_t length, uint32_t radix, void **value, const Allocator *allocator
+);
+
+uint32_t Number_countLimbs(const void *value);
+uint64_t Number_getLimb(const void *value, uint32_t index);
+// The 64 bits of the number from bit `lower` on, zeros past its last limb.
+uint64_t Number_getBits(const void *value, uint32_t lower);
+
+void releaseNumber(void *value, const Allocator *allocator);
+
+#endif  // MACHINE_NUMBER_H
@@ -10,28 +10,58 @@
 #include "parse.h"
 #include "action-table.h"
 #include "context.h"
+#include "instrument.h"
 #include "reduce.gen.h"
 #include "stack.h"
 #include "target.h"
+#include "tokens.gen.h"
 
 Machine *failed_to_get_next_state(
-    Stack *state_stack, Stack *token_stack, void *token, uint32_t type, const Allocator *allocator
+    Stack *state_stack, Stack *token_stack, Value *value, const Allocator *allocator
 );
 
 Machine *failed_to_produce(
-    Stack *state_stack, Stack *token_stack, void *args[], int32_t *states, uint32_t argc,
-    const Allocator *allocator
+    Stack *state_stack, Stack *token_stack, Value args[], uint32_t argc, const Allocator *allocator
 );
 
 Machine *clean_parse_stack(Stack *state_stack, Stack *token_stack, const Allocator *allocator);
 
+void release_reduce_args(Value args[], uint32_t argc, const Allocator *allocator);
+
+void releaseValue(Value *value, const Allocator *allocator);
+
+const Terminal *recover_from_error(
+    Stack *state_stack, Stack *token_stack, GContext *context, const Terminal *tp,
+    const Allocator *allocator
+);
+
+#define pushDiagnostic(_kind, _detail)                                                     \
+  do {                                                                                     \
+    n_errors++;                                                                            \
+    if (diagnostics) {                                                                     \
+      Diagnostic diag = {                                                                  \
+          .kind = (_kind), .detail = (_detail), .lineno = tp->lineno, .column = tp->column \
+      };                                                                                   \
+      Array_append(diagnostics, &diag, 1);                                                 \
+    }                                                                                      \
+  } while (false)
+
+#define instrumentLeave(context) \
+  INSTRUMENT(Instrument_switch(phase); Instrument_dump(context))
+
 #define MAX_ARGC 0x10
-Machine *
-    parse(const Terminal *tokens, uint32_t *cost, void *getCodegen, const Allocator *allocator) {
-  void *result;
+Machine *parse(
+    const Terminal *tokens, uint32_t *cost, Array *diagnostics, void *getCodegen,
+    const Allocator *allocator
+) {
+  INSTRUMENT(const uint32_t phase = Instrument_switch(PHASE_PARSE));
+  INSTRUMENT(allocator = Instrument_wrapAllocator(allocator));
+  Value result = {};
   int32_t state = 0;
   const Terminal *tp = tokens;
-  void *args[MAX_ARGC] = {};
+  const Terminal *last_error = nullptr;
+  uint32_t n_errors = 0;
+  Value args[MAX_ARGC] = {};
   int32_t states[MAX_ARGC] = {};
   Stack *state_stack = Stack_new(allocator);
   Stack *token_stack = Stack_new(allocator);
@@ -42,39 +72,81 @@ Machine *
   while (true) {
     const struct grammar_action *act = getAction(state, tp->type);
     if (!act) {
-      *cost = (uint32_t) (uint64_t) (tp - tokens);
-      GContext_destroy(context);
-      return clean_parse_stack(state_stack, token_stack, allocator);
+      pushDiagnostic(DIAG_UNEXPECTED_TOKEN, tp->type);
+      const Terminal *next = nullptr;
+      if (diagnostics && tp != last_error) {
+        next = recover_from_error(state_stack, token_stack, context, tp, allocator);
+      }
+      if (!next) {
+        if (diagnostics) { pushDiagnostic(DIAG_UNRECOVERABLE, tp->type); }
+        *cost = (uint32_t) (uint64_t) (tp - tokens);
+        instrumentLeave(context);
+        GContext_destroy(context);
+        return clean_parse_stack(state_stack, token_stack, allocator);
+      }
+      last_error = tp;
+      tp = next;
+      Stack_top(state_stack, (int32_t *) &state, sizeof(int32_t));
+      continue;
     }
     if (act->action == stack) {
       state = act->offset;
-      Stack_push(token_stack, &(tp->value), sizeof(void *));
+      Value value = Value_ofTerminal(tp);
+      INSTRUMENT(Instrument_countToken(tp->type));
+      Stack_push(token_stack, &value, sizeof(Value));
       Stack_push(state_stack, &state, sizeof(int32_t));
       fn_ctx_act *ctx_act = get_after_stack_actions(state);
       if (ctx_act) { ctx_act(context, tp->value); }
+      if (is_recovery_state(state)) { GContext_checkpoint(context); }
       tp++;
     } else if (act->action == reduce) {
-      Stack_pop(token_stack, args, act->count * sizeof(void *));
+      Stack_pop(token_stack, args, act->count * sizeof(Value));
       Stack_pop(state_stack, states, act->count * sizeof(int32_t));
       Stack_top(state_stack, (int32_t *) &state, sizeof(int32_t));
       fn_reduce *reduce = PRODUCTS[act->offset];
-      result = reduce(args, context, allocator);
-      if (!result) {
-        *cost = (uint32_t) (uint64_t) (tp - tokens);
-        GContext_destroy(context);
-        return failed_to_produce(state_stack, token_stack, args, states, act->count, allocator);
+      INSTRUMENT(Instrument_countReduce(act->offset));
+      result = (Value) {.type = act->type};
+      if (!reduce(args, &result, context, allocator)) {
+        pushDiagnostic(DIAG_REJECTED_RULE, act->offset);
+        const Terminal *next = nullptr;
+        if (diagnostics && tp != last_error) {
+          release_reduce_args(args, act->count, allocator);
+          next = recover_from_error(state_stack, token_stack, context, tp, allocator);
+          if (!next) { pushDiagnostic(DIAG_UNRECOVERABLE, tp->type); }
+        } else if (diagnostics) {
+          release_reduce_args(args, act->count, allocator);
+          pushDiagnostic(DIAG_UNRECOVERABLE, tp->type);
+        } else {
+          *cost = (uint32_t) (uint64_t) (tp - tokens);
+          instrumentLeave(context);
+          GContext_destroy(context);
+          return failed_to_produce(state_stack, token_stack, args, act->count, allocator);
+        }
+        if (!next) {
+          *cost = (uint32_t) (uint64_t) (tp - tokens);
+          instrumentLeave(context);
+          GContext_destroy(context);
+          return clean_parse_stack(state_stack, token_stack, allocator);
+        }
+        last_error = tp;
+        tp = next;
+        Stack_top(state_stack, (int32_t *) &state, sizeof(int32_t));
+        continue;
       }
       state = jump(state, act->type);
       if (state < 0) {
         *cost = (uint32_t) (uint64_t) (tp - tokens);
+        instrumentLeave(context);
         GContext_destroy(context);
-        return failed_to_get_next_state(state_stack, token_stack, result, act->type, allocator);
+        return failed_to_get_next_state(state_stack, token_stack, &result, allocator);
       }
-      Stack_push(token_stack, &result, sizeof(void *));
+      Stack_push(token_stack, &result, sizeof(Value));
       Stack_push(state_stack, &state, sizeof(int32_t));
+      // the extended rule goes back to the state of `Machine`, whose actions already ran.
+      if (act->offset == __EXTEND_RULE__) { break; }
       fn_ctx_act *ctx_act = get_after_reduce_actions(state);
       if (ctx_act) { ctx_act(context, tp->value); }
-      if (act->offset == __EXTEND_RULE__) { break; }
+      if (is_recovery_state(state)) { GContext_checkpoint(context); }
     } else {
       // never be touched
     }
@@ -84,7 +156,47 @@ Machine *
   allocator->free(token_stack);
   allocator->free(state_stack);
   *cost = (uint32_t) (uint64_t) (tp - tokens);
-  Machine *machine = result;
+  Machine *machine = result.machine;
   machine->context = context;
+  instrumentLeave(context);
+  if (n_errors > 0) {
+    releaseMachine(machine, allocator);
+    allocator->free(machine);
+    return nullptr;
+  }
   return machine;
 }
+
+// Panic-mode recovery: unwinds the parse stack to the entry the error is in, then skips
+// the input to the `;` closing that entry, or to the `}` closing the machine.
+const Terminal *recover_from_error(
+    Stack *state_stack, Stack *token_stack, GContext *context, const Terminal *tp,
+    const Allocator *allocator
+) {
+  // the scope marks refer to identifiers on the parse stack, so they go before the stack.
+  GContext_rollback(context);
+  Value value = {};
+  int32_t state = -1;
+  int32_t depth = 0;
+  Stack_top(state_stack, &state, sizeof(int32_t));
+  while (!is_recovery_state(state)) {
+    if (Stack_empty(token_stack)) { return nullptr; }
+    Stack_pop(token_stack, &value, sizeof(Value));
+    Stack_pop(state_stack, &state, sizeof(int32_t));
+    if (value.type == enum_LEFT_BRACKET) { depth++; }
+    if (value.type == enum_RIGHT_BRACKET) { depth--; }
+    releaseValue(&value, allocator);
+    Stack_top(state_stack, &state, sizeof(int32_t));
+  }
+  for (; tp->type != enum_TERMINATOR; tp++) {
+    if (tp->type == enum_RIGHT_BRACKET && depth == 0) { break; }
+    if (tp->type == enum_SEMICOLON && depth == 0) {
+      tp++;
+      break;
+    }
+    if (tp->type == enum_LEFT_BRACKET) { depth++; }
+    if (tp->type == enum_RIGHT_BRACKET) { depth--; }
+    releaseToken(tp->value, tp->type, allocator);
+  }
+  return tp;
+}
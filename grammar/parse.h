@@ -12,12 +12,31 @@
 
 #include "context.h"
 #include "target.h"
+#include "value.gen.h"
 
-typedef void *fn_reduce(void *argv[], GContext *context, const Allocator *allocator);
+// A reduce builds its result in place of `*result`, and returns false to reject the rule.
+typedef bool fn_reduce(Value argv[], Value *result, GContext *context, const Allocator *allocator);
 
 extern fn_reduce * const PRODUCTS[];
 
-Machine *
-    parse(const Terminal *tokens, uint32_t *cost, void *getCodegen, const Allocator *allocator);
+enum DIAGNOSTIC_KIND {
+  DIAG_UNEXPECTED_TOKEN = 1,
+  DIAG_REJECTED_RULE,
+  DIAG_UNRECOVERABLE,
+};
+
+typedef struct Diagnostic {
+  uint32_t kind;
+  uint32_t detail;  // token type for unexpected tokens, rule index for rejected rules.
+  uint32_t lineno;
+  uint32_t column;
+} Diagnostic;
+
+// With `diagnostics` given, the parser reports an error, drops the entry it is in and
+// goes on with the next one; without it, the parser stops at the first error.
+Machine *parse(
+    const Terminal *tokens, uint32_t *cost, Array /*<Diagnostic>*/ *diagnostics, void *getCodegen,
+    const Allocator *allocator
+);
 
 #endif  // MACHINE_PARSE_H
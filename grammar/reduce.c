@@ -13,10 +13,13 @@
 #include "codegen.h"
 #include "context.h"
 #include "enum.h"
+#include "instrument.h"
+#include "number.h"
 #include "semantic.h"
 #include "target.h"
 #include "terminal.h"
 #include "tokens.gen.h"
+#include "value.gen.h"
 #include <stdint.h>
 
 #define min(a, b) ((a) < (b)) ? (a) : (b)
@@ -24,76 +27,78 @@
 #define grammarAssertDefinedRecord(ident)                 \
   do {                                                    \
     Record *record = GContext_findRecord(context, ident); \
-    if (!record) { return nullptr; }                      \
+    if (!record) { return false; }                        \
   } while (false)
 
 #define grammarAssertNotDeclaredRecord(ident)             \
   do {                                                    \
     Record *record = GContext_findRecord(context, ident); \
-    if (record) { return nullptr; }                       \
+    if (record) { return false; }                         \
     void *id = GContext_findIdentInStack(context, ident); \
-    if (id) { return nullptr; }                           \
+    if (id) { return false; }                             \
   } while (false)
 
-#define grammarAssert(bool_expr)          \
-  do {                                    \
-    if (!(bool_expr)) { return nullptr; } \
+#define grammarAssert(bool_expr)        \
+  do {                                  \
+    if (!(bool_expr)) { return false; } \
   } while (false)
 
-Entries *p_Entries_0(void *argv[], GContext *, const Allocator *allocator) {
-  Entries *entries = (Entries *) argv[0];
-  Entry *entry = (Entry *) argv[1];
-  Array_append(entries, entry, 1);
-  allocator->free(entry);
-  return entries;
+#define callCodegen(type, target)                                        \
+  do {                                                                   \
+    codegen_t *fn_codegen = GContext_getCodegen(context, type);          \
+    if (!fn_codegen) { break; }                                          \
+    INSTRUMENT(const uint32_t phase = Instrument_switch(PHASE_CODEGEN)); \
+    fn_codegen(context, target);                                         \
+    INSTRUMENT(Instrument_switch(phase));                                \
+  } while (false)
+
+bool p_Entries_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  Entries *entries = argv[0].entries;
+  Array_append(entries, &argv[1].entry, 1);
+  result->entries = entries;
+  return true;
 }
 
-Entries *p_Entries_1(void *argv[], GContext *, const Allocator *allocator) {
-  Entry *entry = (Entry *) argv[0];
+bool p_Entries_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
   Entries *entries = Array_new(sizeof(Entry), enum_Entry, allocator);
-  Array_append(entries, entry, 1);
-  allocator->free(entry);
-  return entries;
+  Array_append(entries, &argv[0].entry, 1);
+  result->entries = entries;
+  return true;
 }
 
-Entry *p_Entry_0(void *argv[], GContext *, const Allocator *allocator) {
-  Entry *entry = allocator->calloc(1, sizeof(Entry));
-  entry->type = enum_RegisterGroup;
-  entry->target = (RegisterGroup *) argv[0];
-  return entry;
+bool p_Entry_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  result->entry.type = enum_RegisterGroup;
+  result->entry.target = argv[0].registerGroup;
+  return true;
 }
 
-Entry *p_Entry_1(void *argv[], GContext *, const Allocator *allocator) {
-  Entry *entry = allocator->calloc(1, sizeof(Entry));
-  entry->type = enum_Instruction;
-  entry->target = (Instruction *) argv[0];
-  return entry;
+bool p_Entry_1(Value argv[], Value *result, GContext *, const Allocator *) {
+  result->entry.type = enum_Instruction;
+  result->entry.target = argv[0].instruction;
+  return true;
 }
 
-Entry *p_Entry_2(void *argv[], GContext *, const Allocator *allocator) {
-  Entry *entry = allocator->calloc(1, sizeof(Entry));
-  entry->type = enum_Memory;
-  entry->target = (Memory *) argv[0];
-  return entry;
+bool p_Entry_2(Value argv[], Value *result, GContext *, const Allocator *) {
+  result->entry.type = enum_Memory;
+  result->entry.target = argv[0].memory;
+  return true;
 }
 
-Entry *p_Entry_3(void *argv[], GContext *, const Allocator *allocator) {
-  Entry *entry = allocator->calloc(1, sizeof(Entry));
-  entry->type = enum_Immediate;
-  entry->target = (Immediate *) argv[0];
-  return entry;
+bool p_Entry_3(Value argv[], Value *result, GContext *, const Allocator *) {
+  result->entry.type = enum_Immediate;
+  result->entry.target = argv[0].immediate;
+  return true;
 }
 
-Entry *p_Entry_4(void *argv[], GContext *, const Allocator *allocator) {
-  Entry *entry = allocator->calloc(1, sizeof(Entry));
-  entry->type = enum_Set;
-  entry->target = (Set *) argv[0];
-  return entry;
+bool p_Entry_4(Value argv[], Value *result, GContext *, const Allocator *) {
+  result->entry.type = enum_Set;
+  result->entry.target = argv[0].set;
+  return true;
 }
 
-Evaluable *p_Evaluable_0(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *lhs = (Identifier *) argv[0];
-  void *rhs = argv[2];
+bool p_Evaluable_0(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *lhs = argv[0].identifier;
+  void *rhs = (void *) (uint64_t) argv[2].memKey;
 
   grammarAssertDefinedRecord(lhs);
 
@@ -101,24 +106,27 @@ Evaluable *p_Evaluable_0(void *argv[], GContext *context, const Allocator *alloc
   evaluable->type = enum_MEM_KEY;
   evaluable->lhs = lhs;
   evaluable->rhs = rhs;
-  return evaluable;
+  result->evaluable = evaluable;
+  return true;
 }
 
-Evaluable *p_Evaluable_1(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *lhs = (Identifier *) argv[0];
-  BitField *rhs = (BitField *) argv[1];
+bool p_Evaluable_1(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *lhs = argv[0].identifier;
+  BitField *rhs = argv[1].bitField;
 
   grammarAssertDefinedRecord(lhs);
+  grammarAssert(rhs);
 
   Evaluable *evaluable = allocator->calloc(1, sizeof(Evaluable));
   evaluable->type = enum_BIT_FIELD;
   evaluable->lhs = lhs;
   evaluable->rhs = rhs;
-  return evaluable;
+  result->evaluable = evaluable;
+  return true;
 }
 
-Evaluable *p_Evaluable_2(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *ident = (Identifier *) argv[0];
+bool p_Evaluable_2(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *ident = argv[0].identifier;
 
   grammarAssertDefinedRecord(ident);
 
@@ -126,45 +134,48 @@ Evaluable *p_Evaluable_2(void *argv[], GContext *context, const Allocator *alloc
   evaluable->type = enum_IDENTIFIER;
   evaluable->lhs = ident;
   evaluable->rhs = nullptr;
-  return evaluable;
+  result->evaluable = evaluable;
+  return true;
 }
 
-Evaluable *p_Evaluable_3(void *argv[], GContext *, const Allocator *allocator) {
-  uint64_t number = (uint64_t) argv[0];
+bool p_Evaluable_3(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  uint64_t number = argv[0].number;
   Evaluable *evaluable = allocator->calloc(1, sizeof(Evaluable));
   evaluable->type = enum_NUMBER;
   evaluable->lhs = (void *) number;
   evaluable->rhs = nullptr;
-  return evaluable;
+  result->evaluable = evaluable;
+  return true;
 }
 
-Immediate *p_Immediate_0(void *argv[], GContext *context, const Allocator *) {
-  Identifier *ident = (Identifier *) argv[1];
+bool p_Immediate_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  Identifier *ident = argv[1].identifier;
 
   grammarAssertNotDeclaredRecord(ident);
 
-  uint32_t width = (uint32_t) (uint64_t) argv[2];
-  uint32_t type = (uint64_t) argv[3];
+  uint32_t width = argv[2].width;
+  uint32_t type = argv[3].immType;
+  grammarAssert(ORDER_DEFAULT == widthOrder(width));
   Immediate imm = {.type = type, .width = width, .name = ident};
 
-  Immediate *result = GContext_addImmediate(context, &imm);
+  result->immediate = GContext_addImmediate(context, &imm);
 
-  codegen_t *fn_codegen = GContext_getCodegen(context, enum_Immediate);
-  if (fn_codegen) { fn_codegen(context, result); }
+  callCodegen(enum_Immediate, result->immediate);
 
-  return result;
+  return true;
 }
 
-InstrForm *p_InstrForm_0(void *argv[], GContext *, const Allocator *allocator) {
-  Pattern *pattern = (Pattern *) argv[0];
-  uint32_t width = (uint32_t) (uint64_t) argv[2];
-  InstrParts *part_array = (InstrParts *) argv[4];
+bool p_InstrForm_0(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  Pattern *pattern = argv[0].pattern;
+  uint32_t width = argv[2].width;
+  InstrParts *part_array = argv[4].instrParts;
 
   uint32_t n_parts = Array_length(part_array);
-  if (Array_length(part_array) > 3) { return nullptr; }
+  if (Array_length(part_array) > 3) { return false; }
 
   InstrForm *form = allocator->calloc(1, sizeof(InstrForm));
-  form->width = width;
+  form->width = widthBits(width);
+  form->order = widthOrder(width);
   form->tick = 1;
   form->pattern = pattern;
 
@@ -173,26 +184,29 @@ InstrForm *p_InstrForm_0(void *argv[], GContext *, const Allocator *allocator) {
     const InstrPart *part = &parts[i];
     if (form->parts[part->type - 1].layout) {
       allocator->free(form);
-      return nullptr;
+      return false;
     }
     form->parts[part->type - 1].width = part->width;
+    form->parts[part->type - 1].order = part->order ? part->order : form->order;
     form->parts[part->type - 1].layout = part->layout;
   }
   releasePrimeArray(part_array);
-  return form;
+  result->instrForm = form;
+  return true;
 }
 
-InstrForm *p_InstrForm_1(void *argv[], GContext *, const Allocator *allocator) {
-  Pattern *pattern = (Pattern *) argv[0];
-  uint32_t width = (uint32_t) (uint64_t) argv[2];
-  uint32_t tick = (uint32_t) (uint64_t) argv[3];
-  InstrParts *part_array = (InstrParts *) argv[5];
+bool p_InstrForm_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  Pattern *pattern = argv[0].pattern;
+  uint32_t width = argv[2].width;
+  uint32_t tick = argv[3].tick;
+  InstrParts *part_array = argv[5].instrParts;
 
   uint32_t n_parts = Array_length(part_array);
-  if (Array_length(part_array) > 3) { return nullptr; }
+  if (Array_length(part_array) > 3) { return false; }
 
   InstrForm *form = allocator->calloc(1, sizeof(InstrForm));
-  form->width = width;
+  form->width = widthBits(width);
+  form->order = widthOrder(width);
   form->tick = tick;
   form->pattern = pattern;
 
@@ -201,127 +215,134 @@ InstrForm *p_InstrForm_1(void *argv[], GContext *, const Allocator *allocator) {
     const InstrPart *part = &parts[i];
     if (form->parts[part->type - 1].layout) {
       allocator->free(form);
-      return nullptr;
+      return false;
     }
     form->parts[part->type - 1].width = part->width;
+    form->parts[part->type - 1].order = part->order ? part->order : form->order;
     form->parts[part->type - 1].layout = part->layout;
   }
   releasePrimeArray(part_array);
-  return form;
+  result->instrForm = form;
+  return true;
 }
 
-InstrForms *p_InstrForms_0(void *argv[], GContext *, const Allocator *allocator) {
-  InstrForms *forms = (InstrForms *) argv[0];
-  InstrForm *form = (InstrForm *) argv[1];
+bool p_InstrForms_0(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  InstrForms *forms = argv[0].instrForms;
+  InstrForm *form = argv[1].instrForm;
   Array_append(forms, form, 1);
   allocator->free(form);
-  return forms;
+  result->instrForms = forms;
+  return true;
 }
 
-InstrForms *p_InstrForms_1(void *argv[], GContext *, const Allocator *allocator) {
-  InstrForm *form = (InstrForm *) argv[0];
+bool p_InstrForms_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  InstrForm *form = argv[0].instrForm;
   InstrForms *forms = Array_new(sizeof(InstrForm), enum_InstrForm, allocator);
   Array_append(forms, form, 1);
   allocator->free(form);
-  return forms;
+  result->instrForms = forms;
+  return true;
 }
 
-InstrPart *p_InstrPart_0(void *argv[], GContext *, const Allocator *allocator) {
-  enum PART_KEY key = (uint32_t) (uint64_t) argv[0];
-  uint32_t width = (uint32_t) (uint64_t) argv[2];
-  Layout *layout = (Layout *) argv[4];
+bool p_InstrPart_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  enum PART_KEY key = argv[0].partKey;
+  uint32_t width = argv[2].width;
+  Layout *layout = argv[4].layout;
 
-  if (0 == width) { return nullptr; }
+  if (0 == widthBits(width)) { return false; }
 
-  InstrPart *part = allocator->calloc(1, sizeof(InstrPart));
-  part->type = key;
-  part->width = width;
-  part->layout = layout;
-  return part;
+  result->instrPart.type = key;
+  result->instrPart.width = widthBits(width);
+  result->instrPart.order = widthOrder(width);
+  result->instrPart.layout = layout;
+  return true;
 }
 
-InstrParts *p_InstrParts_0(void *argv[], GContext *, const Allocator *allocator) {
-  InstrParts *parts = (InstrParts *) argv[0];
-  InstrPart *part = (InstrPart *) argv[1];
-  Array_append(parts, part, 1);
-  allocator->free(part);
-  return parts;
+bool p_InstrParts_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  InstrParts *parts = argv[0].instrParts;
+  Array_append(parts, &argv[1].instrPart, 1);
+  result->instrParts = parts;
+  return true;
 }
 
-InstrParts *p_InstrParts_1(void *argv[], GContext *, const Allocator *allocator) {
-  InstrPart *part = (InstrPart *) argv[0];
+bool p_InstrParts_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
   InstrParts *parts = Array_new(sizeof(InstrPart), enum_InstrPart, allocator);
-  Array_append(parts, part, 1);
-  allocator->free(part);
-  return parts;
+  Array_append(parts, &argv[0].instrPart, 1);
+  result->instrParts = parts;
+  return true;
 }
 
-Instruction *p_Instruction_0(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *identifier = (Identifier *) argv[1];
-  InstrForms *forms = (InstrForms *) argv[3];
+bool p_Instruction_0(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *identifier = argv[1].identifier;
+  InstrForms *forms = argv[3].instrForms;
   Instruction *instr = allocator->calloc(1, sizeof(Instruction));
   instr->name = identifier;
   instr->forms = forms;
-  codegen_t *fn_codegen = GContext_getCodegen(context, enum_Instruction);
-  if (fn_codegen) { fn_codegen(context, instr); }
-  return instr;
+  callCodegen(enum_Instruction, instr);
+  result->instruction = instr;
+  return true;
 }
 
-Layout *p_Layout_0(void *argv[], GContext *, const Allocator *allocator) {
-  Evaluable *evaluable = (Evaluable *) argv[0];
+bool p_Layout_0(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  Evaluable *evaluable = argv[0].evaluable;
   Layout *layout = allocator->calloc(1, sizeof(Layout));
   layout->type = enum_Evaluable;
   layout->target = evaluable;
-  return layout;
+  result->layout = layout;
+  return true;
 }
 
-Layout *p_Layout_1(void *argv[], GContext *, const Allocator *allocator) {
-  MappingItems *items = (MappingItems *) argv[1];
+bool p_Layout_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  MappingItems *items = argv[1].mappingItems;
   Layout *layout = allocator->calloc(1, sizeof(Layout));
   layout->type = enum_MappingItems;
   layout->target = items;
-  return layout;
+  result->layout = layout;
+  return true;
 }
 
-Machine *p_Machine_0(void *argv[], GContext *, const Allocator *allocator) {
-  Identifier *identifier = (Identifier *) argv[1];
-  Entries *entries = argv[3];
+bool p_Machine_0(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *identifier = argv[1].identifier;
+  Entries *entries = argv[3].entries;
   Machine *machine = allocator->calloc(1, sizeof(Machine));
   machine->name = identifier;
   machine->entries = entries;
-  return machine;
+  callCodegen(enum_Machine, machine);
+  result->machine = machine;
+  return true;
 }
 
-Machine *p___EXTEND_RULE__(void *argv[], const Allocator *) {
-  return (Machine *) argv[0];
+bool p___EXTEND_RULE__(Value argv[], Value *result, GContext *, const Allocator *) {
+  result->machine = argv[0].machine;
+  return true;
 }
 
-MappingItem *p_MappingItem_0(void *argv[], GContext *context, const Allocator *allocator) {
-  BitField *bit_field = (BitField *) argv[0];
-  Evaluable *evaluable = (Evaluable *) argv[2];
+bool p_MappingItem_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  BitField *bit_field = argv[0].bitField;
+  Evaluable *evaluable = argv[2].evaluable;
 
   if (bit_field) {
     uint64_t width = GContext_getLastWidth(context);
-    if (bit_field->upper > width) { return nullptr; }
+    if (bit_field->upper > width) { return false; }
   }
-  if (GContext_getMapItem(context, bit_field)) { return nullptr; }
-  if (0 != check_mapping_item(context, bit_field, evaluable)) { return nullptr; }
+  if (GContext_getMapItem(context, bit_field)) { return false; }
+  if (0 != check_mapping_item(context, bit_field, evaluable)) { return false; }
 
-  MappingItem *item = allocator->calloc(1, sizeof(MappingItem));
+  MappingItem *item = &result->mappingItem;
   item->field = bit_field;
   item->evaluable = evaluable;
 
   GContext_addMapItem(context, item);
 
-  return item;
+  return true;
 }
 
-MappingItems *p_MappingItems_0(void *argv[], GContext *, const Allocator *allocator) {
-  MappingItems *items = (MappingItems *) argv[0];
-  MappingItem *item = (MappingItem *) argv[2];
+bool p_MappingItems_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  MappingItems *items = argv[0].mappingItems;
+  const MappingItem *item = &argv[2].mappingItem;
 
   if (!item->field) {
-    if (items->default_eval) { return nullptr; }
+    if (items->default_eval) { return false; }
     items->default_eval = item->evaluable;
   } else {
     items->lowest = min(item->field->lower, items->lowest);
@@ -329,12 +350,12 @@ MappingItems *p_MappingItems_0(void *argv[], GContext *, const Allocator *alloca
     AVLTree_set(items->itemTree, (uint64_t) item->field, (void *) (uint64_t) index + 1);
     Array_append(items->itemArray, item, 1);
   }
-  allocator->free(item);
-  return items;
+  result->mappingItems = items;
+  return true;
 }
 
-MappingItems *p_MappingItems_1(void *argv[], GContext *, const Allocator *allocator) {
-  MappingItem *item = (MappingItem *) argv[0];
+bool p_MappingItems_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  const MappingItem *item = &argv[0].mappingItem;
 
   MappingItems *items = allocator->calloc(1, sizeof(MappingItems));
   items->itemArray = Array_new(sizeof(MappingItem), enum_MappingItem, allocator);
@@ -347,29 +368,29 @@ MappingItems *p_MappingItems_1(void *argv[], GContext *, const Allocator *alloca
     AVLTree_set(items->itemTree, (uint64_t) item->field, (void *) 1);
     items->lowest = item->field->lower;
   }
-  allocator->free(item);
-  return items;
+  result->mappingItems = items;
+  return true;
 }
 
-MemItem *p_MemItem_0(void *argv[], GContext *, const Allocator *allocator) {
-  enum MEM_KEY key = (uint32_t) (uint64_t) argv[0];
-  if (key != MEM_BASE && key != MEM_OFFSET) { return nullptr; }
-  BitField *bit_field = (BitField *) argv[2];
-  MemItem *item = allocator->calloc(1, sizeof(MemItem));
-  item->type = key;
-  item->field = bit_field;
-  return item;
+bool p_MemItem_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  enum MEM_KEY key = argv[0].memKey;
+  if (key != MEM_BASE && key != MEM_OFFSET) { return false; }
+  grammarAssert(argv[2].bitField);
+  result->memItem.type = key;
+  result->memItem.field = argv[2].bitField;
+  return true;
 }
 
-Memory *p_Memory_0(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *ident = (Identifier *) argv[1];
-  uint32_t width = (uint32_t) (uint64_t) argv[2];
-  MemItem *item1 = (MemItem *) argv[4];
-  MemItem *item2 = (MemItem *) argv[5];
+bool p_Memory_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  Identifier *ident = argv[1].identifier;
+  uint32_t width = argv[2].width;
+  const MemItem *item1 = &argv[4].memItem;
+  const MemItem *item2 = &argv[5].memItem;
 
   grammarAssertNotDeclaredRecord(ident);
+  grammarAssert(ORDER_DEFAULT == widthOrder(width));
 
-  if (item1->type == item2->type) { return nullptr; }
+  if (item1->type == item2->type) { return false; }
   Memory mem = {.name = ident, .width = width};
   if (item1->type == MEM_BASE) {
     mem.base = item1->field;
@@ -378,52 +399,52 @@ Memory *p_Memory_0(void *argv[], GContext *context, const Allocator *allocator)
     mem.base = item2->field;
     mem.offset = item1->field;
   }
-  allocator->free(item1);
-  allocator->free(item2);
 
-  Memory *result = GContext_addMemory(context, &mem);
+  result->memory = GContext_addMemory(context, &mem);
 
-  codegen_t *fn_codegen = GContext_getCodegen(context, enum_Memory);
-  if (fn_codegen) { fn_codegen(context, result); }
+  callCodegen(enum_Memory, result->memory);
 
-  return result;
+  return true;
 }
 
-Pattern *p_Pattern_0(void *argv[], GContext *context, const Allocator *allocator) {
-  PatternArgs *args = (PatternArgs *) argv[1];
+bool p_Pattern_0(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  PatternArgs *args = argv[1].patternArgs;
 
-  if (GContext_testPattern(context, args)) { return nullptr; }
+  if (GContext_testPattern(context, args)) { return false; }
 
   Pattern *pattern = allocator->calloc(1, sizeof(Pattern));
   pattern->args = args;
 
   GContext_addPattern(context, pattern);
 
-  return pattern;
+  result->pattern = pattern;
+  return true;
 }
 
-Pattern *p_Pattern_1(void *[], GContext *context, const Allocator *allocator) {
+bool p_Pattern_1(Value[], Value *result, GContext *context, const Allocator *allocator) {
   Pattern *pattern = allocator->calloc(1, sizeof(Pattern));
   pattern->args = nullptr;
 
   GContext_addPattern(context, pattern);
 
-  return pattern;
+  result->pattern = pattern;
+  return true;
 }
 
-PatternArgs *p_PatternArgs_0(void *argv[], GContext *context, const Allocator *allocator) {
-  PatternArgs *args = (PatternArgs *) argv[0];
-  Identifier *ident = (Identifier *) argv[2];
+bool p_PatternArgs_0(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  PatternArgs *args = argv[0].patternArgs;
+  Identifier *ident = argv[2].identifier;
 
   grammarAssertDefinedRecord(ident);
 
   Array_append(args, ident, 1);
   allocator->free(ident);
-  return args;
+  result->patternArgs = args;
+  return true;
 }
 
-PatternArgs *p_PatternArgs_1(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *ident = (Identifier *) argv[0];
+bool p_PatternArgs_1(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *ident = argv[0].identifier;
 
   grammarAssertDefinedRecord(ident);
 
@@ -431,83 +452,108 @@ PatternArgs *p_PatternArgs_1(void *argv[], GContext *context, const Allocator *a
   Array_append(args, ident, 1);
   allocator->free(ident);
 
-  return args;
+  result->patternArgs = args;
+  return true;
 }
 
-Register *p_Register_0(void *argv[], GContext *context, const Allocator *) {
-  Identifier *ident = (Identifier *) argv[0];
-  BitField *field = (BitField *) argv[2];
-  uint64_t code = (uint64_t) argv[4];
+bool p_Register_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  Identifier *ident = argv[0].identifier;
+  BitField *field = argv[2].bitField;
+  void *number = (void *) argv[4].number;
 
   grammarAssertNotDeclaredRecord(ident);
+  grammarAssert(field);
+  grammarAssert(Number_countLimbs(number) == 1);
+
+  uint64_t code = Number_getLimb(number, 0);
+  releaseNumber(number, context->allocator);
 
   Register reg = {.name = ident, .field = field, .code = code};
-  return GContext_addRegister(context, &reg);
+  result->reg = GContext_addRegister(context, &reg);
+  return true;
 }
 
-RegisterGroup *p_RegisterGroup_0(void *argv[], GContext *context, const Allocator *) {
-  Identifier *ident = (Identifier *) argv[1];
-  uint32_t width = (uint32_t) (uint64_t) argv[2];
-  Registers *registers = (Registers *) argv[4];
+bool p_RegisterGroup_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  Identifier *ident = argv[1].identifier;
+  uint32_t width = argv[2].width;
+  Registers *registers = argv[4].registers;
 
   grammarAssertNotDeclaredRecord(ident);
+  grammarAssert(ORDER_DEFAULT == widthOrder(width));
 
   const uint32_t len = Array_length(registers);
   grammarAssert(len > 0);
 
   RegisterGroup grp = {.name = ident, .width = width, .registers = registers};
-  REFER(RegisterGroup) result = GContext_addRegisterGroup(context, &grp);
+  REFER(RegisterGroup) group = GContext_addRegisterGroup(context, &grp);
   REFER(Register) *regs = Array_real_addr(registers, 0);
   for (uint32_t i = 0; i < len; i++) {
     Register *reg = Array_vert2real(context->regArray, regs[i]);
-    reg->group = result;
+    reg->group = group;
   }
 
-  codegen_t *fn_codegen = GContext_getCodegen(context, enum_RegisterGroup);
-  if (fn_codegen) { fn_codegen(context, result); }
+  callCodegen(enum_RegisterGroup, group);
 
-  return result;
+  result->registerGroup = group;
+  return true;
 }
 
-Registers *p_Registers_0(void *argv[], GContext *, const Allocator *) {
-  Registers *regs = (Registers *) argv[0];
-  Register *reg = (Register *) argv[1];
+bool p_Registers_0(Value argv[], Value *result, GContext *, const Allocator *) {
+  Registers *regs = argv[0].registers;
+  Register *reg = argv[1].reg;
   Array_append(regs, &reg, 1);
-  return regs;
+  result->registers = regs;
+  return true;
 }
 
-Registers *p_Registers_1(void *argv[], GContext *, const Allocator *allocator) {
-  Register *reg = argv[0];
+bool p_Registers_1(Value argv[], Value *result, GContext *, const Allocator *allocator) {
+  Register *reg = argv[0].reg;
   Registers *regs = Array_new(sizeof(REFER(Register)), -1, allocator);
   Array_append(regs, &reg, 1);
-  return regs;
+  result->registers = regs;
+  return true;
 }
 
-Set *p_Set_0(void *argv[], GContext *context, const Allocator *) {
-  Identifier *ident = (Identifier *) argv[0];
-  SetItems *items = (SetItems *) argv[1];
+bool p_Set_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  Identifier *ident = argv[1].identifier;
+  SetItems *items = argv[3].setItems;
 
   grammarAssertNotDeclaredRecord(ident);
 
-  Set set = {.name = ident, .items = items};
+  // all items of a set are of one kind, so a set operand is encoded by one table.
+  const uint32_t n_items = Array_length(items);
+  const SetItem *item_array = Array_real_addr(items, 0);
+  const uint32_t type = ((Record *) GContext_findRecord(context, item_array[0].name))->typeid;
+  grammarAssert(type == enum_Register || type == enum_Memory || type == enum_Immediate);
+  for (uint32_t i = 1; i < n_items; i++) {
+    const Record *record = GContext_findRecord(context, item_array[i].name);
+    grammarAssert(record->typeid == type);
+  }
+
+  Set set = {.name = ident, .type = type, .items = items};
 
-  return GContext_addSet(context, &set);
+  result->set = GContext_addSet(context, &set);
+
+  callCodegen(enum_Set, result->set);
+
+  return true;
 }
 
-SetItems *p_SetItems_0(void *argv[], GContext *context, const Allocator *) {
-  SetItems *items = (SetItems *) argv[0];
-  Identifier *ident = (Identifier *) argv[2];
+bool p_SetItems_0(Value argv[], Value *result, GContext *context, const Allocator *) {
+  SetItems *items = argv[0].setItems;
+  Identifier *ident = argv[2].identifier;
 
   grammarAssertDefinedRecord(ident);
 
   SetItem item = {ident};
   Array_append(items, &item, 1);
 
-  return items;
+  result->setItems = items;
+  return true;
 }
 
-SetItems *p_SetItems_1(void *argv[], GContext *context, const Allocator *allocator) {
-  Identifier *ident = (Identifier *) argv[0];
+bool p_SetItems_1(Value argv[], Value *result, GContext *context, const Allocator *allocator) {
+  Identifier *ident = argv[0].identifier;
 
   grammarAssertDefinedRecord(ident);
 
@@ -515,53 +561,53 @@ SetItems *p_SetItems_1(void *argv[], GContext *context, const Allocator *allocat
   SetItems *items = Array_new(sizeof(SetItem), enum_SetItems, allocator);
   Array_append(items, &item, 1);
 
-  return items;
+  result->setItems = items;
+  return true;
 }
 
 #include "stack.h"
 
 void releaseToken(void *token, uint32_t type, const Allocator *allocator);
 
+void releaseValue(Value *value, const Allocator *allocator);
+
 Machine *failed_to_get_next_state(
-    Stack *state_stack, Stack *token_stack, void *token, uint32_t type, const Allocator *allocator
+    Stack *state_stack, Stack *token_stack, Value *value, const Allocator *allocator
 );
 
 Machine *failed_to_produce(
-    Stack *state_stack, Stack *token_stack, void *args[], int32_t *states, uint32_t argc,
-    const Allocator *allocator
+    Stack *state_stack, Stack *token_stack, Value args[], uint32_t argc, const Allocator *allocator
 );
 
 Machine *clean_parse_stack(Stack *state_stack, Stack *token_stack, const Allocator *allocator);
 
+void release_reduce_args(Value args[], uint32_t argc, const Allocator *allocator);
+
 Machine *failed_to_get_next_state(
-    Stack *state_stack, Stack *token_stack, void *token, uint32_t type, const Allocator *allocator
+    Stack *state_stack, Stack *token_stack, Value *value, const Allocator *allocator
 ) {
-  int32_t state = 0;
-  Stack_top(state_stack, (&state), sizeof(int32_t));
-  releaseToken(token, type, allocator);
-  allocator->free(token);
+  releaseValue(value, allocator);
   return clean_parse_stack(state_stack, token_stack, allocator);
 }
 
 Machine *failed_to_produce(
-    Stack *state_stack, Stack *token_stack, void *args[], int32_t *states, uint32_t argc,
-    const Allocator *allocator
+    Stack *state_stack, Stack *token_stack, Value args[], uint32_t argc, const Allocator *allocator
 ) {
-  for (uint32_t i = 0; i < argc; i++) {
-    uint32_t type = stateCurrentTokenType(states[i]);
-    releaseToken(args[i], type, allocator);
-  }
+  release_reduce_args(args, argc, allocator);
   return clean_parse_stack(state_stack, token_stack, allocator);
 }
 
+void release_reduce_args(Value args[], uint32_t argc, const Allocator *allocator) {
+  for (uint32_t i = 0; i < argc; i++) { releaseValue(&args[i], allocator); }
+}
+
 Machine *clean_parse_stack(Stack *state_stack, Stack *token_stack, const Allocator *allocator) {
-  void *token = nullptr;
+  Value value = {};
   int32_t state = -1;
   while (!Stack_empty(token_stack)) {
-    Stack_pop(token_stack, &token, sizeof(void *));
+    Stack_pop(token_stack, &value, sizeof(Value));
     Stack_pop(state_stack, &state, sizeof(int32_t));
-    uint32_t type = stateCurrentTokenType(state);
-    releaseToken(token, type, allocator);
+    releaseValue(&value, allocator);
   }
   Stack_clear(token_stack);
   Stack_clear(state_stack);
@@ -570,6 +616,17 @@ Machine *clean_parse_stack(Stack *state_stack, Stack *token_stack, const Allocat
   return nullptr;
 }
 
+// nodes held by value live in the parse stack, the others are released as tokens.
+void releaseValue(Value *value, const Allocator *allocator) {
+  switch (value->type) {
+    case enum_Entry: releaseEntry(&value->entry, allocator); break;
+    case enum_InstrPart: releaseInstrPart(&value->instrPart, allocator); break;
+    case enum_MappingItem: releaseMappingItem(&value->mappingItem, allocator); break;
+    case enum_MemItem: releaseMemItem(&value->memItem, allocator); break;
+    default: releaseToken(value->pointer, value->type, allocator); break;
+  }
+}
+
 #define releaseArrayCase(array, ele)                 \
   case enum_##array: {                               \
     Array_reset(token, (destruct_t *) release##ele); \
@@ -588,25 +645,28 @@ void releaseToken(void *token, uint32_t type, const Allocator *allocator) {
     releaseArrayCase(InstrForms, InstrForm)
     releaseArrayCase(InstrParts, InstrPart)
     releaseArrayCase(PatternArgs, Identifier)
-    releaseArrayCase(Registers, Register)
     releaseArrayCase(SetItems, SetItem)
 
-    releaseTokenCase(Entry, Entry)
     releaseTokenCase(Evaluable, Evaluable)
-    releaseTokenCase(Immediate, Immediate)
     releaseTokenCase(InstrForm, InstrForm)
-    releaseTokenCase(InstrPart, InstrPart)
     releaseTokenCase(Instruction, Instruction)
     releaseTokenCase(Layout, Layout)
     releaseTokenCase(Machine, Machine)
-    releaseTokenCase(MappingItem, MappingItem)
     releaseTokenCase(MappingItems, MappingItems)
-    releaseTokenCase(MemItem, MemItem)
-    releaseTokenCase(Memory, Memory)
     releaseTokenCase(Pattern, Pattern)
-    releaseTokenCase(Register, Register)
-    releaseTokenCase(RegisterGroup, RegisterGroup)
-    releaseTokenCase(Set, Set)
+    case enum_Registers: {
+      // elements are references into the context
+      releasePrimeArray(token);
+      break;
+    }
+    case enum_Immediate:
+    case enum_Memory:
+    case enum_Register:
+    case enum_RegisterGroup:
+    case enum_Set: {
+      // owned by the context, released with it.
+      break;
+    }
     case enum_IDENTIFIER: {
       releaseIdentifier(token, allocator);
       allocator->free(token);
@@ -617,5 +677,9 @@ void releaseToken(void *token, uint32_t type, const Allocator *allocator) {
       allocator->free(token);
       break;
     }
+    case enum_NUMBER: {
+      releaseNumber(token, allocator);
+      break;
+    }
   }
 }
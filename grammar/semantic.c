@@ -9,17 +9,55 @@
 
 #include "semantic.h"
 #include "enum.h"
+#include "number.h"
 #include "tokens.gen.h"
 
+// Width of a memory or an immediate, or of the field `key` of a memory.
+uint32_t field_width(GContext *context, const Record *record, uint32_t key) {
+  if (record->typeid == enum_Memory) {
+    const Memory *memory = GContext_getMemory(context, record->offset);
+    if (!key) { return memory->width; }
+    const BitField *bf = (MEM_BASE == key) ? memory->base : memory->offset;
+    return bf->upper - bf->lower + 1;
+  }
+  if (record->typeid == enum_Immediate) {
+    return key ? 0 : GContext_getImmediate(context, record->offset)->width;
+  }
+  return 0;
+}
+
+// Every item of a set operand is encoded in the same bits, so all of them need the same width.
+int32_t check_set_width(GContext *context, const Set *set, uint32_t key, uint32_t l_width) {
+  if (set->type == enum_Register) { return key ? -1 : 0; }
+  const uint32_t n_items = Array_length(set->items);
+  const SetItem *items = Array_real_addr(set->items, 0);
+  for (uint32_t i = 0; i < n_items; i++) {
+    const Record *record = GContext_findRecord(context, items[i].name);
+    if (field_width(context, record, key) != l_width) { return -2; }
+  }
+  return 0;
+}
+
 int32_t check_mapping_item(GContext *context, BitField *bit_field, Evaluable *evaluable) {
   if (!bit_field) { return (evaluable->type == enum_NUMBER) ? 0 : -1; }
   const uint32_t l_width = (bit_field->upper - bit_field->lower + 1);
 
   uint32_t width = 0;
   switch (evaluable->type) {
+    case enum_NUMBER: {
+      // a literal fills its field when it has no bit above the field, in any of its limbs.
+      const uint32_t n_limbs = Number_countLimbs(evaluable->lhs);
+      for (uint32_t i = l_width / 64; i < n_limbs; i++) {
+        const uint64_t limb = Number_getLimb(evaluable->lhs, i);
+        if (i == l_width / 64 ? limb >> (l_width % 64) : limb) { return -2; }
+      }
+      return 0;
+    }
     case enum_IDENTIFIER: {
       Record *record = GContext_findRecord(context, evaluable->lhs);
-      if (record->typeid == enum_Memory) {
+      if (record->typeid == enum_Set) {
+        return check_set_width(context, GContext_getSet(context, record->offset), 0, l_width);
+      } else if (record->typeid == enum_Memory) {
         width = GContext_getMemory(context, record->offset)->width;
       } else if (record->typeid == enum_Immediate) {
         width = GContext_getImmediate(context, record->offset)->width;
@@ -31,13 +69,19 @@ int32_t check_mapping_item(GContext *context, BitField *bit_field, Evaluable *ev
     }
     case enum_BIT_FIELD: {
       BitField *bf = evaluable->rhs;
+      if (!bf) { return -1; }
       width = bf->upper - bf->lower + 1;
       break;
     }
     case enum_MEM_KEY: {
       Record *record = GContext_findRecord(context, evaluable->lhs);
+      if (record->typeid == enum_Set) {
+        const Set *set = GContext_getSet(context, record->offset);
+        return check_set_width(context, set, (uint64_t) evaluable->rhs, l_width);
+      }
+      if (record->typeid != enum_Memory) { return -1; }
       Memory *memory = GContext_getMemory(context, record->offset);
-      BitField *bf = (MEM_BASE == (uint64_t) evaluable->lhs) ? memory->base : memory->offset;
+      BitField *bf = (MEM_BASE == (uint64_t) evaluable->rhs) ? memory->base : memory->offset;
       width = bf->upper - bf->lower + 1;
       break;
     }
@@ -0,0 +1,276 @@
+/**
+ * Project Name: machine
+ * Module Name: grammar
+ * Filename: source.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "source.h"
+#include "array.h"
+#include "parse.h"
+#include "string_t.h"
+#include "target.h"
+#include "tokenize.h"
+#include <stdio.h>
+#include <threads.h>
+
+#define lenof(str_literal) ((sizeof str_literal) - 1)
+
+typedef struct LexUnit {
+  const Source *source;
+  const Allocator *allocator;
+  const Terminal *tokens;
+  uint32_t n_tokens;
+  uint32_t cost;
+  bool succeed;
+} LexUnit;
+
+typedef struct LexWorker {
+  LexUnit *units;
+  uint32_t first;
+  uint32_t n_units;
+  uint32_t stride;
+  bool threaded;
+  thrd_t thread;
+} LexWorker;
+
+int tokenize_unit(void *arg);
+int lex_worker(void *arg);
+void release_unit_tokens(LexUnit *unit);
+char_t *read_source_file(const char_t *path, const Allocator *allocator);
+char_t *join_import_path(
+    const char_t *base, const char_t *name, uint32_t len, const Allocator *allocator
+);
+void push_source(
+    Array *sources, const char_t *path, const char_t *text, uint32_t len, uint32_t lineno,
+    const Allocator *allocator
+);
+int32_t load_sources_at(
+    const char_t *path, uint32_t depth, Array *sources, const Allocator *allocator
+);
+
+int tokenize_unit(void *arg) {
+  LexUnit *unit = arg;
+  uint32_t lineno = unit->source->lineno, column = 0;
+  unit->tokens = tokenize(
+      unit->source->text, &unit->cost, &unit->n_tokens, &lineno, &column, unit->allocator
+  );
+  unit->succeed = ('\0' == unit->source->text[unit->cost]) && unit->n_tokens > 0;
+  return 0;
+}
+
+int lex_worker(void *arg) {
+  const LexWorker *worker = arg;
+  for (uint32_t i = worker->first; i < worker->n_units; i += worker->stride) {
+    tokenize_unit(&worker->units[i]);
+  }
+  return 0;
+}
+
+void release_unit_tokens(LexUnit *unit) {
+  if (!unit->tokens) { return; }
+  for (uint32_t i = 0; i < unit->n_tokens; i++) {
+    releaseToken(unit->tokens[i].value, unit->tokens[i].type, unit->allocator);
+  }
+  unit->allocator->free((void *) unit->tokens);
+  unit->tokens = nullptr;
+}
+
+const Terminal *tokenize_sources(
+    const Source sources[], uint32_t n_sources, uint32_t *cost, uint32_t *n_tokens,
+    uint32_t *failed, const Allocator *allocator
+) {  // NOLINT(*-easily-swappable-parameters)
+  *n_tokens = 0;
+  if (0 == n_sources) { return nullptr; }
+
+  // the sources are dealt to at most `MAX_LEX_WORKERS` workers in turn, the current thread is
+  // the first of them and a worker whose thread can not be created runs on it as well.
+  LexUnit *units = allocator->calloc(n_sources, sizeof(LexUnit));
+  for (uint32_t i = 0; i < n_sources; i++) {
+    units[i].source = &sources[i];
+    units[i].allocator = allocator;
+  }
+  const uint32_t n_workers = n_sources < MAX_LEX_WORKERS ? n_sources : MAX_LEX_WORKERS;
+  LexWorker workers[MAX_LEX_WORKERS] = {};
+  for (uint32_t i = 0; i < n_workers; i++) {
+    workers[i] = (LexWorker) {
+        .units = units, .first = i, .n_units = n_sources, .stride = n_workers
+    };
+    workers[i].threaded =
+        i > 0 && thrd_success == thrd_create(&workers[i].thread, lex_worker, &workers[i]);
+  }
+  for (uint32_t i = 0; i < n_workers; i++) {
+    if (!workers[i].threaded) { lex_worker(&workers[i]); }
+  }
+  for (uint32_t i = 0; i < n_workers; i++) {
+    if (workers[i].threaded) { thrd_join(workers[i].thread, nullptr); }
+  }
+
+  uint32_t total = 1;
+  for (uint32_t i = 0; i < n_sources; i++) {
+    if (!units[i].succeed) {
+      *cost = units[i].cost;
+      *failed = i;
+      for (uint32_t j = 0; j < n_sources; j++) { release_unit_tokens(&units[j]); }
+      allocator->free(units);
+      return nullptr;
+    }
+    total += units[i].n_tokens - 1;
+  }
+
+  // drop the TERMINATOR of every unit but the last one.
+  Terminal *terminals = allocator->malloc(total * sizeof(Terminal));
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < n_sources; i++) {
+    const uint32_t n_copy = (i + 1 == n_sources) ? units[i].n_tokens : units[i].n_tokens - 1;
+    allocator->memcpy(&terminals[count], units[i].tokens, n_copy * sizeof(Terminal));
+    count += n_copy;
+    allocator->free((void *) units[i].tokens);
+  }
+  allocator->free(units);
+  *cost = 0;
+  *failed = n_sources;
+  *n_tokens = count;
+  return terminals;
+}
+
+char_t *read_source_file(const char_t *path, const Allocator *allocator) {
+  FILE *pFile = fopen(path, "rb");
+  if (!pFile) { return nullptr; }
+  char_t *text = nullptr;
+  if (0 == fseek(pFile, 0, SEEK_END)) {
+    const long size = ftell(pFile);
+    if (size >= 0 && 0 == fseek(pFile, 0, SEEK_SET)) {
+      text = allocator->malloc((size + 1) * sizeof(char_t));
+      const size_t length = fread(text, sizeof(char_t), size, pFile);
+      text[length] = '\0';
+    }
+  }
+  fclose(pFile);
+  return text;
+}
+
+char_t *join_import_path(
+    const char_t *base, const char_t *name, uint32_t len, const Allocator *allocator
+) {
+  uint32_t dir_len = 0;
+  if ('/' != name[0]) {
+    for (uint32_t i = 0; base[i]; i++) {
+      if ('/' == base[i]) { dir_len = i + 1; }
+    }
+  }
+  char_t *path = allocator->malloc((dir_len + len + 1) * sizeof(char_t));
+  allocator->memcpy(path, base, dir_len);
+  allocator->memcpy(path + dir_len, name, len);
+  path[dir_len + len] = '\0';
+  return path;
+}
+
+void push_source(
+    Array *sources, const char_t *path, const char_t *text, uint32_t len, uint32_t lineno,
+    const Allocator *allocator
+) {
+  if (0 == len) { return; }
+  const uint32_t path_len = strlen_o(path);
+  char_t *path_copy = allocator->malloc((path_len + 1) * sizeof(char_t));
+  allocator->memcpy(path_copy, path, path_len + 1);
+  char_t *text_copy = allocator->malloc((len + 1) * sizeof(char_t));
+  allocator->memcpy(text_copy, text, len);
+  text_copy[len] = '\0';
+  Source source = {.path = path_copy, .text = text_copy, .lineno = lineno};
+  Array_append(sources, &source, 1);
+}
+
+// Splits a file at its `#import "<path>"` lines, where `#import` is followed by a blank or the
+// quote; imported files are loaded in place,
+// so the sources stay in the order their tokens should reach the parser.
+int32_t load_sources_at(
+    const char_t *path, uint32_t depth, Array *sources, const Allocator *allocator
+) {
+  if (depth > MAX_IMPORT_DEPTH) { return -1; }
+  char_t *text = read_source_file(path, allocator);
+  if (!text) { return -1; }
+
+  int32_t result = 0;
+  const char_t *segment = text;
+  const char_t *line = text;
+  uint32_t seg_lineno = 0, lineno = 0;
+  while (*line) {
+    const char_t *pText = line;
+    while (' ' == *pText || '\t' == *pText) { pText++; }
+    const char_t *eol = pText + stridx_o('\n', pText);
+    const char_t delimiter = pText[lenof("#import")];
+    if (strcmp_o(pText, "#import") == lenof("#import") &&
+        (' ' == delimiter || '\t' == delimiter || '"' == delimiter)) {
+      push_source(sources, path, segment, line - segment, seg_lineno, allocator);
+      pText += lenof("#import");
+      while (' ' == *pText || '\t' == *pText) { pText++; }
+      const uint32_t name_len = ('"' == *pText) ? stridx_o('"', pText + 1) : 0;
+      if (0 == name_len || pText + 1 + name_len >= eol) {
+        result = -1;
+        break;
+      }
+      char_t *import_path = join_import_path(path, pText + 1, name_len, allocator);
+      result = load_sources_at(import_path, depth + 1, sources, allocator);
+      allocator->free(import_path);
+      if (result < 0) { break; }
+      segment = *eol ? eol + 1 : eol;
+      seg_lineno = lineno + 1;
+    }
+    lineno++;
+    line = *eol ? eol + 1 : eol;
+  }
+  if (result == 0) {
+    push_source(sources, path, segment, line - segment, seg_lineno, allocator);
+  }
+  allocator->free(text);
+  return result;
+}
+
+int32_t load_sources(const char_t *path, Array *sources, const Allocator *allocator) {
+  return load_sources_at(path, 0, sources, allocator);
+}
+
+void release_sources(Array *sources, const Allocator *allocator) {
+  const uint32_t n_sources = Array_length(sources);
+  Source *items = n_sources ? Array_real_addr(sources, 0) : nullptr;
+  for (uint32_t i = 0; i < n_sources; i++) {
+    allocator->free((void *) items[i].path);
+    allocator->free((void *) items[i].text);
+  }
+  releasePrimeArray(sources);
+}
+
+Machine *parse_file(
+    const char_t *path, uint32_t *cost, uint32_t *stage, Array *diagnostics, void *getCodegen,
+    const Allocator *allocator
+) {
+  *cost = 0;
+  Array *sources = Array_new(sizeof(Source), -1, allocator);
+  if (load_sources(path, sources, allocator) < 0) {
+    release_sources(sources, allocator);
+    *stage = LOAD_READ;
+    return nullptr;
+  }
+  uint32_t n_tokens = 0, failed = 0;
+  const Terminal *terminals = tokenize_sources(
+      Array_real_addr(sources, 0), Array_length(sources), cost, &n_tokens, &failed, allocator
+  );
+  release_sources(sources, allocator);
+  if (!terminals) {
+    *stage = LOAD_LEX;
+    return nullptr;
+  }
+  Machine *machine = parse(terminals, cost, diagnostics, getCodegen, allocator);
+  if (!machine) {
+    // the tokens from the failing one on were not taken by the parser.
+    for (uint32_t i = *cost; i < n_tokens; i++) {
+      releaseToken(terminals[i].value, terminals[i].type, allocator);
+    }
+  }
+  allocator->free((void *) terminals);
+  *stage = machine ? 0 : LOAD_PARSE;
+  return machine;
+}
@@ -0,0 +1,54 @@
+/**
+ * Project Name: machine
+ * Module Name: grammar
+ * Filename: source.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_SOURCE_H
+#define MACHINE_SOURCE_H
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "target.h"
+#include "terminal.h"
+#include <stdint.h>
+
+#define MAX_IMPORT_DEPTH 16
+#define MAX_LEX_WORKERS  8
+
+// A piece of machine description text which is lexed on its own.
+// `lineno` is the line the text starts at in its file, so tokens keep file positions.
+typedef struct Source {
+  const char_t *path;
+  const char_t *text;
+  uint32_t lineno;
+} Source;
+
+const Terminal *tokenize_sources(
+    const Source sources[], uint32_t n_sources, uint32_t *cost, uint32_t *n_tokens,
+    uint32_t *failed, const Allocator *allocator
+);
+
+int32_t load_sources(const char_t *path, Array /*<Source>*/ *sources, const Allocator *allocator);
+
+void release_sources(Array /*<Source>*/ *sources, const Allocator *allocator);
+
+enum LOAD_STAGE {
+  LOAD_READ = 1,
+  LOAD_LEX,
+  LOAD_PARSE,
+};
+
+// Loads, lexes and parses the machine description at `path` with its imports; the arguments
+// after `cost` are the ones of `parse`. On failure, `*stage` is the `LOAD_STAGE` which failed
+// and `*cost` the position it failed at, else `*stage` is 0.
+Machine *parse_file(
+    const char_t *path, uint32_t *cost, uint32_t *stage, Array /*<Diagnostic>*/ *diagnostics,
+    void *getCodegen, const Allocator *allocator
+);
+
+#endif  // MACHINE_SOURCE_H
@@ -10,6 +10,7 @@
 #include "target.h"
 #include "avl-tree.h"
 #include "context.h"
+#include "number.h"
 #include "tokens.gen.h"
 
 void releaseIdentifier(Identifier *ident, const Allocator *allocator) {
@@ -41,7 +42,10 @@ void releasePattern(Pattern *pattern, const Allocator *) {
 }
 
 void releaseEvaluable(Evaluable *evaluable, const Allocator *allocator) {
-  if (enum_NUMBER == evaluable->type) { return; }
+  if (enum_NUMBER == evaluable->type) {
+    releaseNumber(evaluable->lhs, allocator);
+    return;
+  }
   if (enum_BIT_FIELD == evaluable->type) {
     releaseBitField(evaluable->rhs, allocator);
     allocator->free(evaluable->rhs);
@@ -68,6 +68,7 @@ typedef struct Layout {
 typedef struct InstrPart {
   uint32_t type;
   uint32_t width;
+  uint32_t order;
   Layout *layout;
 } InstrPart;
 
@@ -76,9 +77,11 @@ typedef Array InstrParts;  // Array<InstrPart>
 typedef struct InstrForm {
   uint32_t width;
   uint32_t tick;
+  uint32_t order;
   Pattern *pattern;
   struct {
     uint32_t width;
+    uint32_t order;
     Layout *layout;
   } parts[3];
 } InstrForm;
@@ -127,6 +130,7 @@ typedef struct SetItem {
 
 typedef struct Set {
   Identifier *name;
+  uint32_t type;  // token type shared by all items: Register, Memory or Immediate
   SetItems *items;
 } Set;
 
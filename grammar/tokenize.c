@@ -9,6 +9,8 @@
 #include "tokenize.h"
 #include "array.h"
 #include "enum.h"
+#include "instrument.h"
+#include "number.h"
 #include "string_t.h"
 #include "terminal.h"
 #include "tokens.gen.h"
@@ -22,15 +24,33 @@ uint32_t t_NUMBER_adic16(const char_t *input, Terminal *result, const Allocator
 uint32_t t_NUMBER_adic10(const char_t *input, Terminal *result, const Allocator *allocator);
 uint32_t t_NUMBER_adic8(const char_t *input, Terminal *result, const Allocator *allocator);
 uint32_t t_NUMBER_adic2(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_instruction(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_immediate(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_machine(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_memory(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_register(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_set(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_unsigned(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t try_keyword_signed(const char_t *input, Terminal *result, const Allocator *allocator);
-uint32_t single_tokenize(const char_t *input, Terminal *result, const Allocator *allocator);
+uint32_t try_keyword_instruction(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_immediate(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_machine(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_memory(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_register(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_set(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_unsigned(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t try_keyword_signed(
+    const char_t *word, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
+uint32_t single_tokenize(
+    const char_t *input, uint32_t remaining, Terminal *result, const Allocator *allocator
+);
 
 uint32_t pass_whitespace(const char * const input);
 uint32_t pass_space(const char * const input, uint32_t * const lineno, uint32_t * const column);
@@ -39,19 +59,24 @@ uint32_t pass_space(const char * const input, uint32_t * const lineno, uint32_t
 #define startswithLetter(pText) \
   (('a' <= (pText)[0] && (pText)[0] <= 'z') || ('A' <= (pText)[0] && (pText)[0] <= 'Z'))
 
+#define finishNumber(radix)                                                            \
+  do {                                                                                 \
+    result->length = pText - input;                                                    \
+    if (!Number_fromDigits(input, result->length, radix, &result->value, allocator)) { \
+      return 0;                                                                        \
+    }                                                                                  \
+    result->type = enum_NUMBER;                                                        \
+    return result->length;                                                             \
+  } while (false)
+
 inline uint32_t t_NUMBER_adic16(
-    const char_t * const input, Terminal * const result,
-    const Allocator * const allocator [[maybe_unused]]
+    const char_t * const input, Terminal * const result, const Allocator * const allocator
 ) {
   const char_t *pText = input;
-  uint64_t value = 0LL;
   while (true) {
-    if ('0' <= *pText && *pText <= '9') {
-      value = (value << 4) + (*pText++ - '0');
-    } else if ('a' <= *pText && *pText <= 'f') {
-      value = (value << 4) + (*pText++ - 'a' + 0xa);  // NOLINT(*-magic-numbers)
-    } else if ('A' <= *pText && *pText <= 'F') {
-      value = (value << 4) + (*pText++ - 'A' + 0xA);  // NOLINT(*-magic-numbers)
+    if (('0' <= *pText && *pText <= '9') || ('a' <= *pText && *pText <= 'f')
+        || ('A' <= *pText && *pText <= 'F')) {
+      pText++;
     } else if (('g' <= *pText && *pText <= 'z') || ('G' <= *pText && *pText <= 'Z')
                || ('_' == *pText)) {
       result->length = pText - input;
@@ -60,21 +85,16 @@ inline uint32_t t_NUMBER_adic16(
       break;
     }
   }
-  result->type = enum_NUMBER;
-  result->value = (void *) value;
-  result->length = pText - input;
-  return result->length;
+  finishNumber(16);
 }
 
 inline uint32_t t_NUMBER_adic10(
-    const char_t * const input, Terminal * const result,
-    const Allocator * const allocator [[maybe_unused]]
+    const char_t * const input, Terminal * const result, const Allocator * const allocator
 ) {
   const char_t *pText = input;
-  uint64_t value = 0;
   while (true) {
     if (startswithDigital(pText)) {
-      value = (value * 10) + (*pText++ - '0');  // NOLINT(*-magic-numbers)
+      pText++;
       continue;
     }
     if (startswithLetter(pText)) {
@@ -83,21 +103,16 @@ inline uint32_t t_NUMBER_adic10(
     }
     break;
   }
-  result->type = enum_NUMBER;
-  result->value = (void *) value;
-  result->length = pText - input;
-  return result->length;
+  finishNumber(10);
 }
 
 inline uint32_t t_NUMBER_adic8(
-    const char_t * const input, Terminal * const result,
-    const Allocator * const allocator [[maybe_unused]]
+    const char_t * const input, Terminal * const result, const Allocator * const allocator
 ) {
   const char_t *pText = input;
-  uint64_t value = 0;
   while (true) {
     if ('0' <= *pText && *pText <= '7') {
-      value = (value << 3) + (*pText++ - '0');
+      pText++;
       continue;
     }
     if (('8' == *pText) || ('9' == *pText) || startswithLetter(pText)) {
@@ -106,21 +121,16 @@ inline uint32_t t_NUMBER_adic8(
     }
     break;
   }
-  result->type = enum_NUMBER;
-  result->value = (void *) value;
-  result->length = pText - input;
-  return result->length;
+  finishNumber(8);
 }
 
 inline uint32_t t_NUMBER_adic2(
-    const char_t * const input, Terminal * const result,
-    const Allocator * const allocator [[maybe_unused]]
+    const char_t * const input, Terminal * const result, const Allocator * const allocator
 ) {
   const char_t *pText = input;
-  uint64_t value = 0;
   while (true) {
     if ('0' == *pText || *pText == '1') {
-      value = (value << 1) + (*pText++ - '0');
+      pText++;
       continue;
     }
     if (('2' <= *pText && *pText <= '9') || startswithLetter(pText)) {
@@ -129,10 +139,7 @@ inline uint32_t t_NUMBER_adic2(
     }
     break;
   }
-  result->type = enum_NUMBER;
-  result->value = (void *) value;
-  result->length = pText - input;
-  return result->length;
+  finishNumber(2);
 }
 
 inline uint32_t t_IDENTIFIER(
@@ -163,34 +170,25 @@ inline uint32_t t_IDENTIFIER(
   return result->length;
 }
 
-#define fn_try_keyword(_kw, _type)                                                           \
-  inline uint32_t try_keyword_##_kw(                                                         \
-      const char_t * const input, Terminal * const result, const Allocator * const allocator \
-  ) {                                                                                        \
-    const char_t pattern[] = string_t(#_kw);                                                 \
-    for (uint32_t i = 2; i < sizeof(pattern) - 1; i++) {                                     \
-      if (input[i - 2] != pattern[i]) { goto __failed_kw_##_kw; }                            \
-    }                                                                                        \
-    result->type = enum_##_type;                                                             \
-    result->value = nullptr;                                                                 \
-    result->length = lenof(#_kw);                                                            \
-    return lenof(#_kw);                                                                      \
-    __failed_kw_##_kw : return t_IDENTIFIER(input - 2, result, allocator);                   \
-  }
-#define fn_try_keyword_val(_kw, _type, val)                                                  \
-  inline uint32_t try_keyword_##_kw(                                                         \
-      const char_t * const input, Terminal * const result, const Allocator * const allocator \
-  ) {                                                                                        \
-    const char_t pattern[] = string_t(#_kw);                                                 \
-    for (uint32_t i = 2; i < sizeof(pattern) - 1; i++) {                                     \
-      if (input[i - 2] != pattern[i]) { goto __failed_kw_##_kw; }                            \
-    }                                                                                        \
-    result->type = enum_##_type;                                                             \
-    result->value = (void *) val;                                                            \
-    result->length = lenof(#_kw);                                                            \
-    return lenof(#_kw);                                                                      \
-    __failed_kw_##_kw : return t_IDENTIFIER(input - 2, result, allocator);                   \
+// `word` is the start of the word and `remaining` the count of characters left from it, so no
+// comparison reads past the end of the input whatever the word is.
+#define fn_try_keyword_val(_kw, _type, val)                                         \
+  inline uint32_t try_keyword_##_kw(                                                \
+      const char_t * const word, const uint32_t remaining, Terminal * const result, \
+      const Allocator * const allocator                                             \
+  ) {                                                                               \
+    const char_t pattern[] = string_t(#_kw);                                        \
+    if (remaining < lenof(#_kw)) { goto __failed_kw_##_kw; }                        \
+    for (uint32_t i = 2; i < lenof(#_kw); i++) {                                    \
+      if (word[i] != pattern[i]) { goto __failed_kw_##_kw; }                        \
+    }                                                                               \
+    result->type = enum_##_type;                                                    \
+    result->value = (void *) val;                                                   \
+    result->length = lenof(#_kw);                                                   \
+    return lenof(#_kw);                                                             \
+    __failed_kw_##_kw : return t_IDENTIFIER(word, result, allocator);               \
   }
+#define fn_try_keyword(_kw, _type) fn_try_keyword_val(_kw, _type, nullptr)
 
 fn_try_keyword(immediate, IMMEDIATE)
 fn_try_keyword(instruction, INSTRUCTION)
@@ -202,12 +200,12 @@ fn_try_keyword_val(unsigned, TYPE, IT_UNSIGNED)
 fn_try_keyword_val(signed, TYPE, IT_SIGNED)
 #define fn_fall_through()                                           \
   do {                                                              \
-    uint32_t length = t_IDENTIFIER(input - 1, result, allocator);   \
+    uint32_t length = t_IDENTIFIER(word, result, allocator);        \
     if (length == 0) {                                              \
       Identifier *ident = allocator->calloc(1, sizeof(Identifier)); \
       ident->len = 1;                                               \
       ident->ptr = allocator->calloc(2, sizeof(char_t));            \
-      allocator->memcpy(ident->ptr, input, 1);                      \
+      allocator->memcpy(ident->ptr, word, 1);                       \
       ident->ptr[1] = '\0';                                         \
       result->type = enum_IDENTIFIER;                               \
       result->value = ident;                                        \
@@ -217,75 +215,93 @@ fn_try_keyword_val(signed, TYPE, IT_SIGNED)
     return length;                                                  \
   } while (0)
 
+// The second character of a word, or `\0` for a word of one character at the end of the input.
+#define secondChar(word, remaining) ((remaining) > 1 ? (word)[1] : '\0')
+
 uint32_t tokenize_letter_i(
-    const char_t * const input, Terminal * const result, const Allocator * const allocator
+    const char_t * const word, const uint32_t remaining, Terminal * const result,
+    const Allocator * const allocator
 ) {
-  switch (*input) {
+  switch (secondChar(word, remaining)) {
     case 'm': {
-      return try_keyword_immediate(input + 1, result, allocator);
+      return try_keyword_immediate(word, remaining, result, allocator);
     }
     case 'n': {
-      return try_keyword_instruction(input + 1, result, allocator);
+      return try_keyword_instruction(word, remaining, result, allocator);
     }
     default: fn_fall_through();
   }
 }
 
 uint32_t tokenize_letter_m(
-    const char_t * const input, Terminal * const result, const Allocator * const allocator
+    const char_t * const word, const uint32_t remaining, Terminal * const result,
+    const Allocator * const allocator
 ) {
-  switch (*input) {
+  switch (secondChar(word, remaining)) {
     case 'a': {
-      return try_keyword_machine(input + 1, result, allocator);
+      return try_keyword_machine(word, remaining, result, allocator);
     }
     case 'e': {
-      return try_keyword_memory(input + 1, result, allocator);
+      return try_keyword_memory(word, remaining, result, allocator);
     }
     default: fn_fall_through();
   }
 }
 
 uint32_t tokenize_letter_s(
-    const char_t * const input, Terminal * const result, const Allocator * const allocator
+    const char_t * const word, const uint32_t remaining, Terminal * const result,
+    const Allocator * const allocator
 ) {
-  switch (*input) {
+  switch (secondChar(word, remaining)) {
     case 'e': {
-      return try_keyword_set(input + 1, result, allocator);
+      return try_keyword_set(word, remaining, result, allocator);
     }
     case 'i': {
-      return try_keyword_signed(input + 1, result, allocator);
+      return try_keyword_signed(word, remaining, result, allocator);
     }
     default: fn_fall_through();
   }
 }
 
 uint32_t tokenize_letter_r(
-    const char_t * const input, Terminal * const result, const Allocator * const allocator
+    const char_t * const word, const uint32_t remaining, Terminal * const result,
+    const Allocator * const allocator
 ) {
-  switch (*input) {
+  switch (secondChar(word, remaining)) {
     case 'e': {
-      return try_keyword_register(input + 1, result, allocator);
+      return try_keyword_register(word, remaining, result, allocator);
     }
     default: fn_fall_through();
   }
 }
 
 uint32_t tokenize_letter_u(
-    const char_t * const input, Terminal * const result, const Allocator * const allocator
+    const char_t * const word, const uint32_t remaining, Terminal * const result,
+    const Allocator * const allocator
 ) {
-  switch (*input) {
+  switch (secondChar(word, remaining)) {
     case 'n': {
-      return try_keyword_unsigned(input + 1, result, allocator);
+      return try_keyword_unsigned(word, remaining, result, allocator);
     }
     default: fn_fall_through();
   }
 }
 
+// widths, bit field bounds and ticks never need more than one limb.
+#define rejectWideNumber(result)                 \
+  do {                                           \
+    if (isWideNumber((result)->value)) {         \
+      releaseNumber((result)->value, allocator); \
+      return 0;                                  \
+    }                                            \
+  } while (false)
+
 uint32_t tokenize_startswith_digital(
     const char_t * const input, Terminal * const result, const Allocator * const allocator
 ) {
   uint32_t length = t_NUMBER_adic10(input, result, allocator);
   if (length == 0) { return 0; }
+  rejectWideNumber(result);
   uint32_t value = (uint32_t) (uint64_t) result->value;
   const char_t *pText = input + length;
   pText += pass_whitespace(pText);
@@ -310,6 +326,7 @@ uint32_t tokenize_startswith_digital(
     result->value = (void *) (uint64_t) value;
     pText += lenof("bit") + pass_whitespace(pText);
   } else if ((length = t_NUMBER_adic10(pText, result, allocator)) > 0) {
+    rejectWideNumber(result);
     pText += length;
     BitField *bitField = allocator->calloc(1, sizeof(BitField));
     bitField->lower = (uint32_t) (uint64_t) result->value;
@@ -318,6 +335,25 @@ uint32_t tokenize_startswith_digital(
     result->type = enum_BIT_FIELD;
     result->value = bitField;
   }
+
+  // a width may give the byte order of an instruction part, like `[32-bit-be]`.
+  if (enum_WIDTH == result->type && '-' == *pText) {
+    pText += 1 + pass_whitespace(pText + 1);
+    uint32_t order = ORDER_DEFAULT;
+    if (strcmp_o(pText, "le") == lenof("le")) {
+      order = ORDER_LITTLE;
+    } else if (strcmp_o(pText, "be") == lenof("be")) {
+      order = ORDER_BIG;
+    } else if (strcmp_o(pText, "hw") == lenof("hw")) {
+      order = ORDER_HALFWORD;
+    } else {
+      result->length = pText - input;
+      return 0;
+    }
+    const uint32_t width = (uint32_t) (uint64_t) result->value;
+    result->value = (void *) (uint64_t) widthWithOrder(width, order);
+    pText += lenof("le");
+  }
   pText += pass_whitespace(pText);
 
   if (*pText != ']') {
@@ -336,6 +372,7 @@ uint32_t tokenize_symbol_LPAREN(
   const char_t *pText = input;
   uint32_t length = t_NUMBER_adic10(pText, result, allocator);
   if (length == 0) { return 0; }
+  rejectWideNumber(result);
   pText += length;
   pText += pass_whitespace(pText);
   if (*pText++ != '-') {
@@ -426,7 +463,8 @@ const uint32_t TERMINAL_TYPE_LITERALS[] = {
     enum_EQUAL,        enum_RIGHT_SQUARE_BRACKET, enum_COMMA, enum_DOT,
 };
 inline uint32_t single_tokenize(
-    const char_t * const input, Terminal * const result, const Allocator * const allocator
+    const char_t * const input, const uint32_t remaining, Terminal * const result,
+    const Allocator * const allocator
 ) {
   // single literal
   uint32_t length = stridx_o(*input, "{}:;=],.");
@@ -439,19 +477,19 @@ inline uint32_t single_tokenize(
 
   switch (*input) {
     case 'i': {
-      return tokenize_letter_i(input + 1, result, allocator);
+      return tokenize_letter_i(input, remaining, result, allocator);
     }
     case 'm': {
-      return tokenize_letter_m(input + 1, result, allocator);
+      return tokenize_letter_m(input, remaining, result, allocator);
     }
     case 'r': {
-      return tokenize_letter_r(input + 1, result, allocator);
+      return tokenize_letter_r(input, remaining, result, allocator);
     }
     case 's': {
-      return tokenize_letter_s(input + 1, result, allocator);
+      return tokenize_letter_s(input, remaining, result, allocator);
     }
     case 'u': {
-      return tokenize_letter_u(input + 1, result, allocator);
+      return tokenize_letter_u(input, remaining, result, allocator);
     }
     case '[': {
       return tokenize_symbol_LSQUARE(input + 1, result, allocator);
@@ -549,9 +587,12 @@ __return:
 
 const Terminal *tokenize(
     const char_t * const input, uint32_t *cost, uint32_t *n_tokens, uint32_t * const lineno,
-    uint32_t * const column, const Allocator * const allocator
+    uint32_t * const column, const Allocator *allocator
 ) {  // NOLINT(*-easily-swappable-parameters)
+  INSTRUMENT(const uint32_t phase = Instrument_switch(PHASE_TOKENIZE));
+  INSTRUMENT(allocator = Instrument_wrapAllocator(allocator));
   const char_t *pText = input;
+  const char_t * const end = input + strlen_o(input);
   uint32_t l = lineno ? *lineno : 0;
   uint32_t c = column ? *column : 0;
   Array *terminals = Array_new(sizeof(Terminal), enum_TERMINATOR, allocator);
@@ -560,7 +601,7 @@ const Terminal *tokenize(
   while (*pText) {
     terminal.lineno = l;
     terminal.column = c;
-    *cost = single_tokenize(pText, &terminal, allocator);
+    *cost = single_tokenize(pText, end - pText, &terminal, allocator);
     c += terminal.length;
     if (0 == *cost) { break; }
     pText += *cost;
@@ -581,6 +622,7 @@ const Terminal *tokenize(
   Array_destroy(terminals);
   lineno ? *lineno = l : 0;
   column ? *column = c : 0;
+  INSTRUMENT(Instrument_switch(phase));
   return pTerminals;
 }
 
@@ -0,0 +1,243 @@
+/**
+ * Project Name: machine
+ * Module Name: runtime
+ * Filename: relax.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "relax.h"
+
+#define INIT_FRAGMENT_CAPACITY 64
+
+#define lowbit(i) ((i) & (-(i)))
+
+uint32_t size_prefix(const Relaxer *relaxer, uint32_t count);
+void size_update(Relaxer *relaxer, uint32_t index, int64_t delta);
+uint32_t push_fragment(Relaxer *relaxer, const Fragment *fragment);
+int64_t branch_disp(const Relaxer *relaxer, uint32_t branch);
+void span_bounds(const Fragment *fragment, uint32_t branch, uint32_t *lower, uint32_t *upper);
+uint32_t span_width(uint32_t n_fragments);
+void index_spans(Relaxer *relaxer);
+
+// the total size of the first `count` fragments.
+uint32_t size_prefix(const Relaxer *relaxer, uint32_t count) {
+  uint32_t sum = 0;
+  for (int64_t i = count; i > 0; i -= lowbit(i)) { sum += relaxer->sizeTree[i]; }
+  return sum;
+}
+
+void size_update(Relaxer *relaxer, uint32_t index, int64_t delta) {
+  for (int64_t i = index + 1; i <= relaxer->capacity; i += lowbit(i)) {
+    relaxer->sizeTree[i] += delta;
+  }
+}
+
+Relaxer *Relaxer_new(const Allocator *allocator) {
+  Relaxer *relaxer = allocator->calloc(1, sizeof(Relaxer));
+  relaxer->allocator = allocator;
+  relaxer->capacity = INIT_FRAGMENT_CAPACITY;
+  relaxer->fragments = allocator->calloc(relaxer->capacity, sizeof(Fragment));
+  relaxer->sizeTree = allocator->calloc(relaxer->capacity + 1, sizeof(uint32_t));
+  return relaxer;
+}
+
+uint32_t push_fragment(Relaxer *relaxer, const Fragment *fragment) {
+  const Allocator *allocator = relaxer->allocator;
+  if (relaxer->n_fragments == relaxer->capacity) {
+    // a node of the tree only covers fragments before it, so growing keeps every node valid.
+    const uint32_t capacity = relaxer->capacity * 2;
+    relaxer->fragments = allocator->realloc(relaxer->fragments, capacity * sizeof(Fragment));
+    relaxer->sizeTree = allocator->realloc(relaxer->sizeTree, (capacity + 1) * sizeof(uint32_t));
+    for (uint32_t i = relaxer->capacity + 1; i <= capacity; i++) {
+      relaxer->sizeTree[i] = size_prefix(relaxer, i - 1) - size_prefix(relaxer, i - lowbit(i));
+    }
+    relaxer->capacity = capacity;
+  }
+  const uint32_t index = relaxer->n_fragments++;
+  relaxer->fragments[index] = *fragment;
+  size_update(relaxer, index, fragment->size);
+  return index;
+}
+
+// A label is a fixed fragment of size 0, and branches target it by its index.
+uint32_t Relaxer_addFixed(Relaxer *relaxer, uint32_t size, void *payload, fn_relax_encode *encode) {
+  const Fragment fragment = {.payload = payload, .encode = encode, .size = size};
+  return push_fragment(relaxer, &fragment);
+}
+
+// A branch starts with its narrowest form and only grows while it is relaxed.
+uint32_t Relaxer_addBranch(
+    Relaxer *relaxer, const RelaxForm forms[], uint32_t n_forms, uint32_t target, void *payload,
+    fn_relax_encode *encode
+) {
+  const Fragment fragment = {
+      .payload = payload,
+      .encode = encode,
+      .forms = forms,
+      .n_forms = n_forms,
+      .target = target,
+      .size = n_forms ? forms[0].size : 0,
+  };
+  return push_fragment(relaxer, &fragment);
+}
+
+void Relaxer_setTarget(Relaxer *relaxer, uint32_t branch, uint32_t target) {
+  relaxer->fragments[branch].target = target;
+}
+
+uint32_t Relaxer_offsetOf(const Relaxer *relaxer, uint32_t fragment) {
+  return size_prefix(relaxer, fragment);
+}
+
+int64_t branch_disp(const Relaxer *relaxer, uint32_t branch) {
+  const Fragment *fragment = &relaxer->fragments[branch];
+  const int64_t end = (int64_t) size_prefix(relaxer, branch) + fragment->size;
+  return (int64_t) size_prefix(relaxer, fragment->target) - end;
+}
+
+// The fragments the displacement of `branch` is over, from `lower` up to before `upper`.
+void span_bounds(const Fragment *fragment, uint32_t branch, uint32_t *lower, uint32_t *upper) {
+  *lower = (fragment->target > branch) ? branch + 1 : fragment->target;
+  *upper = (fragment->target > branch) ? fragment->target : branch;
+}
+
+// the count of leaves of the span tree, a power of two.
+uint32_t span_width(uint32_t n_fragments) {
+  uint32_t width = 1;
+  while (width < n_fragments) { width <<= 1; }
+  return width;
+}
+
+#define forSpanNodes(lower, upper, width, node, statement)                                 \
+  do {                                                                                     \
+    for (uint32_t l = (lower) + (width), r = (upper) + (width); l < r; l >>= 1, r >>= 1) { \
+      if (l & 1) {                                                                         \
+        const uint32_t node = l++;                                                         \
+        statement;                                                                         \
+      }                                                                                    \
+      if (r & 1) {                                                                         \
+        const uint32_t node = --r;                                                         \
+        statement;                                                                         \
+      }                                                                                    \
+    }                                                                                      \
+  } while (false)
+
+// A span is split over at most two nodes per level, and a fragment is under one node per
+// level, so the branches over a grown fragment are found in O(log n) plus their count.
+void index_spans(Relaxer *relaxer) {
+  const Allocator *allocator = relaxer->allocator;
+  const Fragment *fragments = relaxer->fragments;
+  const uint32_t n_fragments = relaxer->n_fragments;
+  const uint32_t width = span_width(n_fragments);
+  uint32_t *starts = allocator->realloc(relaxer->spanStarts, (2 * width + 1) * sizeof(uint32_t));
+  for (uint32_t k = 0; k <= 2 * width; k++) { starts[k] = 0; }
+  uint32_t lower = 0, upper = 0;
+  for (uint32_t i = 0; i < n_fragments; i++) {
+    if (!fragments[i].forms) { continue; }
+    span_bounds(&fragments[i], i, &lower, &upper);
+    forSpanNodes(lower, upper, width, node, starts[node + 1]++);
+  }
+  for (uint32_t k = 0; k < 2 * width; k++) { starts[k + 1] += starts[k]; }
+  uint32_t *branches =
+      allocator->realloc(relaxer->spanBranches, (starts[2 * width] + 1) * sizeof(uint32_t));
+  // `starts[k]` is the place of the next branch of node `k`, which ends at the start of
+  // node `k + 1`, so the starts are shifted back afterwards.
+  for (uint32_t i = 0; i < n_fragments; i++) {
+    if (!fragments[i].forms) { continue; }
+    span_bounds(&fragments[i], i, &lower, &upper);
+    forSpanNodes(lower, upper, width, node, branches[starts[node]++] = i);
+  }
+  for (uint32_t k = 2 * width; k > 0; k--) { starts[k] = starts[k - 1]; }
+  starts[0] = 0;
+  relaxer->spanStarts = starts;
+  relaxer->spanBranches = branches;
+}
+
+// Sizes never shrink, so the relaxation ends after at most one step per form of a branch.
+// When a branch grows, only the branches whose spans hold it are checked again, and they are
+// looked up in the span tree rather than among all the fragments.
+// Returns the count of grown branches, or -1 if a branch can not reach its target.
+int32_t Relaxer_relax(Relaxer *relaxer) {
+  const Allocator *allocator = relaxer->allocator;
+  const uint32_t n_fragments = relaxer->n_fragments;
+  Fragment *fragments = relaxer->fragments;
+  if (0 == n_fragments) { return 0; }
+  relaxer->worklist = allocator->realloc(relaxer->worklist, n_fragments * sizeof(uint32_t));
+  relaxer->queued = allocator->realloc(relaxer->queued, n_fragments * sizeof(bool));
+  uint32_t *worklist = relaxer->worklist;
+  bool *queued = relaxer->queued;
+
+  uint32_t head = 0, count = 0;
+  for (uint32_t i = 0; i < n_fragments; i++) {
+    queued[i] = fragments[i].forms && fragments[i].target <= n_fragments;
+    if (fragments[i].forms && !queued[i]) { return -1; }
+    if (queued[i]) { worklist[count++] = i; }
+  }
+  index_spans(relaxer);
+  const uint32_t width = span_width(n_fragments);
+
+  int32_t n_grown = 0;
+  while (count > 0) {
+    const uint32_t branch = worklist[head];
+    head = (head + 1) % n_fragments;
+    count--;
+    queued[branch] = false;
+
+    Fragment *fragment = &fragments[branch];
+    const uint32_t old_size = fragment->size;
+    int64_t disp = branch_disp(relaxer, branch);
+    while (disp < fragment->forms[fragment->form].min_disp ||
+           disp > fragment->forms[fragment->form].max_disp) {
+      if (fragment->form + 1 == fragment->n_forms) { return -1; }
+      const uint32_t size = fragment->forms[++fragment->form].size;
+      size_update(relaxer, branch, (int64_t) size - fragment->size);
+      fragment->size = size;
+      disp = branch_disp(relaxer, branch);
+    }
+    if (fragment->size == old_size) { continue; }
+    n_grown++;
+
+    for (uint32_t node = branch + width; node > 0; node >>= 1) {
+      const uint32_t end = relaxer->spanStarts[node + 1];
+      for (uint32_t k = relaxer->spanStarts[node]; k < end; k++) {
+        const uint32_t i = relaxer->spanBranches[k];
+        if (queued[i]) { continue; }
+        queued[i] = true;
+        worklist[(head + count) % n_fragments] = i;
+        count++;
+      }
+    }
+  }
+  return n_grown;
+}
+
+// Encodes every fragment with its relaxed form.
+// Returns the count of emitted bytes, or -1 if an encoder disagrees with its form's size.
+int64_t Relaxer_emit(Relaxer *relaxer, Array *buffer) {
+  int64_t total = 0;
+  for (uint32_t i = 0; i < relaxer->n_fragments; i++) {
+    const Fragment *fragment = &relaxer->fragments[i];
+    if (!fragment->encode) {
+      if (fragment->size) { return -1; }
+      continue;
+    }
+    const int64_t disp = fragment->forms ? branch_disp(relaxer, i) : 0;
+    const uint32_t size = fragment->encode(fragment->payload, fragment->form, disp, buffer);
+    if (size != fragment->size) { return -1; }
+    total += size;
+  }
+  return total;
+}
+
+void Relaxer_destroy(Relaxer *relaxer) {
+  const Allocator *allocator = relaxer->allocator;
+  if (relaxer->queued) { allocator->free(relaxer->queued); }
+  if (relaxer->worklist) { allocator->free(relaxer->worklist); }
+  if (relaxer->spanBranches) { allocator->free(relaxer->spanBranches); }
+  if (relaxer->spanStarts) { allocator->free(relaxer->spanStarts); }
+  allocator->free(relaxer->sizeTree);
+  allocator->free(relaxer->fragments);
+  allocator->free(relaxer);
+}
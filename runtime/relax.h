@@ -0,0 +1,71 @@
+/**
+ * Project Name: machine
+ * Module Name: runtime
+ * Filename: relax.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_RELAX_H
+#define MACHINE_RELAX_H
+
+#include "allocator.h"
+#include "array.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// A form a branch can be encoded with, from the narrowest to the widest.
+// `size` is the form's width in bytes (`FORM_SIZE` of its encoder), and a form reaches
+// displacements in [min_disp, max_disp], counted from the end of the branch.
+typedef struct RelaxForm {
+  uint32_t size;
+  int64_t min_disp;
+  int64_t max_disp;
+} RelaxForm;
+
+// Encodes a fragment with its chosen form, and returns the count of bytes it appended.
+typedef uint32_t fn_relax_encode(void *payload, uint32_t form, int64_t disp, Array *buffer);
+
+typedef struct Fragment {
+  void *payload;
+  fn_relax_encode *encode;
+  const RelaxForm *forms;  // nullptr for a fragment of a fixed size
+  uint32_t n_forms;
+  uint32_t form;
+  uint32_t target;
+  uint32_t size;
+} Fragment;
+
+typedef struct Relaxer {
+  const Allocator *allocator;
+  Fragment *fragments;
+  uint32_t n_fragments;
+  uint32_t capacity;
+  uint32_t *sizeTree;  // Fenwick tree over sizes, offsets are its prefix sums
+  uint32_t *worklist;
+  bool *queued;
+  // segment tree over the fragments: a branch is listed at the nodes which cover its span,
+  // node `k` lists `spanBranches[spanStarts[k]]` up to `spanBranches[spanStarts[k + 1]]`.
+  uint32_t *spanStarts;
+  uint32_t *spanBranches;
+} Relaxer;
+
+Relaxer *Relaxer_new(const Allocator *allocator);
+
+uint32_t Relaxer_addFixed(Relaxer *relaxer, uint32_t size, void *payload, fn_relax_encode *encode);
+uint32_t Relaxer_addBranch(
+    Relaxer *relaxer, const RelaxForm forms[], uint32_t n_forms, uint32_t target, void *payload,
+    fn_relax_encode *encode
+);
+void Relaxer_setTarget(Relaxer *relaxer, uint32_t branch, uint32_t target);
+
+int32_t Relaxer_relax(Relaxer *relaxer);
+
+uint32_t Relaxer_offsetOf(const Relaxer *relaxer, uint32_t fragment);
+
+int64_t Relaxer_emit(Relaxer *relaxer, Array *buffer);
+
+void Relaxer_destroy(Relaxer *relaxer);
+
+#endif  // MACHINE_RELAX_H
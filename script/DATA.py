@@ -25,3 +25,38 @@ TERMINALS = {
         "REGISTER": "register",
         "TERMINATOR": 0,
 }
+
+# C type and `Value` member of every token which carries a semantic value.
+# Small nodes are held by value, so reduces build them in place in the parse stack.
+VALUES = {
+        "IDENTIFIER": ("Identifier *", "identifier"),
+        "BIT_FIELD": ("BitField *", "bitField"),
+        "NUMBER": ("uint64_t", "number"),
+        "WIDTH": ("uint32_t", "width"),
+        "TIME_TICK": ("uint32_t", "tick"),
+        "MEM_KEY": ("uint32_t", "memKey"),
+        "PART_KEY": ("uint32_t", "partKey"),
+        "TYPE": ("uint32_t", "immType"),
+        "Entry": ("Entry", "entry"),
+        "InstrPart": ("InstrPart", "instrPart"),
+        "MappingItem": ("MappingItem", "mappingItem"),
+        "MemItem": ("MemItem", "memItem"),
+        "Entries": ("Entries *", "entries"),
+        "Evaluable": ("Evaluable *", "evaluable"),
+        "Immediate": ("Immediate *", "immediate"),
+        "InstrForm": ("InstrForm *", "instrForm"),
+        "InstrForms": ("InstrForms *", "instrForms"),
+        "InstrParts": ("InstrParts *", "instrParts"),
+        "Instruction": ("Instruction *", "instruction"),
+        "Layout": ("Layout *", "layout"),
+        "Machine": ("Machine *", "machine"),
+        "MappingItems": ("MappingItems *", "mappingItems"),
+        "Memory": ("Memory *", "memory"),
+        "Pattern": ("Pattern *", "pattern"),
+        "PatternArgs": ("PatternArgs *", "patternArgs"),
+        "Register": ("Register *", "reg"),
+        "RegisterGroup": ("RegisterGroup *", "registerGroup"),
+        "Registers": ("Registers *", "registers"),
+        "Set": ("Set *", "set"),
+        "SetItems": ("SetItems *", "setItems"),
+}
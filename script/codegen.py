@@ -122,15 +122,25 @@ class Action:
                 "}")
 
 
+def gen_values():
+    global tokens
+    members = ';\n    '.join([f"{VALUES[t][0]} {VALUES[t][1]}".replace('* ', '*')
+                               for t in tokens if t in VALUES]) + ';'
+    scalars = '\n    '.join([f"case enum_{t}: value.{VALUES[t][1]} = "
+                              + ('' if VALUES[t][0] == 'uint64_t' else f"({VALUES[t][0]}) ")
+                              + "(uint64_t) terminal->value; break;"
+                              for t in terminals if t in VALUES and not VALUES[t][0].endswith('*')])
+    content = Tp(get_temp_from("value.h.tpl")).substitute(members=members, scalars=scalars)
+    with open(OUT_DIR / "value.gen.h", 'w') as fp:
+        fp.write(content)
+
+
 def gen_reduces():
     global rules
     rule_names = rules.keys()
-    args = "(void * argv[], GContext *, const Allocator * allocator);"
+    args = "(Value argv[], Value *result, GContext *, const Allocator *allocator);"
     enum_reduces = sorted(f"{r} = {i}" for i, r in enumerate(rule_names))
-    reduces = sorted(f"{r.split('_')[0]} * p_{r}" + args
-                     if r != '__EXTEND_RULE__'
-                     else f"{GRAMMAR_TARGET} * p_{r}" + args
-                     for r in rule_names)
+    reduces = sorted(f"bool p_{r}" + args for r in rule_names)
     assign_reduces = sorted([f"[{r}] = (fn_reduce *) p_{r}" for r in rule_names])
     template = Tp(get_temp_from("reduce.h.tpl"))
     content = template.substitute(
@@ -199,5 +209,6 @@ if __name__ == '__main__':
     gen_token_enum()
     gen_token_name()
     gen_terminals()
+    gen_values()
     gen_reduces()
     gen_action_table()
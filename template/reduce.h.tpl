@@ -10,6 +10,7 @@
 
 #include "parse.h"
 #include "target.h"
+#include "value.gen.h"
 
 enum __PRODUCT_RULE_ENUM__ {
   ${enum_reduces}
@@ -0,0 +1,33 @@
+/**
+ * Project Name: machine
+ * Module Name: template
+ * Filename: value.gen.h
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_VALUE_GEN_H
+#define MACHINE_VALUE_GEN_H
+
+#include "target.h"
+#include "terminal.h"
+#include "tokens.gen.h"
+#include <stdint.h>
+
+typedef struct Value {
+  uint32_t type;
+  union {
+    void *pointer;
+    ${members}
+  };
+} Value;
+
+static inline Value Value_ofTerminal(const Terminal *terminal) {
+  Value value = {.type = terminal->type};
+  switch (terminal->type) {
+    ${scalars}
+    default: value.pointer = terminal->value; break;
+  }
+  return value;
+}
+
+#endif  // MACHINE_VALUE_GEN_H
@@ -0,0 +1,215 @@
+/**
+ * Project Name: machine
+ * Module Name: test/bench
+ * Filename: bench-vm.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "context.h"
+#include "jit.h"
+#include "parse.h"
+#include "roundtrip.h"
+#include "source.h"
+#include "target.h"
+#include "tokens.gen.h"
+#include "vm.h"
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_BENCH_ARGS 8
+
+typedef Operand FormArgs[MAX_BENCH_ARGS];
+
+// One way to encode a form, so every one of them is timed by the same loop.
+typedef uint32_t fn_bench_encode(
+    const void *encoder, uint32_t form, const Operand args[], Array *buffer
+);
+
+typedef struct BenchResult {
+  uint64_t n_encodes;
+  uint64_t n_bytes;
+  double ns;
+} BenchResult;
+
+uint32_t sample_operand(GContext *context, const Identifier *arg, Operand *operand);
+uint32_t sample_forms(const Machine *machine, FormArgs *samples, uint32_t n_forms);
+uint32_t bench_vm(const void *encoder, uint32_t form, const Operand args[], Array *buffer);
+uint32_t bench_jit(const void *encoder, uint32_t form, const Operand args[], Array *buffer);
+uint32_t bench_generated(const void *, uint32_t form, const Operand args[], Array *buffer);
+uint32_t check_jit(
+    const EncodingJIT *jit, const EncodingVM *vm, const FormArgs *samples, Array *buffer
+);
+BenchResult time_encoder(
+    fn_bench_encode *encode, const void *encoder, const EncodingVM *vm, const FormArgs *samples,
+    uint64_t rounds, Array *buffer
+);
+void print_result(const char *name, const BenchResult *result);
+
+// The first item an argument accepts: a register of a group or an item of a set.
+uint32_t sample_operand(GContext *context, const Identifier *arg, Operand *operand) {
+  const Record *record = GContext_findRecord(context, arg);
+  if (!record) { return 0; }
+  *operand = (Operand) {.type = record->offset, .value = 0};
+  if (enum_RegisterGroup == record->typeid) {
+    const RegisterGroup *grp = GContext_getRegisterGroup(context, record->offset);
+    const Register *regs = Array_real_addr(context->regArray, 0);
+    const Register *first = Array_vert2real(
+        context->regArray, *(REFER(Register) *) Array_real_addr(grp->registers, 0)
+    );
+    operand->type = first - regs;
+  } else if (enum_Set == record->typeid) {
+    const Set *set = GContext_getSet(context, record->offset);
+    const SetItem *items = Array_real_addr(set->items, 0);
+    return sample_operand(context, items[0].name, operand);
+  }
+  return 1;
+}
+
+uint32_t sample_forms(const Machine *machine, FormArgs *samples, uint32_t n_forms) {
+  uint32_t count = 0;
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t e = 0; e < n_entries; e++) {
+    const Entry *entry = Array_real_addr(machine->entries, e);
+    if (enum_Instruction != entry->type) { continue; }
+    const Instruction *instr = entry->target;
+    const InstrForm *forms = Array_real_addr(instr->forms, 0);
+    for (uint32_t i = 0; i < Array_length(instr->forms) && count < n_forms; i++, count++) {
+      PatternArgs *args = forms[i].pattern->args;
+      const uint32_t n_args = args ? Array_length(args) : 0;
+      for (uint32_t j = 0; j < n_args && j < MAX_BENCH_ARGS; j++) {
+        sample_operand(machine->context, Array_real_addr(args, j), &samples[count][j]);
+      }
+    }
+  }
+  return count;
+}
+
+uint32_t bench_vm(const void *encoder, uint32_t form, const Operand args[], Array *buffer) {
+  return EncodingVM_encode(encoder, form, args, buffer);
+}
+
+uint32_t bench_jit(const void *encoder, uint32_t form, const Operand args[], Array *buffer) {
+  return EncodingJIT_encode(encoder, form, args, buffer);
+}
+
+// The encoders `machine-gen` wrote for `reference.mm`, through the thunks of `test-roundtrip`.
+uint32_t bench_generated(const void *, uint32_t form, const Operand args[], Array *buffer) {
+  return ROUNDTRIP_FORMS[form].encode((const GenOperand *) args, buffer);
+}
+
+// The JIT has to give the bytes of the VM for every sample before it is timed.
+uint32_t check_jit(
+    const EncodingJIT *jit, const EncodingVM *vm, const FormArgs *samples, Array *buffer
+) {
+  const uint32_t n_forms = EncodingVM_countForms(vm);
+  uint32_t n_failed = 0;
+  for (uint32_t i = 0; i < n_forms; i++) {
+    Array_reset(buffer, nullptr);
+    const uint32_t size = EncodingVM_encode(vm, i, samples[i], buffer);
+    const uint32_t jit_size = EncodingJIT_encode(jit, i, samples[i], buffer);
+    const uint8_t *bytes = Array_real_addr(buffer, 0);
+    if (size != jit_size || (size && memcmp(bytes, bytes + size, size) != 0)) {
+      fprintf(stderr, "form %u: the JIT gives other bytes than the VM.\n", i);
+      n_failed++;
+    }
+  }
+  Array_reset(buffer, nullptr);
+  return n_failed;
+}
+
+// Encodes the sample of every form the VM can run `rounds` times.
+BenchResult time_encoder(
+    fn_bench_encode *encode, const void *encoder, const EncodingVM *vm, const FormArgs *samples,
+    uint64_t rounds, Array *buffer
+) {
+  const uint32_t n_forms = EncodingVM_countForms(vm);
+  const VMForm *forms = Array_real_addr(vm->forms, 0);
+  BenchResult result = {};
+  struct timespec start = {}, end = {};
+  timespec_get(&start, TIME_UTC);
+  for (uint64_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < n_forms; i++) {
+      if (VM_INVALID_FORM == forms[i].start) { continue; }
+      const uint32_t size = encode(encoder, i, samples[i], buffer);
+      result.n_bytes += size;
+      result.n_encodes += size ? 1 : 0;
+    }
+    Array_reset(buffer, nullptr);
+  }
+  timespec_get(&end, TIME_UTC);
+  const double seconds =
+      (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) * 1e-9;
+  result.ns = result.n_encodes ? seconds * 1e9 / (double) result.n_encodes : 0;
+  return result;
+}
+
+void print_result(const char *name, const BenchResult *result) {
+  printf(
+      "%-10s encodes: %" PRIu64 ", bytes: %" PRIu64 ", ns/encode: %.2f\n", name,
+      result->n_encodes, result->n_bytes, result->ns
+  );
+}
+
+// usage: bench-vm [--rounds=<n>] [<machine description>]
+// Encodes every form of the machine through the VM and the JIT, and reports the time of one
+// encoding of each. The JIT is checked against the VM first. The encoders generated from
+// `reference.mm`, the default machine, are timed on the same samples when the machine has
+// their forms.
+int main(int argc, char *argv[]) {
+  uint64_t rounds = 100000;
+  const char *path = ROUNDTRIP_MACHINE;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rounds=", 9) == 0) {
+      rounds = strtoull(argv[i] + 9, nullptr, 10);
+    } else {
+      path = argv[i];
+    }
+  }
+  if (0 == rounds) { return -1; }
+
+  uint32_t cost = 0, stage = 0;
+  Machine *machine = parse_file(path, &cost, &stage, nullptr, nullptr, &STDAllocator);
+  if (LOAD_READ == stage) { fprintf(stderr, "failed to read %s.\n", path); }
+  if (!machine) { return -1 - (int32_t) stage; }
+
+  EncodingVM *vm = EncodingVM_new(machine, &STDAllocator);
+  const uint32_t n_forms = EncodingVM_countForms(vm);
+  FormArgs *samples = STDAllocator.calloc(n_forms + 1, sizeof(FormArgs));
+  sample_forms(machine, samples, n_forms);
+  Array *buffer = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+
+  EncodingJIT *jit = EncodingJIT_new(vm);
+  const uint32_t n_failed = check_jit(jit, vm, samples, buffer);
+
+  printf("forms: %u\n", n_forms);
+  if (0 == n_failed) {
+    const BenchResult vm_result = time_encoder(bench_vm, vm, vm, samples, rounds, buffer);
+    print_result("vm", &vm_result);
+    const BenchResult jit_result = time_encoder(bench_jit, jit, vm, samples, rounds, buffer);
+    print_result("jit", &jit_result);
+    if (n_forms == ROUNDTRIP_N_FORMS) {
+      const BenchResult c_result =
+          time_encoder(bench_generated, nullptr, vm, samples, rounds, buffer);
+      print_result("generated", &c_result);
+    } else {
+      printf("generated  skipped, %s is not the machine of the encoders.\n", path);
+    }
+  }
+
+  releasePrimeArray(buffer);
+  STDAllocator.free(samples);
+  EncodingJIT_destroy(jit);
+  EncodingVM_destroy(vm);
+  releaseMachine(machine, &STDAllocator);
+  STDAllocator.free(machine);
+  return n_failed ? -5 : 0;
+}
@@ -0,0 +1,20 @@
+machine cxx {
+    register gpr [64-bit] {
+        r0: [63-0] = 0x0;
+        r1: [63-0] = 0x1;
+        r2: [63-0] = 0x2;
+        r3: [63-0] = 0x3;
+    };
+    immediate i8 [8-bit] signed;
+    immediate i32 [32-bit] signed;
+    instruction add {
+        [gpr, i8] = [3-byte] (1-tick) {
+            ^: [8] = 0x83;
+            ~: [16] = {
+                [2-0] = gpr[2-0],
+                [7-3] = 0x18,
+                [15-8] = i8
+            };
+        };
+    };
+};
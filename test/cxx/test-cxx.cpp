@@ -0,0 +1,47 @@
+/**
+ * Project Name: machine
+ * Module Name: test/cxx
+ * Filename: test-cxx.cpp
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "machine.hpp"
+#include <type_traits>
+
+// `add r1, -2` of `machine.mm`, encoded by the compiler.
+constexpr Entry MINUS_2 = IMM_i8((uint64_t) -2);
+constexpr auto ADD_R1 = encoding_add_0(REG_r1, &MINUS_2);
+static_assert(ADD_R1 == std::array<uint8_t, 3> {0x83, 0xC1, 0xFE});
+constexpr Entry MINUS_2_I32 = IMM_i32((uint64_t) -2);
+static_assert(encoding_add_0(REG_r1, &MINUS_2_I32) == ADD_R1);
+
+// Whether `IMM_i8(value)` is a constant, which it is not once the value is out of range.
+template <uint64_t value>
+concept builds_i8 = requires { typename std::integral_constant<uint64_t, IMM_i8(value).value>; };
+static_assert(builds_i8<(uint64_t) -128>);
+static_assert(!builds_i8<0x80>);
+
+// Whether `add reg, imm` is a constant, which it is not for operands of other kinds or out of
+// their range; raw values are not operands at all.
+template <const Entry *reg, const Entry *imm>
+concept encodes_add =
+    requires { typename std::integral_constant<uint8_t, encoding_add_0(reg, imm)[0]>; };
+template <typename T>
+concept takes_values = requires(T value) { encoding_add_0(value, value); };
+constexpr Entry WIDE = IMM_i32(0x12345);
+static_assert(encodes_add<REG_r1, &MINUS_2>);
+static_assert(!encodes_add<&MINUS_2, REG_r1>);
+static_assert(!encodes_add<REG_r1, &WIDE>);
+static_assert(!takes_values<uint64_t>);
+
+// The macros of the encoder bodies are not left to the files including the header.
+#if defined(UINT_N_MAX) || defined(numSetBits) || defined(pushInstrBytes)
+#error "machine.hpp leaks the macros of its encoders"
+#endif
+
+// Everything is checked by the compiler, building this file is the test.
+int main() {
+  return 0;
+}
@@ -49,7 +49,14 @@ int main() {
   //        get_name(terminals[i].type), terminals[i].value
   //    );
   //  }
-  const Machine *machine = parse(terminals, &cost, get_codegen, &STDAllocator);
+  Array *diagnostics = Array_new(sizeof(Diagnostic), -1, &STDAllocator);
+  const Machine *machine = parse(terminals, &cost, diagnostics, get_codegen, &STDAllocator);
+  const uint32_t n_diags = Array_length(diagnostics);
+  for (uint32_t i = 0; i < n_diags; i++) {
+    const Diagnostic *diag = Array_real_addr(diagnostics, i);
+    printf("error %u at <%u:%u>: %u.\n", diag->kind, diag->lineno, diag->column, diag->detail);
+  }
+  releasePrimeArray(diagnostics);
   if (!machine) {
     printf("failed to parse.\n");
     for (uint32_t i = cost; i < n_tokens; i++) {
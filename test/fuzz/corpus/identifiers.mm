@@ -0,0 +1,2 @@
+abcdefg hijklmn opqrst uvwxyz
+ABCDEFG HIJKLMN OPQRST UVWXYZ
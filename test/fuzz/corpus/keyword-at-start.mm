@@ -0,0 +1 @@
+signed
\ No newline at end of file
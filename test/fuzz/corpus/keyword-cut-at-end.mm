@@ -0,0 +1 @@
+machine abc { immediate i8 [8-bit] unsig
\ No newline at end of file
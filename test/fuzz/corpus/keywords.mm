@@ -0,0 +1 @@
+machine instruction immediate memory register set unsigned signed
@@ -0,0 +1 @@
+machine m { set s { a }; } r
\ No newline at end of file
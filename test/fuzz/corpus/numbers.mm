@@ -0,0 +1,2 @@
+0x123456 0x123456789abcdef0 0o1234567 0b101010101 1234567890
+[23-bit] [46-byte] [23] [12-23] [23-12] [...]
@@ -0,0 +1 @@
+re
\ No newline at end of file
@@ -0,0 +1,15 @@
+machine abc {
+    register ax [64-bit] {
+        rax: [63-0] = ;
+    };
+    memory local [12-bit] {
+        $: [0-5];
+        $: [6-11];
+    };
+    immediate refer [23-bit] unsigned;
+    instruction foo {
+        [refer, refer] = [2-byte] {
+            ~: [16] = refer.$;
+        };
+    };
+};
@@ -0,0 +1,152 @@
+/**
+ * Project Name: machine
+ * Module Name: test/fuzz
+ * Filename: fuzz-machine.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "generate.h"
+#include "parse.h"
+#include "target.h"
+#include "terminal.h"
+#include "tokenize.h"
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_INPUT_SIZE 0x10000
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+// Runs one input through `tokenize` and `parse` (with error recovery and the C codegen)
+// and releases everything it produced, so leaks show up under the sanitizers.
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  if (size >= MAX_INPUT_SIZE) { return 0; }
+  char_t *input = STDAllocator.malloc((size + 1) * sizeof(char_t));
+  memcpy(input, data, size);
+  input[size] = '\0';
+
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(input, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  const bool lexed = ('\0' == input[cost]) && n_tokens > 0;
+  STDAllocator.free(input);
+  if (!lexed) {
+    for (uint32_t i = 0; i < n_tokens; i++) {
+      releaseToken(terminals[i].value, terminals[i].type, &STDAllocator);
+    }
+    STDAllocator.free((void *) terminals);
+    return 0;
+  }
+
+  Array *diagnostics = Array_new(sizeof(Diagnostic), -1, &STDAllocator);
+  Machine *machine = parse(terminals, &cost, diagnostics, get_codegen, &STDAllocator);
+  releasePrimeArray(diagnostics);
+  if (machine) {
+    releaseMachine(machine, &STDAllocator);
+    STDAllocator.free(machine);
+  } else {
+    for (uint32_t i = cost; i < n_tokens; i++) {
+      releaseToken(terminals[i].value, terminals[i].type, &STDAllocator);
+    }
+  }
+  STDAllocator.free((void *) terminals);
+  return 0;
+}
+
+// Without libFuzzer the harness has its own driver: under AFL it runs in persistent mode,
+// otherwise it replays the inputs named on the command line and reports the throughput.
+#ifndef FUZZ_WITH_LIBFUZZER
+
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+__AFL_FUZZ_INIT();
+#endif
+
+typedef struct FuzzInput {
+  uint8_t *data;
+  size_t size;
+} FuzzInput;
+
+uint8_t *read_input_file(const char *path, size_t *size);
+
+// Reads one byte more than the harness accepts, so an input it would skip can be told apart.
+uint8_t *read_input_file(const char *path, size_t *size) {
+  FILE *pFile = fopen(path, "rb");
+  if (!pFile) { return nullptr; }
+  uint8_t *data = STDAllocator.malloc(MAX_INPUT_SIZE);
+  *size = fread(data, sizeof(uint8_t), MAX_INPUT_SIZE, pFile);
+  fclose(pFile);
+  return data;
+}
+
+// usage: fuzz-machine [--rounds=<n>] [--min-eps=<execs per second>] <input>...
+int main(int argc, char *argv[]) {
+#ifdef __AFL_FUZZ_TESTCASE_LEN
+  (void) argc;
+  (void) argv;
+  __AFL_INIT();
+  const uint8_t *afl_data = __AFL_FUZZ_TESTCASE_BUF;
+  while (__AFL_LOOP(10000)) { LLVMFuzzerTestOneInput(afl_data, __AFL_FUZZ_TESTCASE_LEN); }
+  return 0;
+#else
+  uint64_t rounds = 1000;
+  double min_eps = 0;
+  FuzzInput *inputs = STDAllocator.calloc(argc, sizeof(FuzzInput));
+  uint32_t n_inputs = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--rounds=", 9) == 0) {
+      rounds = strtoull(argv[i] + 9, nullptr, 10);
+    } else if (strncmp(argv[i], "--min-eps=", 10) == 0) {
+      min_eps = strtod(argv[i] + 10, nullptr);
+    } else {
+      inputs[n_inputs].data = read_input_file(argv[i], &inputs[n_inputs].size);
+      if (!inputs[n_inputs].data) {
+        fprintf(stderr, "failed to read %s.\n", argv[i]);
+        continue;
+      }
+      if (inputs[n_inputs].size >= MAX_INPUT_SIZE) {
+        fprintf(stderr, "%s is not under %u bytes, skipped.\n", argv[i], MAX_INPUT_SIZE);
+        STDAllocator.free(inputs[n_inputs].data);
+        continue;
+      }
+      n_inputs++;
+    }
+  }
+
+  struct timespec start = {}, end = {};
+  timespec_get(&start, TIME_UTC);
+  for (uint64_t r = 0; r < rounds; r++) {
+    for (uint32_t i = 0; i < n_inputs; i++) {
+      LLVMFuzzerTestOneInput(inputs[i].data, inputs[i].size);
+    }
+  }
+  timespec_get(&end, TIME_UTC);
+
+  const double seconds =
+      (double) (end.tv_sec - start.tv_sec) + (double) (end.tv_nsec - start.tv_nsec) * 1e-9;
+  const uint64_t execs = rounds * n_inputs;
+  const double eps = seconds > 0 ? (double) execs / seconds : 0;
+  printf(
+      "inputs: %u, execs: %" PRIu64 ", seconds: %.3f, execs/sec: %.0f\n", n_inputs, execs,
+      seconds, eps
+  );
+
+  for (uint32_t i = 0; i < n_inputs; i++) { STDAllocator.free(inputs[i].data); }
+  STDAllocator.free(inputs);
+  if (eps < min_eps) {
+    printf("throughput is under %.0f execs/sec.\n", min_eps);
+    return -1;
+  }
+  return 0;
+#endif
+}
+
+#endif  // FUZZ_WITH_LIBFUZZER
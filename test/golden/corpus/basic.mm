@@ -0,0 +1,25 @@
+machine abc {
+    register ax [64-bit] {
+        rax: [63-0] = 0x00;
+        eax: [31-0] = 0x00;
+        ah : [15-8] = 0x04;
+        al : [7-0]  = 0x00;
+    };
+    memory local [12-bit] {
+        $: [0-5];
+        >: [6-11];
+    };
+    immediate refer [23-bit] unsigned;
+    set reg { rax, eax };
+    instruction foo {
+        [rax, local] = [10-byte] (4-tick) {
+            ^: [8] = 0x12;
+            &: [8] = local.$;
+            ~: [32] = {
+                [0-5] = 0x34,
+                [31-24] = rax[13-20],
+                [...] = 0
+            };
+        };
+    };
+};
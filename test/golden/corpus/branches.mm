@@ -0,0 +1,36 @@
+machine branches {
+    register gpr [32-bit] {
+        r0: [31-0] = 0x0;
+        r1: [31-0] = 0x1;
+        r2: [31-0] = 0x2;
+        r3: [31-0] = 0x3;
+    };
+    immediate rel8 [8-bit] signed;
+    immediate rel32 [32-bit] signed;
+    set rel { rel8, rel32 };
+    instruction jmp {
+        [rel8] = [2-byte] (1-tick) {
+            ^: [8] = 0xEB;
+            ~: [8] = rel8;
+        };
+        [rel32] = [5-byte] (1-tick) {
+            ^: [8] = 0xE9;
+            ~: [32] = rel32;
+        };
+    };
+    instruction jr {
+        [gpr] = [2-byte] (2-tick) {
+            ^: [8] = 0xFF;
+            ~: [8] = {
+                [1-0] = gpr[1-0],
+                [7-2] = 0x38
+            };
+        };
+    };
+    instruction call {
+        [rel] = [5-byte] (3-tick) {
+            ^: [8] = 0xE8;
+            ~: [32] = rel;
+        };
+    };
+};
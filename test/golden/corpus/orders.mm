@@ -0,0 +1,43 @@
+machine orders {
+    register gpr [32-bit] {
+        r0: [31-0] = 0x0;
+        r1: [31-0] = 0x1;
+        r2: [31-0] = 0x2;
+        r3: [31-0] = 0x3;
+    };
+    memory frame [16-bit] {
+        $: [0-3];
+        >: [4-15];
+    };
+    immediate u16 [16-bit] unsigned;
+    instruction movw {
+        [gpr, u16] = [4-byte-be] (1-tick) {
+            ~: [32] = {
+                [31-24] = 0x12,
+                [17-16] = gpr[1-0],
+                [15-0] = u16,
+                [...] = 0
+            };
+        };
+    };
+    instruction bl {
+        [u16] = [4-byte-hw] (2-tick) {
+            ~: [32] = {
+                [31-27] = 0x1E,
+                [15-0] = u16,
+                [...] = 0
+            };
+        };
+    };
+    instruction ldr {
+        [gpr, frame] = [4-byte] (3-tick) {
+            ~: [32] = {
+                [1-0] = gpr[1-0],
+                [7-4] = frame.$,
+                [19-8] = frame.>,
+                [31-24] = 0xB9,
+                [...] = 0
+            };
+        };
+    };
+};
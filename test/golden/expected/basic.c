@@ -0,0 +1,143 @@
+/**
+ * Filename: basic.c
+ *
+ * This file is generated by xMachine, adopts the MIT License:
+ *      MIT License
+ *      Copyright (c) 2024 xMachine
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a copy
+ *      of this software and associated documentation files (the "Software"), to deal
+ *      in the Software without restriction, including without limitation the rights
+ *      to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *      copies of the Software, and to permit persons to whom the Software is
+ *      furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all
+ *      copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *      FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *      AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *      SOFTWARE.
+ *
+ * *The following appendix is not included in the License.*
+ *
+ * Appendix
+ * ==================== xMachine =======================
+ * xMachine - A Backend Generator for Compilers
+ * xMachine adopts the GNU AFFERO GENERAL PUBLIC LICENSE.
+ * Copyright (c) 2024 Yaokai Liu. All rights reserved.
+ * =====================================================
+ *
+ **/
+#include "basic.h"
+
+const uint64_t SET_reg[] = {
+  [enum_REG_rax] = 0x0,
+  [enum_REG_eax] = 0x0,
+};
+[[maybe_unused]] static bool SET_reg_has(const Entry *e) {
+  if (e->kind != ENTRY_REGISTER) { return false; }
+  switch (e->type) {
+    case enum_REG_rax:
+    case enum_REG_eax:
+      return true;
+  }
+  return false;
+}
+
+const FormTiming FORM_TIMING[] = {
+  [enum_FORM_foo_0] = {.latency = 4},
+};
+
+const uint8_t FORM_SIZE[] = {
+  [enum_FORM_foo_0] = 10,
+};
+
+const char NAME_POOL[] =
+    "ah\0"
+    "local\0"
+    "foo\0"
+    "refer\0"
+    "eax\0"
+    "rax\0"
+    ;
+
+const uint32_t REG_NAME[] = {
+  [enum_REG_rax] = 23,
+  [enum_REG_eax] = 19,
+  [enum_REG_ah] = 0,
+  [enum_REG_al] = 6,
+};
+
+const uint32_t MEM_NAME[] = {
+  [enum_MEM_local] = 3,
+};
+
+const uint32_t IMM_NAME[] = {
+  [enum_IMM_refer] = 13,
+};
+
+const uint32_t FORM_OP[] = {
+  [enum_FORM_foo_0] = 9,
+};
+
+typedef struct {
+  uint32_t offset;
+  uint32_t kind;
+  uint32_t id;
+} NameSlot;
+static const int32_t NAME_SEEDS[4] = {
+   1, 1, -1, -7,
+};
+static const NameSlot NAME_SLOTS[7] = {
+  {0, NAME_REGISTER, enum_REG_ah},
+  {3, NAME_MEMORY, enum_MEM_local},
+  {23, NAME_REGISTER, enum_REG_rax},
+  {13, NAME_IMMEDIATE, enum_IMM_refer},
+  {6, NAME_REGISTER, enum_REG_al},
+  {19, NAME_REGISTER, enum_REG_eax},
+  {9, NAME_INSTRUCTION, enum_FORM_foo_0},
+};
+static uint32_t NAME_hash(uint32_t kind, const char *name, uint32_t seed) {
+  uint32_t hash = (0x811C9DC5U ^ seed) + kind;
+  for (; *name; name++) { hash = (hash ^ (uint8_t) *name) * 0x01000193U; }
+  hash ^= hash >> 15;
+  hash *= 0x2C1B3C6DU;
+  return hash ^ (hash >> 12);
+}
+uint32_t NAME_lookup(uint32_t kind, const char *name) {
+  const int32_t seed = NAME_SEEDS[NAME_hash(kind, name, 0) % 4];
+  const NameSlot *slot = &NAME_SLOTS[
+      seed < 0 ? (uint32_t) (-seed - 1) : NAME_hash(kind, name, seed) % 7
+  ];
+  const char *entry = NAME_POOL + slot->offset;
+  while (*name && *name == *entry) {
+    name++;
+    entry++;
+  }
+  return (slot->kind == kind && *name == *entry) ? slot->id : UINT32_MAX;
+}
+
+uint32_t encoding_foo_0(uint64_t rax, uint64_t local, Array *buffer){
+  const uint32_t size = 10;
+  uint8_t bytes[10 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  (void) rax;
+  pushEncodingNumber(0x12, 1);
+  number = numSetBits(number, 0, 6, 0x34);
+  number = numSetBits(number, 6, 24, 0);
+  number = numSetBits(number, 24, 32, (0x0 >> 13) & UINT_N_MAX(8));
+  pushInstrBytes(4);
+  pushEncodingNumber((local >> 0) & UINT_N_MAX(6), 1);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_foo_rm(const Entry *a0, const Entry *a1, Array *buffer) {
+  if (a0->kind == ENTRY_REGISTER && a0->type == enum_REG_rax && a1->kind == ENTRY_MEMORY && a1->type == enum_MEM_local) { return encoding_foo_0(a0->value, a1->value, buffer); }
+  return 0;
+}
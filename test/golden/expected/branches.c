@@ -0,0 +1,191 @@
+/**
+ * Filename: branches.c
+ *
+ * This file is generated by xMachine, adopts the MIT License:
+ *      MIT License
+ *      Copyright (c) 2024 xMachine
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a copy
+ *      of this software and associated documentation files (the "Software"), to deal
+ *      in the Software without restriction, including without limitation the rights
+ *      to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *      copies of the Software, and to permit persons to whom the Software is
+ *      furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all
+ *      copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *      FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *      AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *      SOFTWARE.
+ *
+ * *The following appendix is not included in the License.*
+ *
+ * Appendix
+ * ==================== xMachine =======================
+ * xMachine - A Backend Generator for Compilers
+ * xMachine adopts the GNU AFFERO GENERAL PUBLIC LICENSE.
+ * Copyright (c) 2024 Yaokai Liu. All rights reserved.
+ * =====================================================
+ *
+ **/
+#include "branches.h"
+
+const uint64_t SET_rel[] = {
+  [enum_IMM_rel8] = UINT_N_MAX(8),
+  [enum_IMM_rel32] = UINT_N_MAX(32),
+};
+[[maybe_unused]] static bool SET_rel_has(const Entry *e) {
+  if (e->kind != ENTRY_IMMEDIATE) { return false; }
+  switch (e->type) {
+    case enum_IMM_rel8:
+    case enum_IMM_rel32:
+      return true;
+  }
+  return false;
+}
+
+const FormTiming FORM_TIMING[] = {
+  [enum_FORM_jmp_0] = {.latency = 1},
+  [enum_FORM_jmp_1] = {.latency = 1},
+  [enum_FORM_jr_0] = {.latency = 2},
+  [enum_FORM_call_0] = {.latency = 3},
+};
+
+const uint8_t FORM_SIZE[] = {
+  [enum_FORM_jmp_0] = 2,
+  [enum_FORM_jmp_1] = 5,
+  [enum_FORM_jr_0] = 2,
+  [enum_FORM_call_0] = 5,
+};
+
+const char NAME_POOL[] =
+    "r0\0"
+    "r1\0"
+    "rel32\0"
+    "r2\0"
+    "r3\0"
+    "rel8\0"
+    "call\0"
+    "jmp\0"
+    "jr\0"
+    ;
+
+const uint32_t REG_NAME[] = {
+  [enum_REG_r0] = 0,
+  [enum_REG_r1] = 3,
+  [enum_REG_r2] = 12,
+  [enum_REG_r3] = 15,
+};
+
+const uint32_t IMM_NAME[] = {
+  [enum_IMM_rel8] = 18,
+  [enum_IMM_rel32] = 6,
+};
+
+const uint32_t FORM_OP[] = {
+  [enum_FORM_jmp_0] = 28,
+  [enum_FORM_jmp_1] = 28,
+  [enum_FORM_jr_0] = 32,
+  [enum_FORM_call_0] = 23,
+};
+
+typedef struct {
+  uint32_t offset;
+  uint32_t kind;
+  uint32_t id;
+} NameSlot;
+static const int32_t NAME_SEEDS[5] = {
+   2, -1, 2, 0, 2,
+};
+static const NameSlot NAME_SLOTS[9] = {
+  {0, NAME_REGISTER, enum_REG_r0},
+  {32, NAME_INSTRUCTION, enum_FORM_jr_0},
+  {18, NAME_IMMEDIATE, enum_IMM_rel8},
+  {6, NAME_IMMEDIATE, enum_IMM_rel32},
+  {23, NAME_INSTRUCTION, enum_FORM_call_0},
+  {3, NAME_REGISTER, enum_REG_r1},
+  {15, NAME_REGISTER, enum_REG_r3},
+  {12, NAME_REGISTER, enum_REG_r2},
+  {28, NAME_INSTRUCTION, enum_FORM_jmp_0},
+};
+static uint32_t NAME_hash(uint32_t kind, const char *name, uint32_t seed) {
+  uint32_t hash = (0x811C9DC5U ^ seed) + kind;
+  for (; *name; name++) { hash = (hash ^ (uint8_t) *name) * 0x01000193U; }
+  hash ^= hash >> 15;
+  hash *= 0x2C1B3C6DU;
+  return hash ^ (hash >> 12);
+}
+uint32_t NAME_lookup(uint32_t kind, const char *name) {
+  const int32_t seed = NAME_SEEDS[NAME_hash(kind, name, 0) % 5];
+  const NameSlot *slot = &NAME_SLOTS[
+      seed < 0 ? (uint32_t) (-seed - 1) : NAME_hash(kind, name, seed) % 9
+  ];
+  const char *entry = NAME_POOL + slot->offset;
+  while (*name && *name == *entry) {
+    name++;
+    entry++;
+  }
+  return (slot->kind == kind && *name == *entry) ? slot->id : UINT32_MAX;
+}
+
+uint32_t encoding_jmp_0(uint64_t rel8, Array *buffer){
+  const uint32_t size = 2;
+  uint8_t bytes[2 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  pushEncodingNumber(0xEB, 1);
+  pushEncodingNumber(rel8, 1);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encoding_jmp_1(uint64_t rel32, Array *buffer){
+  const uint32_t size = 5;
+  uint8_t bytes[5 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  pushEncodingNumber(0xE9, 1);
+  pushEncodingNumber(rel32, 4);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_jmp_i(const Entry *a0, Array *buffer) {
+  if (a0->kind == ENTRY_IMMEDIATE && IMM_rel8_fits(IMM_value(a0))) { return encoding_jmp_0(IMM_value(a0), buffer); }
+  if (a0->kind == ENTRY_IMMEDIATE && IMM_rel32_fits(IMM_value(a0))) { return encoding_jmp_1(IMM_value(a0), buffer); }
+  return 0;
+}
+uint32_t encoding_jr_0(uint64_t gpr, Array *buffer){
+  const uint32_t size = 2;
+  uint8_t bytes[2 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  pushEncodingNumber(0xFF, 1);
+  number = numSetBits(number, 0, 2, (REG_code(gpr) >> 0) & UINT_N_MAX(2));
+  number = numSetBits(number, 2, 8, 0x38);
+  pushInstrBytes(1);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_jr_r(const Entry *a0, Array *buffer) {
+  if (a0->kind == ENTRY_REGISTER && (a0->type == enum_REG_r0 || a0->type == enum_REG_r1 || a0->type == enum_REG_r2 || a0->type == enum_REG_r3)) { return encoding_jr_0(a0->value, buffer); }
+  return 0;
+}
+uint32_t encoding_call_0(const Entry *rel, Array *buffer){
+  const uint32_t size = 5;
+  uint8_t bytes[5 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  if (!SET_rel_has(rel)) { return 0; }
+  pushEncodingNumber(0xE8, 1);
+  pushEncodingNumber(IMM_value(rel), 4);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_call_i(const Entry *a0, Array *buffer) {
+  if (a0->kind == ENTRY_IMMEDIATE && ((a0->type == enum_IMM_rel8 && IMM_rel8_fits(IMM_value(a0))) || (a0->type == enum_IMM_rel32 && IMM_rel32_fits(IMM_value(a0))))) { return encoding_call_0(a0, buffer); }
+  return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * Filename: orders.c
+ *
+ * This file is generated by xMachine, adopts the MIT License:
+ *      MIT License
+ *      Copyright (c) 2024 xMachine
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a copy
+ *      of this software and associated documentation files (the "Software"), to deal
+ *      in the Software without restriction, including without limitation the rights
+ *      to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *      copies of the Software, and to permit persons to whom the Software is
+ *      furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all
+ *      copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *      FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *      AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *      SOFTWARE.
+ *
+ * *The following appendix is not included in the License.*
+ *
+ * Appendix
+ * ==================== xMachine =======================
+ * xMachine - A Backend Generator for Compilers
+ * xMachine adopts the GNU AFFERO GENERAL PUBLIC LICENSE.
+ * Copyright (c) 2024 Yaokai Liu. All rights reserved.
+ * =====================================================
+ *
+ **/
+#include "orders.h"
+
+
+const FormTiming FORM_TIMING[] = {
+  [enum_FORM_movw_0] = {.latency = 1},
+  [enum_FORM_bl_0] = {.latency = 2},
+  [enum_FORM_ldr_0] = {.latency = 3},
+};
+
+const uint8_t FORM_SIZE[] = {
+  [enum_FORM_movw_0] = 4,
+  [enum_FORM_bl_0] = 4,
+  [enum_FORM_ldr_0] = 4,
+};
+
+const char NAME_POOL[] =
+    "r0\0"
+    "r1\0"
+    "r2\0"
+    "r3\0"
+    "u16\0"
+    "frame\0"
+    "bl\0"
+    "ldr\0"
+    "movw\0"
+    ;
+
+const uint32_t REG_NAME[] = {
+  [enum_REG_r0] = 0,
+  [enum_REG_r1] = 3,
+  [enum_REG_r2] = 6,
+  [enum_REG_r3] = 9,
+};
+
+const uint32_t MEM_NAME[] = {
+  [enum_MEM_frame] = 16,
+};
+
+const uint32_t IMM_NAME[] = {
+  [enum_IMM_u16] = 12,
+};
+
+const uint32_t FORM_OP[] = {
+  [enum_FORM_movw_0] = 29,
+  [enum_FORM_bl_0] = 22,
+  [enum_FORM_ldr_0] = 25,
+};
+
+typedef struct {
+  uint32_t offset;
+  uint32_t kind;
+  uint32_t id;
+} NameSlot;
+static const int32_t NAME_SEEDS[5] = {
+   2, 5, 4, 0, -8,
+};
+static const NameSlot NAME_SLOTS[9] = {
+  {22, NAME_INSTRUCTION, enum_FORM_bl_0},
+  {29, NAME_INSTRUCTION, enum_FORM_movw_0},
+  {12, NAME_IMMEDIATE, enum_IMM_u16},
+  {25, NAME_INSTRUCTION, enum_FORM_ldr_0},
+  {3, NAME_REGISTER, enum_REG_r1},
+  {16, NAME_MEMORY, enum_MEM_frame},
+  {9, NAME_REGISTER, enum_REG_r3},
+  {6, NAME_REGISTER, enum_REG_r2},
+  {0, NAME_REGISTER, enum_REG_r0},
+};
+static uint32_t NAME_hash(uint32_t kind, const char *name, uint32_t seed) {
+  uint32_t hash = (0x811C9DC5U ^ seed) + kind;
+  for (; *name; name++) { hash = (hash ^ (uint8_t) *name) * 0x01000193U; }
+  hash ^= hash >> 15;
+  hash *= 0x2C1B3C6DU;
+  return hash ^ (hash >> 12);
+}
+uint32_t NAME_lookup(uint32_t kind, const char *name) {
+  const int32_t seed = NAME_SEEDS[NAME_hash(kind, name, 0) % 5];
+  const NameSlot *slot = &NAME_SLOTS[
+      seed < 0 ? (uint32_t) (-seed - 1) : NAME_hash(kind, name, seed) % 9
+  ];
+  const char *entry = NAME_POOL + slot->offset;
+  while (*name && *name == *entry) {
+    name++;
+    entry++;
+  }
+  return (slot->kind == kind && *name == *entry) ? slot->id : UINT32_MAX;
+}
+
+uint32_t encoding_movw_0(uint64_t gpr, uint64_t u16, Array *buffer){
+  const uint32_t size = 4;
+  uint8_t bytes[4 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  number = numSetBits(number, 0, 16, u16);
+  number = numSetBits(number, 16, 18, (REG_code(gpr) >> 0) & UINT_N_MAX(2));
+  number = numSetBits(number, 18, 24, 0);
+  number = numSetBits(number, 24, 32, 0x12);
+  pushInstrBytesBE(4);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_movw_ri(const Entry *a0, const Entry *a1, Array *buffer) {
+  if (a0->kind == ENTRY_REGISTER && (a0->type == enum_REG_r0 || a0->type == enum_REG_r1 || a0->type == enum_REG_r2 || a0->type == enum_REG_r3) && a1->kind == ENTRY_IMMEDIATE && IMM_u16_fits(IMM_value(a1))) { return encoding_movw_0(a0->value, IMM_value(a1), buffer); }
+  return 0;
+}
+uint32_t encoding_bl_0(uint64_t u16, Array *buffer){
+  const uint32_t size = 4;
+  uint8_t bytes[4 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  number = numSetBits(number, 0, 16, u16);
+  number = numSetBits(number, 16, 27, 0);
+  number = numSetBits(number, 27, 32, 0x1E);
+  pushInstrBytesHW(4);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_bl_i(const Entry *a0, Array *buffer) {
+  if (a0->kind == ENTRY_IMMEDIATE && IMM_u16_fits(IMM_value(a0))) { return encoding_bl_0(IMM_value(a0), buffer); }
+  return 0;
+}
+uint32_t encoding_ldr_0(uint64_t gpr, uint64_t frame, Array *buffer){
+  const uint32_t size = 4;
+  uint8_t bytes[4 + sizeof(uint64_t)] = {};
+  uint64_t number = 0;
+  uint32_t index = 0;
+  number = numSetBits(number, 0, 2, (REG_code(gpr) >> 0) & UINT_N_MAX(2));
+  number = numSetBits(number, 2, 4, 0);
+  number = numSetBits(number, 4, 8, (frame >> 0) & UINT_N_MAX(4));
+  number = numSetBits(number, 8, 20, (frame >> 4) & UINT_N_MAX(12));
+  number = numSetBits(number, 20, 24, 0);
+  number = numSetBits(number, 24, 32, 0xB9);
+  pushInstrBytes(4);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+uint32_t encode_ldr_rm(const Entry *a0, const Entry *a1, Array *buffer) {
+  if (a0->kind == ENTRY_REGISTER && (a0->type == enum_REG_r0 || a0->type == enum_REG_r1 || a0->type == enum_REG_r2 || a0->type == enum_REG_r3) && a1->kind == ENTRY_MEMORY && a1->type == enum_MEM_frame) { return encoding_ldr_0(a0->value, a1->value, buffer); }
+  return 0;
+}
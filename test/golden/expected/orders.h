@@ -0,0 +1,285 @@
+/**
+ * Filename: orders.h
+ *
+ * This file is generated by xMachine, adopts the MIT License:
+ *      MIT License
+ *      Copyright (c) 2024 xMachine
+ *
+ *      Permission is hereby granted, free of charge, to any person obtaining a copy
+ *      of this software and associated documentation files (the "Software"), to deal
+ *      in the Software without restriction, including without limitation the rights
+ *      to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *      copies of the Software, and to permit persons to whom the Software is
+ *      furnished to do so, subject to the following conditions:
+ *
+ *      The above copyright notice and this permission notice shall be included in all
+ *      copies or substantial portions of the Software.
+ *
+ *      THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *      IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *      FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *      AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *      LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *      OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *      SOFTWARE.
+ *
+ * *The following appendix is not included in the License.*
+ *
+ * Appendix
+ * ==================== xMachine =======================
+ * xMachine - A Backend Generator for Compilers
+ * xMachine adopts the GNU AFFERO GENERAL PUBLIC LICENSE.
+ * Copyright (c) 2024 Yaokai Liu. All rights reserved.
+ * =====================================================
+ *
+ **/
+#ifndef MACHINE_ORDERS_H
+#define MACHINE_ORDERS_H
+
+#include "array.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <assert.h>
+#include <string.h>
+#define min(a, b)             (((a) < (b)) ? (a) : (b))
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define TO_LE64(val) __builtin_bswap64(val)
+#define TO_BE64(val) (val)
+#else
+#define TO_LE64(val) (val)
+#define TO_BE64(val) __builtin_bswap64(val)
+#endif
+#define storeInstrBytes(word, _count)               \
+  do {                                              \
+    const uint64_t stored = (word);                 \
+    memcpy(&bytes[index], &stored, sizeof(stored)); \
+    index = min((_count) + index, size);            \
+    number = 0;                                     \
+  } while (false)
+#define pushInstrBytes(_count) storeInstrBytes(TO_LE64(number), _count)
+#define pushInstrBytesBE(_count) \
+  storeInstrBytes(TO_BE64(number << (64 - 8 * (_count))), _count)
+#define pushInstrBytesHW(_count)                                   \
+  storeInstrBytes(                                                \
+      TO_LE64(HALFWORDS_REVERSE64(number << (64 - 8 * (_count)))), \
+      _count                                                       \
+  )
+#define UINT_N_MAX(n_bits) \
+  ((n_bits) >= 64 ? ~0LLU : (1LLU << (n_bits)) - 1)
+#define LOW_BITS(val, n_bits) ((val) & UINT_N_MAX(n_bits))
+#define MASK_BITS(bl, bu)     (UINT_N_MAX(bu) - UINT_N_MAX(bl))
+#define FITS_UNSIGNED(val, n_bits) \
+  (((uint64_t) (val) & ~UINT_N_MAX(n_bits)) == 0)
+#define FITS_SIGNED(val, n_bits) \
+  ((uint64_t) (val) + (1LLU << ((n_bits) - 1)) <= UINT_N_MAX(n_bits))
+#define SIGN_EXTEND(val, n_bits) \
+  ((int64_t) ((uint64_t) (val) << (64 - (n_bits))) >> (64 - (n_bits)))
+#define numSetBits(num, bl, bu, val) \
+  (((num) & ~MASK_BITS(bl, bu)) | (LOW_BITS(val, (bu) - (bl)) << (bl)))
+#define HALFWORDS_REVERSE64(val)                             \
+  ((((val) >> 48) & 0xFFFF) | (((val) >> 16) & 0xFFFF0000) | \
+   (((val) & 0xFFFF0000) << 16) | ((val) << 48))
+#define setEncodingNumber(val) \
+  do { number = (val); } while (false)
+#define pushEncodingNumber(val, count) \
+  do {                                 \
+    setEncodingNumber(val);            \
+    pushInstrBytes(count);             \
+  } while (false)
+#define pushEncodingNumberBE(val, count) \
+  do {                                   \
+    setEncodingNumber(val);              \
+    pushInstrBytesBE(count);             \
+  } while (false)
+#define pushEncodingNumberHW(val, count) \
+  do {                                   \
+    setEncodingNumber(val);              \
+    pushInstrBytesHW(count);             \
+  } while (false)
+
+enum { ENTRY_REGISTER = 1, ENTRY_MEMORY, ENTRY_IMMEDIATE };
+typedef struct {
+  uint32_t kind;
+  uint32_t type;
+  uint64_t value;
+} Entry;
+typedef struct {
+  uint8_t base_lower;
+  uint8_t base_width;
+  uint8_t offset_lower;
+  uint8_t offset_width;
+} MemLayout;
+
+enum {
+  enum_REG_r0 = 0,
+  enum_REG_r1 = 1,
+  enum_REG_r2 = 2,
+  enum_REG_r3 = 3,
+  REGISTER_ID_COUNT = 4,
+};
+
+enum {
+  enum_MEM_frame = 0,
+  MEMORY_ID_COUNT = 1,
+};
+
+enum {
+  enum_IMM_u16 = 0,
+  IMMEDIATE_ID_COUNT = 1,
+};
+
+enum {
+  enum_FORM_movw_0,
+  enum_FORM_bl_0,
+  enum_FORM_ldr_0,
+};
+
+enum {
+  NAME_REGISTER,
+  NAME_MEMORY,
+  NAME_IMMEDIATE,
+  NAME_INSTRUCTION,
+};
+extern const char NAME_POOL[];
+extern const uint32_t REG_NAME[];
+static inline const char *REG_name(uint32_t id) { return NAME_POOL + REG_NAME[id]; }
+extern const uint32_t MEM_NAME[];
+static inline const char *MEM_name(uint32_t id) { return NAME_POOL + MEM_NAME[id]; }
+extern const uint32_t IMM_NAME[];
+static inline const char *IMM_name(uint32_t id) { return NAME_POOL + IMM_NAME[id]; }
+extern const uint32_t FORM_OP[];
+static inline const char *FORM_op(uint32_t id) { return NAME_POOL + FORM_OP[id]; }
+// The id of `name` among the items of `kind`, the first form of an
+// instruction, or `UINT32_MAX` for a name which is not one of them.
+uint32_t NAME_lookup(uint32_t kind, const char *name);
+
+typedef struct {
+  uint32_t latency;
+} FormTiming;
+extern const FormTiming FORM_TIMING[];
+extern const uint8_t FORM_SIZE[];
+
+static inline uint32_t FORM_latency(uint32_t form) {
+  return FORM_TIMING[form].latency;
+}
+
+// Picks the candidate to issue at `cycle`: the ready one with the longest latency.
+// Returns `n` if no candidate is ready.
+static inline uint32_t schedulePick(
+    const uint32_t forms[], const uint32_t ready_at[], uint32_t n, uint32_t cycle
+) {
+  uint32_t picked = n, latency = 0;
+  for (uint32_t i = 0; i < n; i++) {
+    const FormTiming timing = FORM_TIMING[forms[i]];
+    if (ready_at[i] > cycle) { continue; }
+    if (picked == n || timing.latency > latency) {
+      picked = i;
+      latency = timing.latency;
+    }
+  }
+  return picked;
+}
+
+#define REGISTER_TABLE_SIZE REGISTER_ID_COUNT
+static const struct {
+  uint64_t code[REGISTER_TABLE_SIZE];
+  uint64_t mask[REGISTER_TABLE_SIZE];
+  uint16_t group[REGISTER_TABLE_SIZE];
+  uint16_t width[REGISTER_TABLE_SIZE];
+} REGISTER_TABLE = {
+  .code = {
+    [enum_REG_r0] = 0x0,
+    [enum_REG_r1] = 0x1,
+    [enum_REG_r2] = 0x2,
+    [enum_REG_r3] = 0x3,
+  },
+  .mask = {
+    [enum_REG_r0] = 0xFFFFFFFF,
+    [enum_REG_r1] = 0xFFFFFFFF,
+    [enum_REG_r2] = 0xFFFFFFFF,
+    [enum_REG_r3] = 0xFFFFFFFF,
+  },
+  .group = {
+    [enum_REG_r0] = 0x0,
+    [enum_REG_r1] = 0x0,
+    [enum_REG_r2] = 0x0,
+    [enum_REG_r3] = 0x0,
+  },
+  .width = {
+    [enum_REG_r0] = 0x20,
+    [enum_REG_r1] = 0x20,
+    [enum_REG_r2] = 0x20,
+    [enum_REG_r3] = 0x20,
+  },
+};
+static inline uint64_t REG_code(uint32_t reg) { return REGISTER_TABLE.code[reg]; }
+static inline uint64_t REG_mask(uint32_t reg) { return REGISTER_TABLE.mask[reg]; }
+static inline uint16_t REG_group(uint32_t reg) { return REGISTER_TABLE.group[reg]; }
+static inline uint16_t REG_width(uint32_t reg) { return REGISTER_TABLE.width[reg]; }
+static const Entry Entry_REG_r0 = {
+  .kind = ENTRY_REGISTER,
+  .type = enum_REG_r0,
+  .value = enum_REG_r0,
+};
+static const Entry *const REG_r0 = &Entry_REG_r0;
+static const Entry Entry_REG_r1 = {
+  .kind = ENTRY_REGISTER,
+  .type = enum_REG_r1,
+  .value = enum_REG_r1,
+};
+static const Entry *const REG_r1 = &Entry_REG_r1;
+static const Entry Entry_REG_r2 = {
+  .kind = ENTRY_REGISTER,
+  .type = enum_REG_r2,
+  .value = enum_REG_r2,
+};
+static const Entry *const REG_r2 = &Entry_REG_r2;
+static const Entry Entry_REG_r3 = {
+  .kind = ENTRY_REGISTER,
+  .type = enum_REG_r3,
+  .value = enum_REG_r3,
+};
+static const Entry *const REG_r3 = &Entry_REG_r3;
+static inline Entry MEM_frame(uint64_t base, uint64_t offset) {
+  assert(FITS_UNSIGNED(base, 4));
+  assert(FITS_UNSIGNED(offset, 12));
+  uint64_t number = 0;
+  number = numSetBits(number, 0, 4, base);
+  number = numSetBits(number, 4, 16, offset);
+  return (Entry) {.kind = ENTRY_MEMORY, .type = enum_MEM_frame, .value = number};
+}
+static inline bool IMM_u16_fits(uint64_t val) {
+  return FITS_UNSIGNED(val, 16);
+}
+static inline Entry IMM_u16(uint64_t val) {
+  assert(IMM_u16_fits(val));
+  return (Entry) {
+      .kind = ENTRY_IMMEDIATE, .type = enum_IMM_u16, .value = LOW_BITS(val, 16)
+  };
+}
+static const struct {
+  uint8_t width[IMMEDIATE_ID_COUNT];
+  bool is_signed[IMMEDIATE_ID_COUNT];
+} IMMEDIATE_TABLE = {
+  .width = {
+    [enum_IMM_u16] = 16,
+  },
+  .is_signed = {
+    [enum_IMM_u16] = 0,
+  },
+};
+static inline uint64_t IMM_value(const Entry *imm) {
+  if (imm->kind != ENTRY_IMMEDIATE || !IMMEDIATE_TABLE.is_signed[imm->type]) {
+    return imm->value;
+  }
+  return (uint64_t) SIGN_EXTEND(imm->value, IMMEDIATE_TABLE.width[imm->type]);
+}
+uint32_t encoding_movw_0(uint64_t gpr, uint64_t u16, Array *buffer);
+uint32_t encode_movw_ri(const Entry *a0, const Entry *a1, Array *buffer);
+uint32_t encoding_bl_0(uint64_t u16, Array *buffer);
+uint32_t encode_bl_i(const Entry *a0, Array *buffer);
+uint32_t encoding_ldr_0(uint64_t gpr, uint64_t frame, Array *buffer);
+uint32_t encode_ldr_rm(const Entry *a0, const Entry *a1, Array *buffer);
+
+#endif  // MACHINE_ORDERS_H
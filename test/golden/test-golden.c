@@ -0,0 +1,243 @@
+/**
+ * Project Name: machine
+ * Module Name: test/golden
+ * Filename: test-golden.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "emit.h"
+#include "generate.h"
+#include "instrument.h"
+#include "parse.h"
+#include "source.h"
+#include "target.h"
+#include <dirent.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#define MAX_PATH    1024
+#define MAX_COMMAND (3 * MAX_PATH + 128)
+#define MAX_FILES   256
+#define GOLDEN_EXT  ".mm"
+
+typedef struct GoldenRun {
+  uint64_t nanos;
+  uint64_t n_malloc;
+  uint64_t n_calloc;
+  uint64_t n_realloc;
+  uint64_t n_free;
+  Array *header;
+  Array *source;
+} GoldenRun;
+
+int compare_names(const void *a, const void *b);
+uint32_t list_corpus(const char_t *dir, char_t *names[], uint32_t capacity);
+int32_t generate(const char_t *path, const char_t *name, GoldenRun *run);
+Array *read_file(const char_t *path);
+int32_t write_file(const char_t *path, Array *content);
+bool same_content(Array *lhs, Array *rhs, uint32_t *lineno);
+bool check_output(const char_t *path, Array *output, bool update);
+bool compile_output(const char_t *dir, const char_t *name);
+
+int compare_names(const void *a, const void *b) {
+  return strcmp(*(char_t *const *) a, *(char_t *const *) b);
+}
+
+// The machine descriptions of the corpus, sorted so the CSV keeps its order between runs.
+uint32_t list_corpus(const char_t *dir, char_t *names[], uint32_t capacity) {
+  DIR *dp = opendir(dir);
+  if (!dp) { return 0; }
+  uint32_t n_names = 0;
+  for (struct dirent *de = readdir(dp); de && n_names < capacity; de = readdir(dp)) {
+    const size_t length = strlen(de->d_name);
+    const size_t ext_length = strlen(GOLDEN_EXT);
+    if (length <= ext_length || strcmp(de->d_name + length - ext_length, GOLDEN_EXT) != 0) {
+      continue;
+    }
+    names[n_names] = STDAllocator.calloc(length + 1, sizeof(char_t));
+    memcpy(names[n_names], de->d_name, length - ext_length);
+    n_names++;
+  }
+  closedir(dp);
+  qsort(names, n_names, sizeof(char_t *), compare_names);
+  return n_names;
+}
+
+// Generates the C of one description, counting the time and the allocations of the
+// whole way from the text to the outputs.
+int32_t generate(const char_t *path, const char_t *name, GoldenRun *run) {
+  const Allocator *allocator = Instrument_wrapAllocator(&STDAllocator);
+  const InstrumentAllocations before = Instrument_allocations();
+  run->header = Array_new(sizeof(char_t), -1, &STDAllocator);
+  run->source = Array_new(sizeof(char_t), -1, &STDAllocator);
+
+  struct timespec start = {}, end = {};
+  timespec_get(&start, TIME_UTC);
+  uint32_t cost = 0, stage = 0;
+  Machine *machine = parse_file(path, &cost, &stage, nullptr, get_codegen, allocator);
+  if (!machine) { return -(int32_t) stage; }
+  const int32_t result = emit_c_files(
+      machine->context, name, 2024, "xMachine", nullptr, run->header, run->source
+  );
+  releaseMachine(machine, allocator);
+  allocator->free(machine);
+  timespec_get(&end, TIME_UTC);
+
+  run->nanos = (uint64_t) (end.tv_sec - start.tv_sec) * 1000000000ULL +
+               (uint64_t) end.tv_nsec - (uint64_t) start.tv_nsec;
+  const InstrumentAllocations after = Instrument_allocations();
+  run->n_malloc = after.n_malloc - before.n_malloc;
+  run->n_calloc = after.n_calloc - before.n_calloc;
+  run->n_realloc = after.n_realloc - before.n_realloc;
+  run->n_free = after.n_free - before.n_free;
+  return result;
+}
+
+Array *read_file(const char_t *path) {
+  FILE *fp = fopen(path, "r");
+  if (!fp) { return nullptr; }
+  Array *content = Array_new(sizeof(char_t), -1, &STDAllocator);
+  char_t chunk[4096];
+  for (size_t n = fread(chunk, 1, sizeof(chunk), fp); n; n = fread(chunk, 1, sizeof(chunk), fp)) {
+    Array_append(content, chunk, n);
+  }
+  fclose(fp);
+  return content;
+}
+
+int32_t write_file(const char_t *path, Array *content) {
+  FILE *fp = fopen(path, "w");
+  if (!fp) { return -1; }
+  const uint32_t length = Array_length(content);
+  const bool written = fwrite(Array_real_addr(content, 0), 1, length, fp) == length;
+  return (fclose(fp) == 0 && written) ? 0 : -1;
+}
+
+// Tells the first line which differs, counted from 1.
+bool same_content(Array *lhs, Array *rhs, uint32_t *lineno) {
+  const uint32_t n_lhs = Array_length(lhs), n_rhs = Array_length(rhs);
+  const char_t *l = n_lhs ? Array_real_addr(lhs, 0) : nullptr;
+  const char_t *r = n_rhs ? Array_real_addr(rhs, 0) : nullptr;
+  *lineno = 1;
+  uint32_t i = 0;
+  for (; i < n_lhs && i < n_rhs && l[i] == r[i]; i++) {
+    if ('\n' == l[i]) { (*lineno)++; }
+  }
+  return i == n_lhs && i == n_rhs;
+}
+
+bool check_output(const char_t *path, Array *output, bool update) {
+  if (update) {
+    if (write_file(path, output) == 0) { return true; }
+    fprintf(stderr, "failed to write %s.\n", path);
+    return false;
+  }
+  Array *expected = read_file(path);
+  if (!expected) {
+    fprintf(stderr, "%s is missing, run with --update to write it.\n", path);
+    return false;
+  }
+  uint32_t lineno = 0;
+  const bool same = same_content(expected, output, &lineno);
+  if (!same) { fprintf(stderr, "%s differs from line %u.\n", path, lineno); }
+  releasePrimeArray(expected);
+  return same;
+}
+
+// The checked-in source, with its header, has to build with the flags of the project.
+bool compile_output(const char_t *dir, const char_t *name) {
+  char_t command[MAX_COMMAND] = {};
+  snprintf(
+      command, MAX_COMMAND,
+      "\"%s\" -std=c2x -Wall -Wextra -Werror -c -o /dev/null -I\"%s\" -I\"%s\" \"%s/%s.c\"",
+      GOLDEN_CC, GOLDEN_INCLUDE, dir, dir, name
+  );
+  if (system(command) == 0) { return true; }
+  fprintf(stderr, "%s/%s.c does not compile.\n", dir, name);
+  return false;
+}
+
+// usage: test-golden [--update] [--csv=<file>] [<corpus dir> <expected dir>]
+// Generates the C of every `.mm` of the corpus twice: the two runs have to give the same
+// bytes, and those have to be the checked-in `<name>.h` and `<name>.c` (or replace them with
+// `--update`), which have to compile. The time and the allocations of the first run are
+// written to the CSV.
+int main(int argc, char *argv[]) {
+  bool update = false;
+  const char_t *csv_path = GOLDEN_CSV;
+  const char_t *dirs[2] = {GOLDEN_CORPUS, GOLDEN_EXPECTED};
+  uint32_t n_dirs = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--update") == 0) {
+      update = true;
+    } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+      csv_path = argv[i] + 6;
+    } else if (n_dirs < 2) {
+      dirs[n_dirs++] = argv[i];
+    }
+  }
+
+  if (update) { mkdir(dirs[1], 0755); }
+  char_t *names[MAX_FILES] = {};
+  const uint32_t n_names = list_corpus(dirs[0], names, MAX_FILES);
+  if (!n_names) {
+    fprintf(stderr, "no machine description in %s.\n", dirs[0]);
+    return -1;
+  }
+  FILE *csv = fopen(csv_path, "w");
+  if (!csv) {
+    fprintf(stderr, "failed to open %s.\n", csv_path);
+    return -2;
+  }
+  fprintf(
+      csv, "name,header_bytes,source_bytes,nanos,malloc,calloc,realloc,free,stable,matched,"
+           "compiled\n"
+  );
+
+  uint32_t n_failed = 0;
+  for (uint32_t i = 0; i < n_names; i++) {
+    char_t path[MAX_PATH] = {};
+    snprintf(path, MAX_PATH, "%s/%s%s", dirs[0], names[i], GOLDEN_EXT);
+    GoldenRun first = {}, second = {};
+    const bool generated = generate(path, names[i], &first) == 0 &&
+                           generate(path, names[i], &second) == 0;
+    uint32_t lineno = 0;
+    const bool stable = generated && same_content(first.header, second.header, &lineno) &&
+                        same_content(first.source, second.source, &lineno);
+    bool matched = false;
+    if (!generated) {
+      fprintf(stderr, "failed to generate %s.\n", path);
+    } else if (!stable) {
+      fprintf(stderr, "%s does not generate the same output twice.\n", path);
+    } else {
+      snprintf(path, MAX_PATH, "%s/%s.h", dirs[1], names[i]);
+      matched = check_output(path, first.header, update);
+      snprintf(path, MAX_PATH, "%s/%s.c", dirs[1], names[i]);
+      matched = check_output(path, first.source, update) && matched;
+    }
+    const bool compiled = matched && compile_output(dirs[1], names[i]);
+    fprintf(
+        csv, "%s,%u,%u,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%d,%d,%d\n",
+        names[i], Array_length(first.header), Array_length(first.source), first.nanos,
+        first.n_malloc, first.n_calloc, first.n_realloc, first.n_free, stable, matched, compiled
+    );
+    n_failed += compiled ? 0 : 1;
+    releasePrimeArray(first.header);
+    releasePrimeArray(first.source);
+    releasePrimeArray(second.header);
+    releasePrimeArray(second.source);
+    STDAllocator.free(names[i]);
+  }
+  fclose(csv);
+  printf("%u of %u machine descriptions match.\n", n_names - n_failed, n_names);
+  return n_failed ? 1 : 0;
+}
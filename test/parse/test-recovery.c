@@ -0,0 +1,131 @@
+/**
+ * Project Name: machine
+ * Module Name: test/parse
+ * Filename: test-recovery.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "codegen.h"
+#include "context.h"
+#include "enum.h"
+#include "parse.h"
+#include "string_t.h"
+#include "terminal.h"
+#include "tokenize.h"
+#include "tokens.gen.h"
+#include <check.h>
+#include <stdint.h>
+
+// What the context holds when the machine is reduced, after every malformed entry is dropped.
+typedef struct Survivors {
+  uint32_t n_records;
+  uint32_t n_regs;
+  uint32_t n_imms;
+  uint32_t n_sets;
+  uint32_t n_grps;
+  bool bound[5];
+} Survivors;
+
+static Survivors SURVIVORS = {};
+
+static const char_t * const NAMES[] = {"rax", "eax", "ax", "bx", "t"};
+
+int32_t record_survivors(GContext *context, void *machine);
+codegen_t *get_survivors_codegen(uint32_t type);
+
+int32_t record_survivors(GContext *context, void *) {
+  SURVIVORS = (Survivors) {
+      .n_records = Array_length(context->recordArray),
+      .n_regs = Array_length(context->regArray),
+      .n_imms = Array_length(context->immArray),
+      .n_sets = Array_length(context->setArray),
+      .n_grps = Array_length(context->grpArray),
+  };
+  for (uint32_t i = 0; i < sizeof(NAMES) / sizeof(NAMES[0]); i++) {
+    Identifier ident = {.ptr = (char_t *) NAMES[i], .len = strlen_o(NAMES[i])};
+    SURVIVORS.bound[i] = GContext_findRecord(context, &ident) != nullptr;
+  }
+  return 0;
+}
+
+codegen_t *get_survivors_codegen(uint32_t type) {
+  return (enum_Machine == type) ? record_survivors : nullptr;
+}
+
+#define assertDiagnostic(diag, _kind, _lineno, _column) \
+  do {                                                  \
+    ck_assert_uint_eq((diag)->kind, _kind);             \
+    ck_assert_uint_eq((diag)->lineno, _lineno);         \
+    ck_assert_uint_eq((diag)->column, _column);         \
+  } while (false)
+
+// The registers of a dropped group are bound before the group fails, and have to be unbound
+// with it: `bx` defines `rax` again without a diagnostic, and `t` can not refer to `eax`.
+START_TEST(test_recovery_dropped_entries) {
+  const char_t *string = "machine abc {\n"
+                         "    register ax [64-bit] {\n"
+                         "        rax: [63-0] = 0x00;\n"
+                         "        eax: [31-0] = 0x00;\n"
+                         "        ah : [15-8] = ;\n"
+                         "    };\n"
+                         "    register bx [64-bit] {\n"
+                         "        rax: [63-0] = 0x00;\n"
+                         "        rbx: [63-0] = 0x03;\n"
+                         "    };\n"
+                         "    immediate i8 [8-bit] 12;\n"
+                         "    immediate i8 [8-bit] signed;\n"
+                         "    set bad { rax, nothing };\n"
+                         "    set s { rax, rbx };\n"
+                         "    set t { eax };\n"
+                         "};\n";
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(string, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  ck_assert_ptr_ne(terminals, nullptr);
+
+  Array *diagnostics = Array_new(sizeof(Diagnostic), -1, &STDAllocator);
+  SURVIVORS = (Survivors) {};
+  Machine *machine =
+      parse(terminals, &cost, diagnostics, get_survivors_codegen, &STDAllocator);
+  ck_assert_ptr_eq(machine, nullptr);
+  for (uint32_t i = cost; i < n_tokens; i++) {
+    releaseToken(terminals[i].value, terminals[i].type, &STDAllocator);
+  }
+  STDAllocator.free((void *) terminals);
+
+  ck_assert_uint_eq(Array_length(diagnostics), 4);
+  const Diagnostic *diags = Array_real_addr(diagnostics, 0);
+  assertDiagnostic(&diags[0], DIAG_UNEXPECTED_TOKEN, 4, 22);
+  ck_assert_uint_eq(diags[0].detail, enum_SEMICOLON);
+  assertDiagnostic(&diags[1], DIAG_UNEXPECTED_TOKEN, 10, 25);
+  ck_assert_uint_eq(diags[1].detail, enum_NUMBER);
+  assertDiagnostic(&diags[2], DIAG_REJECTED_RULE, 12, 27);
+  assertDiagnostic(&diags[3], DIAG_REJECTED_RULE, 14, 16);
+  releasePrimeArray(diagnostics);
+
+  // `bx` with `rax` and `rbx`, `i8` and `s`.
+  ck_assert_uint_eq(SURVIVORS.n_regs, 2);
+  ck_assert_uint_eq(SURVIVORS.n_grps, 1);
+  ck_assert_uint_eq(SURVIVORS.n_imms, 1);
+  ck_assert_uint_eq(SURVIVORS.n_sets, 1);
+  ck_assert_uint_eq(SURVIVORS.n_records, 5);
+  ck_assert(SURVIVORS.bound[0]);
+  ck_assert(!SURVIVORS.bound[1]);
+  ck_assert(!SURVIVORS.bound[2]);
+  ck_assert(SURVIVORS.bound[3]);
+  ck_assert(!SURVIVORS.bound[4]);
+}
+END_TEST
+
+Suite *recovery_suite() {
+  Suite *suite = suite_create("Recovery");
+  TCase *tc_recovery = tcase_create("recovery");
+  tcase_add_test(tc_recovery, test_recovery_dropped_entries);
+  suite_add_tcase(suite, tc_recovery);
+  return suite;
+}
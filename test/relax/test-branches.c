@@ -0,0 +1,195 @@
+/**
+ * Project Name: machine
+ * Module Name: test/relax
+ * Filename: test-branches.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "relax.h"
+#include <check.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SHORT_OPCODE 0xEB
+#define LONG_OPCODE  0xE9
+
+// `jmp rel8` and `jmp rel32` of x86, displacements counted from the end of the branch.
+static const RelaxForm JMP_FORMS[] = {
+    {.size = 2, .min_disp = INT8_MIN, .max_disp = INT8_MAX},
+    {.size = 5, .min_disp = INT32_MIN, .max_disp = INT32_MAX},
+};
+
+uint32_t encode_jmp(void *payload, uint32_t form, int64_t disp, Array *buffer);
+uint32_t encode_fill(void *payload, uint32_t form, int64_t disp, Array *buffer);
+
+uint32_t encode_jmp(void *, uint32_t form, int64_t disp, Array *buffer) {
+  uint8_t bytes[5] = {form ? LONG_OPCODE : SHORT_OPCODE};
+  const uint32_t size = JMP_FORMS[form].size;
+  const uint32_t value = (uint32_t) (int32_t) disp;
+  memcpy(&bytes[1], &value, size - 1);
+  Array_append(buffer, bytes, size);
+  return size;
+}
+
+// The payload of a fixed fragment is its size.
+uint32_t encode_fill(void *payload, uint32_t, int64_t, Array *buffer) {
+  const uint32_t size = (uint32_t) (uint64_t) payload;
+  for (uint32_t i = 0; i < size; i++) { Array_append(buffer, &(uint8_t) {0x90}, 1); }
+  return size;
+}
+
+#define addFill(relaxer, size) \
+  Relaxer_addFixed(relaxer, size, (void *) (uint64_t) (size), (size) ? encode_fill : nullptr)
+#define addLabel(relaxer) Relaxer_addFixed(relaxer, 0, nullptr, nullptr)
+#define addJmp(relaxer, target) \
+  Relaxer_addBranch(relaxer, JMP_FORMS, 2, target, nullptr, encode_jmp)
+
+START_TEST(test_forward_short) {
+  Relaxer *relaxer = Relaxer_new(&STDAllocator);
+  const uint32_t jmp = addJmp(relaxer, 2);
+  addFill(relaxer, 127);
+  const uint32_t label = addLabel(relaxer);
+  ck_assert_int_eq(Relaxer_relax(relaxer), 0);
+  ck_assert_uint_eq(relaxer->fragments[jmp].form, 0);
+  ck_assert_uint_eq(Relaxer_offsetOf(relaxer, label), 129);
+
+  Array *buffer = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  ck_assert_int_eq(Relaxer_emit(relaxer, buffer), 129);
+  const uint8_t *bytes = Array_real_addr(buffer, 0);
+  ck_assert_uint_eq(bytes[0], SHORT_OPCODE);
+  ck_assert_uint_eq(bytes[1], 127);
+  releasePrimeArray(buffer);
+  Relaxer_destroy(relaxer);
+}
+END_TEST
+
+START_TEST(test_forward_grow) {
+  Relaxer *relaxer = Relaxer_new(&STDAllocator);
+  const uint32_t jmp = addJmp(relaxer, 2);
+  addFill(relaxer, 128);
+  const uint32_t label = addLabel(relaxer);
+  ck_assert_int_eq(Relaxer_relax(relaxer), 1);
+  ck_assert_uint_eq(relaxer->fragments[jmp].form, 1);
+  ck_assert_uint_eq(Relaxer_offsetOf(relaxer, label), 133);
+
+  Array *buffer = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  ck_assert_int_eq(Relaxer_emit(relaxer, buffer), 133);
+  const uint8_t *bytes = Array_real_addr(buffer, 0);
+  ck_assert_uint_eq(bytes[0], LONG_OPCODE);
+  ck_assert_uint_eq(bytes[1], 128);
+  ck_assert_uint_eq(bytes[2], 0);
+  releasePrimeArray(buffer);
+  Relaxer_destroy(relaxer);
+}
+END_TEST
+
+START_TEST(test_backward) {
+  Relaxer *relaxer = Relaxer_new(&STDAllocator);
+  const uint32_t label = addLabel(relaxer);
+  addFill(relaxer, 126);
+  const uint32_t near = addJmp(relaxer, label);
+  const uint32_t far = addJmp(relaxer, label);
+  ck_assert_int_eq(Relaxer_relax(relaxer), 1);
+  // -128 is still in the short form, -130 is not.
+  ck_assert_uint_eq(relaxer->fragments[near].form, 0);
+  ck_assert_uint_eq(relaxer->fragments[far].form, 1);
+
+  Array *buffer = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  ck_assert_int_eq(Relaxer_emit(relaxer, buffer), 133);
+  const uint8_t *bytes = Array_real_addr(buffer, 0);
+  ck_assert_uint_eq(bytes[126], SHORT_OPCODE);
+  ck_assert_uint_eq(bytes[127], (uint8_t) -128);
+  ck_assert_uint_eq(bytes[128], LONG_OPCODE);
+  ck_assert_uint_eq(bytes[129], (uint8_t) -133);
+  releasePrimeArray(buffer);
+  Relaxer_destroy(relaxer);
+}
+END_TEST
+
+// The inner branch grows past its short form, which takes the outer one out of reach too.
+START_TEST(test_chained_growth) {
+  Relaxer *relaxer = Relaxer_new(&STDAllocator);
+  const uint32_t outer = addJmp(relaxer, 3);
+  addFill(relaxer, 125);
+  const uint32_t inner = addJmp(relaxer, 5);
+  const uint32_t label = addLabel(relaxer);
+  addFill(relaxer, 128);
+  const uint32_t end = addLabel(relaxer);
+  ck_assert_int_eq(Relaxer_relax(relaxer), 2);
+  ck_assert_uint_eq(relaxer->fragments[outer].form, 1);
+  ck_assert_uint_eq(relaxer->fragments[inner].form, 1);
+  ck_assert_uint_eq(Relaxer_offsetOf(relaxer, label), 135);
+  ck_assert_uint_eq(Relaxer_offsetOf(relaxer, end), 263);
+
+  Array *buffer = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  ck_assert_int_eq(Relaxer_emit(relaxer, buffer), 263);
+  releasePrimeArray(buffer);
+  Relaxer_destroy(relaxer);
+}
+END_TEST
+
+START_TEST(test_unreachable) {
+  Relaxer *relaxer = Relaxer_new(&STDAllocator);
+  Relaxer_addBranch(relaxer, JMP_FORMS, 1, 2, nullptr, encode_jmp);
+  addFill(relaxer, 200);
+  addLabel(relaxer);
+  ck_assert_int_eq(Relaxer_relax(relaxer), -1);
+  Relaxer_destroy(relaxer);
+
+  // a target past the end of the fragments.
+  relaxer = Relaxer_new(&STDAllocator);
+  addJmp(relaxer, 5);
+  addLabel(relaxer);
+  ck_assert_int_eq(Relaxer_relax(relaxer), -1);
+  Relaxer_destroy(relaxer);
+}
+END_TEST
+
+// Past `INIT_FRAGMENT_CAPACITY` the size tree is grown, and every offset has to stay the sum
+// of the sizes before it, also once branches have grown.
+START_TEST(test_many_fragments) {
+  Relaxer *relaxer = Relaxer_new(&STDAllocator);
+  const uint32_t n_fragments = 1000;
+  const uint32_t start = addLabel(relaxer);
+  for (uint32_t i = 1; i < n_fragments; i++) {
+    if (i % 10 == 0 && i >= 20) {
+      // each branch goes back over the last 20 fragments.
+      addJmp(relaxer, i - 20);
+    } else {
+      addFill(relaxer, i % 7);
+    }
+  }
+  const uint32_t back = addJmp(relaxer, start);
+  ck_assert_uint_gt(relaxer->capacity, 64);
+  const int32_t n_grown = Relaxer_relax(relaxer);
+  ck_assert_int_gt(n_grown, 0);
+  ck_assert_uint_eq(relaxer->fragments[back].form, 1);
+
+  uint32_t offset = 0;
+  for (uint32_t i = 0; i <= back; i++) {
+    ck_assert_uint_eq(Relaxer_offsetOf(relaxer, i), offset);
+    offset += relaxer->fragments[i].size;
+  }
+  Array *buffer = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  ck_assert_int_eq(Relaxer_emit(relaxer, buffer), offset);
+  releasePrimeArray(buffer);
+  Relaxer_destroy(relaxer);
+}
+END_TEST
+
+Suite *branch_suite() {
+  Suite *suite = suite_create("Branches");
+  TCase *tc_branches = tcase_create("branches");
+  tcase_add_test(tc_branches, test_forward_short);
+  tcase_add_test(tc_branches, test_forward_grow);
+  tcase_add_test(tc_branches, test_backward);
+  tcase_add_test(tc_branches, test_chained_growth);
+  tcase_add_test(tc_branches, test_unreachable);
+  tcase_add_test(tc_branches, test_many_fragments);
+  suite_add_tcase(suite, tc_branches);
+  return suite;
+}
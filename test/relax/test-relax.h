@@ -0,0 +1,17 @@
+/**
+ * Project Name: machine
+ * Module Name: test/relax
+ * Filename: test-relax.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_TEST_RELAX_H
+#define MACHINE_TEST_RELAX_H
+
+#include <check.h>
+
+Suite *branch_suite();
+
+#endif  // MACHINE_TEST_RELAX_H
@@ -0,0 +1,194 @@
+/**
+ * Project Name: machine
+ * Module Name: test/roundtrip
+ * Filename: gen-thunks.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "context.h"
+#include "parse.h"
+#include "source.h"
+#include "target.h"
+#include "tokens.gen.h"
+#include <stdint.h>
+#include <stdio.h>
+
+void write_enum_table(FILE *fp, const char_t *table, const char_t *prefix, Array *names);
+void write_makers(FILE *fp, GContext *context);
+char_t arg_kind(GContext *context, const Identifier *arg);
+void write_entry(FILE *fp, GContext *context, const Identifier *arg, uint32_t index);
+void write_arg(FILE *fp, GContext *context, const Identifier *arg, uint32_t index);
+void write_thunks(FILE *fp, const Machine *machine);
+
+// Maps the offsets of the context, which the test samples, to the enums of the generated C.
+void write_enum_table(FILE *fp, const char_t *table, const char_t *prefix, Array *names) {
+  const uint32_t n_names = Array_length(names);
+  fprintf(fp, "[[maybe_unused]] static const uint32_t %s[] = {\n", table);
+  for (uint32_t i = 0; i < n_names; i++) {
+    fprintf(fp, "  %s%s,\n", prefix, *(const char_t **) Array_real_addr(names, i));
+  }
+  fprintf(fp, "%s};\n", n_names ? "" : "  0,\n");
+}
+
+// An operand sampled by the test becomes an `Entry` through the constructors of the generated
+// C, the way a caller builds it: `REG_<name>`, `MEM_<name>(base, offset)` and `IMM_<name>(val)`.
+void write_makers(FILE *fp, GContext *context) {
+  fprintf(fp, "\n[[maybe_unused]] static Entry make_reg(uint32_t type) {\n  switch (type) {\n");
+  for (uint32_t i = 0; i < Array_length(context->regArray); i++) {
+    fprintf(fp, "    case %u: return *REG_%s;\n", i, GContext_getRegister(context, i)->name->ptr);
+  }
+  fprintf(fp, "  }\n  return (Entry) {};\n}\n");
+  fprintf(fp, "\n[[maybe_unused]] static Entry make_mem(uint32_t type, uint64_t value) {\n");
+  fprintf(fp, "  switch (type) {\n");
+  for (uint32_t i = 0; i < Array_length(context->memArray); i++) {
+    const Memory *mem = GContext_getMemory(context, i);
+    const uint32_t base_width = mem->base->upper - mem->base->lower + 1;
+    const uint32_t offset_width = mem->offset->upper - mem->offset->lower + 1;
+    fprintf(
+        fp, "    case %u: return MEM_%s(LOW_BITS(value >> %u, %u), LOW_BITS(value >> %u, %u));\n",
+        i, mem->name->ptr, mem->base->lower, base_width, mem->offset->lower, offset_width
+    );
+  }
+  fprintf(fp, "  }\n  return (Entry) {};\n}\n");
+  fprintf(fp, "\n[[maybe_unused]] static Entry make_imm(uint32_t type, uint64_t value) {\n");
+  fprintf(fp, "  switch (type) {\n");
+  for (uint32_t i = 0; i < Array_length(context->immArray); i++) {
+    const char_t *name = GContext_getImmediate(context, i)->name->ptr;
+    fprintf(fp, "    case %u: return IMM_%s(value);\n", i, name);
+  }
+  fprintf(fp, "  }\n  return (Entry) {};\n}\n");
+}
+
+// The kind letter of an argument in the name of its selector.
+char_t arg_kind(GContext *context, const Identifier *arg) {
+  const Record *record = GContext_findRecord(context, arg);
+  uint32_t typeid = record->typeid;
+  if (enum_Set == typeid) { typeid = GContext_getSet(context, record->offset)->type; }
+  switch (typeid) {
+    case enum_Memory: return 'm';
+    case enum_Immediate: return 'i';
+  }
+  return 'r';
+}
+
+void write_entry(FILE *fp, GContext *context, const Identifier *arg, uint32_t index) {
+  switch (arg_kind(context, arg)) {
+    case 'r': fprintf(fp, "  const Entry e%u = make_reg(a[%u].type);\n", index, index); return;
+    case 'm': fprintf(fp, "  const Entry e%u = make_mem(", index); break;
+    default: fprintf(fp, "  const Entry e%u = make_imm(", index); break;
+  }
+  fprintf(fp, "a[%u].type, a[%u].value);\n", index, index);
+}
+
+// An argument of the encoder of a form: a set takes the `Entry` written by `write_entry`.
+void write_arg(FILE *fp, GContext *context, const Identifier *arg, uint32_t index) {
+  const Record *record = GContext_findRecord(context, arg);
+  switch (record->typeid) {
+    case enum_Register: {
+      fprintf(fp, "enum_REG_%s, ", GContext_getRegister(context, record->offset)->name->ptr);
+      return;
+    }
+    case enum_RegisterGroup: {
+      fprintf(fp, "REG_ENUM[a[%u].type], ", index);
+      return;
+    }
+    case enum_Set: {
+      fprintf(fp, "&e%u, ", index);
+      return;
+    }
+  }
+  fprintf(fp, "a[%u].value, ", index);
+}
+
+// Writes two thunks per form: `thunk_<id>` calls the encoder of the form, and `select_<id>`
+// builds every operand through its constructor and calls the selector of the instruction.
+void write_thunks(FILE *fp, const Machine *machine) {
+  GContext *context = machine->context;
+  Array *names[3] = {};
+  Array *arrays[3] = {context->regArray, context->memArray, context->immArray};
+  for (uint32_t k = 0; k < 3; k++) {
+    names[k] = Array_new(sizeof(const char_t *), -1, &STDAllocator);
+    for (uint32_t i = 0; i < Array_length(arrays[k]); i++) {
+      const char_t *name = nullptr;
+      if (0 == k) { name = GContext_getRegister(context, i)->name->ptr; }
+      if (1 == k) { name = GContext_getMemory(context, i)->name->ptr; }
+      if (2 == k) { name = GContext_getImmediate(context, i)->name->ptr; }
+      Array_append(names[k], &name, 1);
+    }
+  }
+  fprintf(fp, "// Written by gen-thunks, do not edit.\n\n");
+  fprintf(fp, "#include \"reference.gen.h\"\n#include \"roundtrip.h\"\n\n");
+  write_enum_table(fp, "REG_ENUM", "enum_REG_", names[0]);
+  write_enum_table(fp, "MEM_ENUM", "enum_MEM_", names[1]);
+  write_enum_table(fp, "IMM_ENUM", "enum_IMM_", names[2]);
+  for (uint32_t k = 0; k < 3; k++) { Array_destroy(names[k]); }
+  write_makers(fp, context);
+
+  uint32_t id = 0;
+  const uint32_t n_entries = Array_length(machine->entries);
+  for (uint32_t pass = 0; pass < 2; pass++, id = 0) {
+    if (pass) { fprintf(fp, "\nconst RoundtripForm ROUNDTRIP_FORMS[] = {\n"); }
+    for (uint32_t e = 0; e < n_entries; e++) {
+      const Entry *entry = Array_real_addr(machine->entries, e);
+      if (enum_Instruction != entry->type) { continue; }
+      const Instruction *instr = entry->target;
+      const InstrForm *forms = Array_real_addr(instr->forms, 0);
+      for (uint32_t i = 0; i < Array_length(instr->forms); i++, id++) {
+        if (pass) {
+          fprintf(fp, "  {\"%s\", %u, thunk_%u, select_%u},\n", instr->name->ptr, i, id, id);
+          continue;
+        }
+        PatternArgs *args = forms[i].pattern->args;
+        const uint32_t n_args = args ? Array_length(args) : 0;
+        fprintf(fp, "\nstatic uint32_t thunk_%u([[maybe_unused]] const GenOperand a[], ", id);
+        fprintf(fp, "Array *buffer) {\n");
+        for (uint32_t j = 0; j < n_args; j++) {
+          const Identifier *arg = Array_real_addr(args, j);
+          const Record *record = GContext_findRecord(context, arg);
+          if (enum_Set == record->typeid) { write_entry(fp, context, arg, j); }
+        }
+        fprintf(fp, "  return encoding_%s_%u(", instr->name->ptr, i);
+        for (uint32_t j = 0; j < n_args; j++) {
+          write_arg(fp, context, Array_real_addr(args, j), j);
+        }
+        fprintf(fp, "buffer);\n}\n");
+
+        fprintf(fp, "\nstatic uint32_t select_%u([[maybe_unused]] const GenOperand a[], ", id);
+        fprintf(fp, "Array *buffer) {\n");
+        for (uint32_t j = 0; j < n_args; j++) {
+          write_entry(fp, context, Array_real_addr(args, j), j);
+        }
+        fprintf(fp, "  return encode_%s%s", instr->name->ptr, n_args ? "_" : "");
+        for (uint32_t j = 0; j < n_args; j++) {
+          fprintf(fp, "%c", arg_kind(context, Array_real_addr(args, j)));
+        }
+        fprintf(fp, "(");
+        for (uint32_t j = 0; j < n_args; j++) { fprintf(fp, "&e%u, ", j); }
+        fprintf(fp, "buffer);\n}\n");
+      }
+    }
+    if (pass) { fprintf(fp, "};\n\nconst uint32_t ROUNDTRIP_N_FORMS = %u;\n", id); }
+  }
+}
+
+// usage: gen-thunks <machine description> <output>
+// Writes the thunks which call the generated encoders and selectors with sampled operands.
+int main(int argc, char *argv[]) {
+  if (argc < 3) { return -1; }
+  uint32_t cost = 0, stage = 0;
+  Machine *machine = parse_file(argv[1], &cost, &stage, nullptr, nullptr, &STDAllocator);
+  if (LOAD_READ == stage) { fprintf(stderr, "failed to read %s.\n", argv[1]); }
+  if (!machine) { return -1 - (int32_t) stage; }
+
+  FILE *fp = fopen(argv[2], "w");
+  if (fp) { write_thunks(fp, machine); }
+  const bool written = fp && fclose(fp) == 0;
+  releaseMachine(machine, &STDAllocator);
+  STDAllocator.free(machine);
+  return written ? 0 : -5;
+}
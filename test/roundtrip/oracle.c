@@ -0,0 +1,94 @@
+/**
+ * Project Name: machine
+ * Module Name: test/roundtrip
+ * Filename: oracle.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "roundtrip.h"
+#include <string.h>
+
+// The offsets of the items of `reference.mm` in the context, in the order they are declared.
+#define REF_N_GPR 8
+#define REF_I8    0
+
+uint64_t register_code(uint32_t type);
+uint64_t immediate_of_rel(const GenOperand *rel);
+uint32_t store_le(uint8_t bytes[], uint32_t index, uint64_t word, uint32_t count);
+
+// gpr r0-r7 come first, then acc a0-a3; the code of each is its number.
+uint64_t register_code(uint32_t type) {
+  return type < REF_N_GPR ? type : type - REF_N_GPR;
+}
+
+// A member of `rel` is sign-extended from its own width into the 32 bits of `call`.
+uint64_t immediate_of_rel(const GenOperand *rel) {
+  if (REF_I8 == rel->type) { return (uint64_t) (int64_t) (int8_t) rel->value; }
+  return rel->value;
+}
+
+uint32_t store_le(uint8_t bytes[], uint32_t index, uint64_t word, uint32_t count) {
+  for (uint32_t k = 0; k < count; k++) { bytes[index + k] = (uint8_t) (word >> (8 * k)); }
+  return index + count;
+}
+
+uint32_t oracle_encode(
+    const char_t *instr, uint32_t form, const GenOperand args[], uint8_t bytes[]
+) {
+  uint32_t n = 0;
+  if (strcmp(instr, "mov") == 0) {
+    const uint64_t gpr = register_code(args[0].type), acc = register_code(args[1].type);
+    return store_le(bytes, n, 0x89 | (gpr & 7) << 8 | (acc & 3) << 11, 2);
+  }
+  if (strcmp(instr, "add") == 0) {
+    n = store_le(bytes, n, 0 == form ? 0x83 : 0x81, 1);
+    n = store_le(bytes, n, 0xC0 | register_code(args[0].type), 1);
+    return store_le(bytes, n, args[1].value, 0 == form ? 1 : 4);
+  }
+  if (strcmp(instr, "ld") == 0) {
+    const uint64_t base = args[1].value & 0x3F, offset = (args[1].value >> 6) & 0x3F;
+    n = store_le(bytes, n, 0x8B, 1);
+    return store_le(bytes, n, register_code(args[0].type) | base << 2 | offset << 8, 2);
+  }
+  if (strcmp(instr, "push") == 0) {
+    return store_le(bytes, n, 0x50 | register_code(args[0].type), 1);
+  }
+  if (strcmp(instr, "jmp") == 0) {
+    n = store_le(bytes, n, 0 == form ? 0xEB : 0xE9, 1);
+    return store_le(bytes, n, args[0].value, 0 == form ? 1 : 4);
+  }
+  if (strcmp(instr, "call") == 0) {
+    n = store_le(bytes, n, 0xE8, 1);
+    return store_le(bytes, n, immediate_of_rel(&args[0]), 4);
+  }
+  if (strcmp(instr, "cmp") == 0) {
+    n = store_le(bytes, n, 0x3D, 1);
+    n = store_le(bytes, n, 0xF8 | register_code(args[0].type), 1);
+    return store_le(bytes, n, args[1].value, 4);
+  }
+  if (strcmp(instr, "movw") == 0) {
+    // big-endian: the opcode byte comes first.
+    const uint64_t u16 = args[1].value & 0xFFFF;
+    bytes[0] = 0x12;
+    bytes[1] = (uint8_t) register_code(args[0].type);
+    bytes[2] = (uint8_t) (u16 >> 8);
+    bytes[3] = (uint8_t) u16;
+    return 4;
+  }
+  if (strcmp(instr, "bl") == 0) {
+    // halfword order: the high halfword first, each halfword little-endian.
+    const uint32_t word = 0x1EU << 27 | (uint32_t) (args[0].value & 0xFFFF);
+    n = store_le(bytes, n, word >> 16, 2);
+    return store_le(bytes, n, word, 2);
+  }
+  if (strcmp(instr, "ext") == 0) {
+    // 0x7 : 0xFEDCBA9876543210AB : 0x5, a constant wider than one limb across both chunks.
+    const uint8_t ext[] = {0xB5, 0x0A, 0x21, 0x43, 0x65, 0x87, 0xA9, 0xCB, 0xED, 0x0F, 0x00, 0x70};
+    memcpy(bytes, ext, sizeof(ext));
+    return sizeof(ext);
+  }
+  if (strcmp(instr, "ret") == 0) { return store_le(bytes, n, 0xC3, 1); }
+  return 0;
+}
@@ -0,0 +1,133 @@
+machine reference {
+    register gpr [64-bit] {
+        r0: [63-0] = 0x0;
+        r1: [63-0] = 0x1;
+        r2: [63-0] = 0x2;
+        r3: [63-0] = 0x3;
+        r4: [63-0] = 0x4;
+        r5: [63-0] = 0x5;
+        r6: [63-0] = 0x6;
+        r7: [63-0] = 0x7;
+    };
+    register acc [64-bit] {
+        a0: [63-0] = 0x0;
+        a1: [63-0] = 0x1;
+        a2: [63-0] = 0x2;
+        a3: [63-0] = 0x3;
+    };
+    memory local [12-bit] {
+        $: [0-5];
+        >: [6-11];
+    };
+    immediate i8 [8-bit] signed;
+    immediate u16 [16-bit] unsigned;
+    immediate i32 [32-bit] signed;
+    set low { r0, r1, r2, r3 };
+    set rel { i8, i32 };
+    instruction mov {
+        [gpr, acc] = [2-byte] (1-tick) {
+            ~: [16] = {
+                [7-0] = 0x89,
+                [10-8] = gpr[2-0],
+                [12-11] = acc[1-0],
+                [...] = 0
+            };
+        };
+    };
+    instruction add {
+        [gpr, i8] = [3-byte] (1-tick) {
+            ^: [8] = 0x83;
+            ~: [16] = {
+                [2-0] = gpr[2-0],
+                [7-3] = 0x18,
+                [15-8] = i8
+            };
+        };
+        [gpr, i32] = [6-byte] (1-tick) {
+            ^: [8] = 0x81;
+            ~: [40] = {
+                [2-0] = gpr[2-0],
+                [7-3] = 0x18,
+                [39-8] = i32
+            };
+        };
+    };
+    instruction ld {
+        [acc, local] = [3-byte] (3-tick) {
+            ^: [8] = 0x8B;
+            ~: [16] = {
+                [1-0] = acc[1-0],
+                [7-2] = local.$,
+                [13-8] = local.>,
+                [...] = 0
+            };
+        };
+    };
+    instruction push {
+        [low] = [1-byte] (1-tick) {
+            ~: [8] = {
+                [1-0] = low[1-0],
+                [7-2] = 0x14
+            };
+        };
+    };
+    instruction jmp {
+        [i8] = [2-byte] (1-tick) {
+            ^: [8] = 0xEB;
+            ~: [8] = i8;
+        };
+        [i32] = [5-byte] (1-tick) {
+            ^: [8] = 0xE9;
+            ~: [32] = i32;
+        };
+    };
+    instruction call {
+        [rel] = [5-byte] (2-tick) {
+            ^: [8] = 0xE8;
+            ~: [32] = rel;
+        };
+    };
+    instruction cmp {
+        [acc, i32] = [6-byte] (1-tick) {
+            ^: [8] = 0x3D;
+            ~: [40] = {
+                [1-0] = acc[1-0],
+                [7-2] = 0x3E,
+                [39-8] = i32
+            };
+        };
+    };
+    instruction movw {
+        [gpr, u16] = [4-byte-be] (1-tick) {
+            ~: [32] = {
+                [31-24] = 0x12,
+                [18-16] = gpr[2-0],
+                [15-0] = u16,
+                [...] = 0
+            };
+        };
+    };
+    instruction bl {
+        [u16] = [4-byte-hw] (2-tick) {
+            ~: [32] = {
+                [31-27] = 0x1E,
+                [15-0] = u16,
+                [...] = 0
+            };
+        };
+    };
+    instruction ext {
+        [a1] = [12-byte] (1-tick) {
+            ~: [96] = {
+                [95-92] = 0x7,
+                [91-4] = 0xFEDCBA9876543210AB,
+                [3-0] = 0x5
+            };
+        };
+    };
+    instruction ret {
+        [a0] = [1-byte] (1-tick) {
+            ~: [8] = 0xC3;
+        };
+    };
+};
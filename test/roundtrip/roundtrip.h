@@ -0,0 +1,48 @@
+/**
+ * Project Name: machine
+ * Module Name: test/roundtrip
+ * Filename: roundtrip.h
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#ifndef MACHINE_ROUNDTRIP_H
+#define MACHINE_ROUNDTRIP_H
+
+#include "array.h"
+#include "char_t.h"
+#include <stdint.h>
+
+// The generated C and the grammar both define an `Entry`, so they meet only through these.
+// An operand is given like an `Operand` of the VM: `type` is an offset in the context.
+typedef struct GenOperand {
+  uint32_t type;
+  uint64_t value;
+} GenOperand;
+
+typedef uint32_t fn_roundtrip_encode(const GenOperand args[], Array *buffer);
+
+// `encode` calls the encoder of the form, `select` builds the operands through their
+// constructors and calls the selector of the instruction, which may pick another form.
+typedef struct RoundtripForm {
+  const char_t *name;
+  uint32_t index;  // of the form in its instruction
+  fn_roundtrip_encode *encode;
+  fn_roundtrip_encode *select;
+} RoundtripForm;
+
+// Defined by the thunks `gen-thunks` writes, in the order of the form ids.
+extern const RoundtripForm ROUNDTRIP_FORMS[];
+extern const uint32_t ROUNDTRIP_N_FORMS;
+
+// Encodes fixed operands through the generated selectors, returns how many picked wrong.
+uint32_t check_selectors(Array *buffer);
+
+// Encodes a form of `reference.mm` by hand, from the bit layouts written in the description
+// rather than from the parsed machine. Returns 0 for a form it does not know.
+uint32_t oracle_encode(
+    const char_t *instr, uint32_t form, const GenOperand args[], uint8_t bytes[]
+);
+
+#endif  // MACHINE_ROUNDTRIP_H
@@ -0,0 +1,81 @@
+/**
+ * Project Name: machine
+ * Module Name: test/roundtrip
+ * Filename: selectors.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "reference.gen.h"
+#include "roundtrip.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct SelectCase {
+  const char *name;
+  uint32_t size;
+  uint8_t bytes[8];
+} SelectCase;
+
+uint32_t check_select_case(const SelectCase *expected, uint32_t size, Array *buffer);
+
+uint32_t check_select_case(const SelectCase *expected, uint32_t size, Array *buffer) {
+  const uint8_t *bytes = Array_real_addr(buffer, 0);
+  const bool same = size == expected->size && Array_length(buffer) == size &&
+                    memcmp(bytes, expected->bytes, size) == 0;
+  if (!same) {
+    fprintf(stderr, "%s: selected", expected->name);
+    for (uint32_t k = 0; k < Array_length(buffer); k++) { fprintf(stderr, " %02x", bytes[k]); }
+    fprintf(stderr, "\n");
+  }
+  Array_reset(buffer, nullptr);
+  return same ? 0 : 1;
+}
+
+// An operand is built from the immediate of its own type, and the selector picks the short
+// form whenever its value, sign-extended from that type, fits.
+uint32_t check_selectors(Array *buffer) {
+  static const SelectCase CASES[] = {
+      {"jmp i32(-2)", 2, {0xEB, 0xFE}},
+      {"jmp i32(-200)", 5, {0xE9, 0x38, 0xFF, 0xFF, 0xFF}},
+      {"jmp i8(-128)", 2, {0xEB, 0x80}},
+      {"jmp u16(0xFE)", 5, {0xE9, 0xFE, 0x00, 0x00, 0x00}},
+      {"add r1, i32(-2)", 3, {0x83, 0xC1, 0xFE}},
+      {"call i8(-5)", 5, {0xE8, 0xFB, 0xFF, 0xFF, 0xFF}},
+      {"call u16(5)", 0, {}},
+      {"cmp a0, i8(-5)", 6, {0x3D, 0xF8, 0xFB, 0xFF, 0xFF, 0xFF}},
+  };
+  const Entry operands[] = {
+      IMM_i32((uint64_t) -2), IMM_i32((uint64_t) -200), IMM_i8((uint64_t) -128), IMM_u16(0xFE),
+  };
+  uint32_t failed = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    failed += check_select_case(&CASES[i], encode_jmp_i(&operands[i], buffer), buffer);
+  }
+  failed += check_select_case(&CASES[4], encode_add_ri(REG_r1, &operands[0], buffer), buffer);
+  // a signed member of a set fills the wider field of the set with its sign.
+  const Entry rel8 = IMM_i8((uint64_t) -5), u16 = IMM_u16(5);
+  failed += check_select_case(&CASES[5], encode_call_i(&rel8, buffer), buffer);
+  failed += check_select_case(&CASES[6], encoding_call_0(&u16, buffer), buffer);
+  // and so does an immediate of a narrower type than the form the selector picks.
+  failed += check_select_case(&CASES[7], encode_cmp_ri(REG_a0, &rel8, buffer), buffer);
+
+  // operands of another kind, whose ids are the ones of accepted operands, encode nothing.
+  static const SelectCase REJECTED[] = {
+      {"jmp r0", 0, {}},
+      {"push i8(0)", 0, {}},
+      {"push local(0, 0)", 0, {}},
+      {"ld a0, i8(0)", 0, {}},
+      {"add i8(0), i8(0)", 0, {}},
+      {"encoding_push_0 local(0, 0)", 0, {}},
+  };
+  const Entry imm = IMM_i8(0), mem = MEM_local(0, 0);
+  failed += check_select_case(&REJECTED[0], encode_jmp_i(REG_r0, buffer), buffer);
+  failed += check_select_case(&REJECTED[1], encode_push_r(&imm, buffer), buffer);
+  failed += check_select_case(&REJECTED[2], encode_push_r(&mem, buffer), buffer);
+  failed += check_select_case(&REJECTED[3], encode_ld_rm(REG_a0, &imm, buffer), buffer);
+  failed += check_select_case(&REJECTED[4], encode_add_ri(&imm, &imm, buffer), buffer);
+  failed += check_select_case(&REJECTED[5], encoding_push_0(&mem, buffer), buffer);
+  return failed;
+}
@@ -0,0 +1,497 @@
+/**
+ * Project Name: machine
+ * Module Name: test/roundtrip
+ * Filename: test-roundtrip.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "array.h"
+#include "char_t.h"
+#include "context.h"
+#include "decode.h"
+#include "enum.h"
+#include "jit.h"
+#include "parse.h"
+#include "roundtrip.h"
+#include "source.h"
+#include "target.h"
+#include "tokens.gen.h"
+#include "vm.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RING_CAPACITY 64
+
+typedef struct FormCase {
+  const InstrForm *form;
+  uint32_t n_args;
+  Operand *args;  // `n_samples` tuples
+} FormCase;
+
+typedef struct Stats {
+  uint32_t checked;
+  uint32_t failed;
+  uint32_t aliased;
+  uint32_t undecodable;
+} Stats;
+
+uint64_t next_random(uint64_t *seed);
+uint64_t field_mask(const BitField *bf);
+bool sample_operand(GContext *context, const Identifier *arg, uint64_t *seed, Operand *operand);
+uint64_t expected_value(
+    GContext *context, const EncodingVM *vm, const Identifier *arg, const Operand *operand
+);
+uint64_t decoded_mask(const Disassembler *disasm, uint32_t form, uint32_t arg);
+bool same_bytes(const char *encoder, uint32_t id, Array *bytes, uint32_t size, Array *reference);
+bool fits_immediate(const Immediate *imm, uint64_t value);
+bool accepts_operand(GContext *context, const Identifier *arg, const Operand *operand);
+char_t operand_kind(GContext *context, const Record *record);
+uint32_t picked_form(
+    GContext *context, const Instruction *instr, uint32_t form, const Operand args[]
+);
+void check_oracle(uint32_t id, const Operand args[], Array *reference, Stats *stats);
+void check_selected(
+    GContext *context, const EncodingVM *vm, const Instruction *instr, uint32_t first_id,
+    uint32_t id, const Operand args[], Array *generated, Array *reference, Stats *stats
+);
+void check_sample(
+    GContext *context, const EncodingVM *vm, const EncodingJIT *jit, const Disassembler *disasm,
+    const FormCase *fc, uint32_t id, const Operand args[], Array *generated, Array *reference,
+    Stats *stats
+);
+double time_encode(
+    const FormCase *fc, uint32_t id, uint32_t n_samples, uint64_t rounds, Array *buffer
+);
+double time_decode(
+    const Disassembler *disasm, Array *buffer, uint32_t n_samples, uint64_t rounds
+);
+uint32_t check_format(const Disassembler *disasm);
+double elapsed_ns(const struct timespec *start, const struct timespec *end);
+Machine *load_machine(const char_t *path);
+
+// xorshift64, so a failure shows up again with the same seed.
+uint64_t next_random(uint64_t *seed) {
+  *seed ^= *seed << 13;
+  *seed ^= *seed >> 7;
+  *seed ^= *seed << 17;
+  return *seed;
+}
+
+uint64_t field_mask(const BitField *bf) {
+  const uint32_t width = bf->upper - bf->lower + 1;
+  return (width >= 64 ? UINT64_MAX : (1LLU << width) - 1) << bf->lower;
+}
+
+// A random operand the argument accepts, with every bit of its value in range.
+bool sample_operand(GContext *context, const Identifier *arg, uint64_t *seed, Operand *operand) {
+  const Record *record = GContext_findRecord(context, arg);
+  if (!record) { return false; }
+  const uint64_t random = next_random(seed);
+  *operand = (Operand) {.type = record->offset, .value = 0};
+  switch (record->typeid) {
+    case enum_RegisterGroup: {
+      const RegisterGroup *grp = GContext_getRegisterGroup(context, record->offset);
+      const Register *regs = Array_real_addr(context->regArray, 0);
+      const uint32_t n_regs = Array_length(grp->registers);
+      const Register *reg = Array_vert2real(
+          context->regArray, *(REFER(Register) *) Array_real_addr(grp->registers, random % n_regs)
+      );
+      operand->type = reg - regs;
+      return true;
+    }
+    case enum_Immediate: {
+      // a signed immediate is given as its value, as a caller passes it to `IMM_<name>`.
+      const Immediate *imm = GContext_getImmediate(context, record->offset);
+      const uint32_t shift = imm->width >= 64 ? 0 : 64 - imm->width;
+      const bool is_signed = IT_SIGNED == imm->type;
+      operand->value = is_signed ? (uint64_t) ((int64_t) (random << shift) >> shift)
+                                 : (random << shift) >> shift;
+      return true;
+    }
+    case enum_Memory: {
+      const Memory *mem = GContext_getMemory(context, record->offset);
+      operand->value = random & (field_mask(mem->base) | field_mask(mem->offset));
+      return true;
+    }
+    case enum_Set: {
+      const Set *set = GContext_getSet(context, record->offset);
+      const SetItem *items = Array_real_addr(set->items, 0);
+      const Identifier *item = items[random % Array_length(set->items)].name;
+      return sample_operand(context, item, seed, operand);
+    }
+  }
+  return true;
+}
+
+// What the disassembler reads back: the code of a register, or the value of others, which
+// for a signed immediate is already sign-extended.
+uint64_t expected_value(
+    GContext *context, const EncodingVM *vm, const Identifier *arg, const Operand *operand
+) {
+  const Record *record = GContext_findRecord(context, arg);
+  uint32_t typeid = record->typeid;
+  if (enum_Set == typeid) { typeid = GContext_getSet(context, record->offset)->type; }
+  const bool is_register = enum_Register == typeid || enum_RegisterGroup == typeid;
+  return is_register ? vm->regCodes[operand->type] : operand->value;
+}
+
+// The bits of an argument a form encodes, only those can be compared.
+uint64_t decoded_mask(const Disassembler *disasm, uint32_t form, uint32_t arg) {
+  const DecodeForm *decode_form = Array_real_addr(disasm->forms, form);
+  uint64_t mask = 0;
+  for (uint32_t r = 0; r < decode_form->n_runs; r++) {
+    const DecodeRun *run = Array_real_addr(disasm->runs, decode_form->start_run + r);
+    if (run->arg == arg) { mask |= ((1LLU << run->length) - 1) << run->arg_bit; }
+  }
+  return mask;
+}
+
+// Whether an encoder wrote the `size` bytes of the VM in `reference`.
+bool same_bytes(const char *encoder, uint32_t id, Array *bytes, uint32_t size, Array *reference) {
+  const uint8_t *code = Array_real_addr(bytes, 0);
+  if (size == Array_length(reference) && memcmp(code, Array_real_addr(reference, 0), size) == 0) {
+    return true;
+  }
+  fprintf(stderr, "%s#%u: %s and the VM differ:", ROUNDTRIP_FORMS[id].name, id, encoder);
+  for (uint32_t k = 0; k < size; k++) { fprintf(stderr, " %02x", code[k]); }
+  fprintf(stderr, "\n");
+  return false;
+}
+
+bool fits_immediate(const Immediate *imm, uint64_t value) {
+  if (imm->width >= 64) { return true; }
+  if (IT_SIGNED != imm->type) { return value >> imm->width == 0; }
+  const int64_t bound = (int64_t) 1 << (imm->width - 1);
+  return -bound <= (int64_t) value && (int64_t) value < bound;
+}
+
+// The kind of the operands of an argument, as the letters in the names of the selectors.
+char_t operand_kind(GContext *context, const Record *record) {
+  uint32_t typeid = record->typeid;
+  if (enum_Set == typeid) { typeid = GContext_getSet(context, record->offset)->type; }
+  switch (typeid) {
+    case enum_Memory: return 'm';
+    case enum_Immediate: return 'i';
+  }
+  return 'r';
+}
+
+// Whether a form of the argument takes the operand, by the items of the description.
+bool accepts_operand(GContext *context, const Identifier *arg, const Operand *operand) {
+  const Record *record = GContext_findRecord(context, arg);
+  switch (record->typeid) {
+    case enum_Register:
+    case enum_Memory: return record->offset == operand->type;
+    case enum_Immediate: {
+      return fits_immediate(GContext_getImmediate(context, record->offset), operand->value);
+    }
+    case enum_RegisterGroup: {
+      const RegisterGroup *grp = GContext_getRegisterGroup(context, record->offset);
+      const Register *regs = Array_real_addr(context->regArray, 0);
+      for (uint32_t i = 0; i < Array_length(grp->registers); i++) {
+        REFER(Register) reg = *(REFER(Register) *) Array_real_addr(grp->registers, i);
+        if ((const Register *) Array_vert2real(context->regArray, reg) - regs == operand->type) {
+          return true;
+        }
+      }
+      return false;
+    }
+    case enum_Set: {
+      const Set *set = GContext_getSet(context, record->offset);
+      const SetItem *items = Array_real_addr(set->items, 0);
+      for (uint32_t i = 0; i < Array_length(set->items); i++) {
+        const Record *item = GContext_findRecord(context, items[i].name);
+        if (item->offset == operand->type) { return true; }
+      }
+      return false;
+    }
+  }
+  return false;
+}
+
+// The form a selector has to pick: of the forms whose arguments are of the kinds of `form`,
+// the narrowest which takes the operands, the first defined of the same width.
+uint32_t picked_form(
+    GContext *context, const Instruction *instr, uint32_t form, const Operand args[]
+) {
+  const InstrForm *forms = Array_real_addr(instr->forms, 0);
+  PatternArgs *own = forms[form].pattern->args;
+  const uint32_t n_args = own ? Array_length(own) : 0;
+  uint32_t picked = form;
+  for (uint32_t k = 0; k < Array_length(instr->forms); k++) {
+    PatternArgs *pattern_args = forms[k].pattern->args;
+    if ((pattern_args ? Array_length(pattern_args) : 0) != n_args) { continue; }
+    bool takes = forms[k].width < forms[picked].width ||
+                 (forms[k].width == forms[picked].width && k < picked);
+    for (uint32_t j = 0; takes && j < n_args; j++) {
+      const Identifier *arg = Array_real_addr(pattern_args, j);
+      const Record *record = GContext_findRecord(context, arg);
+      const Record *own_record = GContext_findRecord(context, Array_real_addr(own, j));
+      takes = operand_kind(context, record) == operand_kind(context, own_record) &&
+              accepts_operand(context, arg, &args[j]);
+    }
+    if (takes) { picked = k; }
+  }
+  return picked;
+}
+
+// The bytes of the VM in `reference` against the ones written by hand for `reference.mm`.
+void check_oracle(uint32_t id, const Operand args[], Array *reference, Stats *stats) {
+  uint8_t bytes[MAX_VM_FORM_BYTES] = {};
+  const RoundtripForm *rf = &ROUNDTRIP_FORMS[id];
+  const uint32_t size = oracle_encode(rf->name, rf->index, (const GenOperand *) args, bytes);
+  if (0 == size) { return; }
+  if (size == Array_length(reference) && memcmp(bytes, Array_real_addr(reference, 0), size) == 0) {
+    return;
+  }
+  fprintf(stderr, "%s#%u: the VM and the oracle differ:", rf->name, id);
+  for (uint32_t k = 0; k < size; k++) { fprintf(stderr, " %02x", bytes[k]); }
+  fprintf(stderr, "\n");
+  stats->failed++;
+}
+
+// The selector of the instruction, given the operands built by their constructors, has to
+// write the bytes of the VM for the form it should pick.
+void check_selected(
+    GContext *context, const EncodingVM *vm, const Instruction *instr, uint32_t first_id,
+    uint32_t id, const Operand args[], Array *generated, Array *reference, Stats *stats
+) {
+  const uint32_t picked = first_id + picked_form(context, instr, id - first_id, args);
+  Array_reset(reference, nullptr);
+  EncodingVM_encode(vm, picked, args, reference);
+  Array_reset(generated, nullptr);
+  const uint32_t size = ROUNDTRIP_FORMS[id].select((const GenOperand *) args, generated);
+  if (!same_bytes("the selector", id, generated, size, reference)) { stats->failed++; }
+}
+
+// The generated encoder, the JIT and the VM have to agree on every byte, and the disassembler
+// has to find the form and its arguments again. Another form decoding the same bytes is an
+// alias of the machine, not a failure.
+void check_sample(
+    GContext *context, const EncodingVM *vm, const EncodingJIT *jit, const Disassembler *disasm,
+    const FormCase *fc, uint32_t id, const Operand args[], Array *generated, Array *reference,
+    Stats *stats
+) {
+  Array_reset(reference, nullptr);
+  EncodingVM_encode(vm, id, args, reference);
+  stats->checked++;
+  check_oracle(id, args, reference, stats);
+  Array_reset(generated, nullptr);
+  const uint32_t jit_size = EncodingJIT_encode(jit, id, args, generated);
+  if (!same_bytes("the JIT", id, generated, jit_size, reference)) {
+    stats->failed++;
+    return;
+  }
+  Array_reset(generated, nullptr);
+  const uint32_t size = ROUNDTRIP_FORMS[id].encode((const GenOperand *) args, generated);
+  if (!same_bytes("the generated C", id, generated, size, reference)) {
+    stats->failed++;
+    return;
+  }
+  const uint8_t *bytes = Array_real_addr(generated, 0);
+
+  const DecodeForm *decode_form = Array_real_addr(disasm->forms, id);
+  if (0 == decode_form->size) {
+    stats->undecodable++;
+    return;
+  }
+  DecodedRecord record = {};
+  DecodeRing ring = {.records = &record, .capacity = 1};
+  size_t consumed = 0;
+  Disassembler_decode(disasm, bytes, size, 0, &consumed, &ring);
+  if (record.form != id) {
+    if (record.length == size && DECODE_UNKNOWN != record.form) {
+      stats->aliased++;
+      return;
+    }
+    fprintf(stderr, "%s#%u: decoded as form %u.\n", ROUNDTRIP_FORMS[id].name, id, record.form);
+    stats->failed++;
+    return;
+  }
+  const Identifier *idents = fc->n_args ? Array_real_addr(fc->form->pattern->args, 0) : nullptr;
+  for (uint32_t j = 0; j < fc->n_args; j++) {
+    const uint64_t mask = decoded_mask(disasm, id, j);
+    const uint64_t expected = expected_value(context, vm, &idents[j], &args[j]) & mask;
+    if (record.args[j] != expected) {
+      fprintf(
+          stderr, "%s#%u: argument %u decoded as 0x%lx, not 0x%lx.\n", ROUNDTRIP_FORMS[id].name,
+          id, j, record.args[j], expected
+      );
+      stats->failed++;
+      return;
+    }
+  }
+}
+
+// Encodes the samples of a form `rounds` times, and leaves one round of them in `buffer`.
+double time_encode(
+    const FormCase *fc, uint32_t id, uint32_t n_samples, uint64_t rounds, Array *buffer
+) {
+  struct timespec start = {}, end = {};
+  timespec_get(&start, TIME_UTC);
+  for (uint64_t r = 0; r < rounds; r++) {
+    Array_reset(buffer, nullptr);
+    for (uint32_t s = 0; s < n_samples; s++) {
+      ROUNDTRIP_FORMS[id].encode((const GenOperand *) &fc->args[s * fc->n_args], buffer);
+    }
+  }
+  timespec_get(&end, TIME_UTC);
+  return elapsed_ns(&start, &end) / (double) (rounds * n_samples);
+}
+
+double time_decode(
+    const Disassembler *disasm, Array *buffer, uint32_t n_samples, uint64_t rounds
+) {
+  DecodedRecord records[RING_CAPACITY];
+  const uint8_t *code = Array_real_addr(buffer, 0);
+  const size_t size = Array_length(buffer);
+  struct timespec start = {}, end = {};
+  timespec_get(&start, TIME_UTC);
+  for (uint64_t r = 0; r < rounds; r++) {
+    DecodeRing ring = {.records = records, .capacity = RING_CAPACITY};
+    size_t consumed = 0;
+    while (consumed < size) {
+      Disassembler_decode(disasm, code, size, 0, &consumed, &ring);
+      ring.head = (ring.head + ring.count) % ring.capacity;
+      ring.count = 0;
+    }
+  }
+  timespec_get(&end, TIME_UTC);
+  return elapsed_ns(&start, &end) / (double) (rounds * n_samples);
+}
+
+// The `i8` of the first `add` form is written sign-extended from its 8 bits.
+uint32_t check_format(const Disassembler *disasm) {
+  static const struct {
+    uint64_t value;
+    const char_t *text;
+  } CASES[] = {
+      {0xFB, "add r1, -0x5"},
+      {0x80, "add r1, -0x80"},
+      {0x7F, "add r1, 0x7f"},
+  };
+  const DecodeForm *forms = Array_real_addr(disasm->forms, 0);
+  uint32_t id = 0;
+  while (id < Array_length(disasm->forms) && strcmp(forms[id].name, "add") != 0) { id++; }
+  if (id == Array_length(disasm->forms)) { return 0; }
+  uint32_t failed = 0;
+  for (uint32_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    const DecodedRecord record = {.form = id, .args = {1, CASES[i].value}};
+    char_t text[64];
+    Disassembler_format(disasm, &record, text, sizeof(text));
+    if (strcmp(text, CASES[i].text) != 0) {
+      fprintf(
+          stderr, "0x%lx formatted as \"%s\", not \"%s\".\n", CASES[i].value, text,
+          CASES[i].text
+      );
+      failed++;
+    }
+  }
+  return failed;
+}
+
+double elapsed_ns(const struct timespec *start, const struct timespec *end) {
+  return (double) (end->tv_sec - start->tv_sec) * 1e9 + (double) (end->tv_nsec - start->tv_nsec);
+}
+
+Machine *load_machine(const char_t *path) {
+  uint32_t cost = 0, stage = 0;
+  Machine *machine = parse_file(path, &cost, &stage, nullptr, nullptr, &STDAllocator);
+  if (LOAD_READ == stage) { fprintf(stderr, "failed to read %s.\n", path); }
+  return machine;
+}
+
+// usage: test-roundtrip [--samples=<n>] [--rounds=<n>] [--seed=<n>] [<machine description>]
+// The machine has to be the one the encoders were generated from, `reference.mm` by default.
+// Every form is encoded with random operands by the generated C, the JIT and the VM, the bytes
+// are compared and decoded back; then the time of one encoding and one decoding is reported.
+int main(int argc, char *argv[]) {
+  uint32_t n_samples = 256;
+  uint64_t rounds = 1000, seed = 0x9E3779B97F4A7C15LLU;
+  const char_t *path = ROUNDTRIP_MACHINE;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "--samples=", 10) == 0) {
+      n_samples = strtoul(argv[i] + 10, nullptr, 10);
+    } else if (strncmp(argv[i], "--rounds=", 9) == 0) {
+      rounds = strtoull(argv[i] + 9, nullptr, 10);
+    } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+      seed = strtoull(argv[i] + 7, nullptr, 10) | 1;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (0 == n_samples || 0 == rounds) { return -1; }
+
+  Machine *machine = load_machine(path);
+  if (!machine) { return -2; }
+  GContext *context = machine->context;
+  EncodingVM *vm = EncodingVM_new(machine, &STDAllocator);
+  EncodingJIT *jit = EncodingJIT_new(vm);
+  Disassembler *disasm = Disassembler_new(machine, vm);
+  const uint32_t n_forms = EncodingVM_countForms(vm);
+  if (n_forms != ROUNDTRIP_N_FORMS) {
+    fprintf(stderr, "%s has %u forms, the encoders %u.\n", path, n_forms, ROUNDTRIP_N_FORMS);
+    return -3;
+  }
+
+  Array *generated = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  Array *reference = Array_new(sizeof(uint8_t), -1, &STDAllocator);
+  Operand *args = STDAllocator.calloc(n_samples * MAX_DECODE_ARGS, sizeof(Operand));
+  Stats stats = {};
+  uint32_t id = 0;
+  const uint32_t n_entries = Array_length(machine->entries);
+  printf("%-16s %6s %12s %12s\n", "instruction", "form", "encode(ns)", "decode(ns)");
+  for (uint32_t e = 0; e < n_entries; e++) {
+    const Entry *entry = Array_real_addr(machine->entries, e);
+    if (enum_Instruction != entry->type) { continue; }
+    const Instruction *instr = entry->target;
+    const InstrForm *forms = Array_real_addr(instr->forms, 0);
+    for (uint32_t i = 0; i < Array_length(instr->forms); i++, id++) {
+      PatternArgs *pattern_args = forms[i].pattern->args;
+      const FormCase fc = {
+          .form = &forms[i],
+          .n_args = pattern_args ? Array_length(pattern_args) : 0,
+          .args = args,
+      };
+      const VMForm *vm_form = Array_real_addr(vm->forms, id);
+      if (VM_INVALID_FORM == vm_form->start || fc.n_args > MAX_DECODE_ARGS) {
+        printf("%-16s %6u %12s %12s\n", instr->name->ptr, id, "-", "-");
+        continue;
+      }
+      for (uint32_t s = 0; s < n_samples; s++) {
+        Operand *tuple = &args[s * fc.n_args];
+        for (uint32_t j = 0; j < fc.n_args; j++) {
+          sample_operand(context, Array_real_addr(pattern_args, j), &seed, &tuple[j]);
+        }
+        check_sample(context, vm, jit, disasm, &fc, id, tuple, generated, reference, &stats);
+        check_selected(context, vm, instr, id - i, id, tuple, generated, reference, &stats);
+      }
+      const double encode_ns = time_encode(&fc, id, n_samples, rounds, generated);
+      const double decode_ns = time_decode(disasm, generated, n_samples, rounds);
+      printf("%-16s %6u %12.2f %12.2f\n", instr->name->ptr, id, encode_ns, decode_ns);
+    }
+  }
+  Array_reset(generated, nullptr);
+  stats.failed += check_selectors(generated);
+  stats.failed += check_format(disasm);
+  printf(
+      "checked: %u, failed: %u, aliased: %u, not decodable: %u\n", stats.checked, stats.failed,
+      stats.aliased, stats.undecodable
+  );
+
+  STDAllocator.free(args);
+  releasePrimeArray(reference);
+  releasePrimeArray(generated);
+  Disassembler_destroy(disasm);
+  EncodingJIT_destroy(jit);
+  EncodingVM_destroy(vm);
+  releaseMachine(machine, &STDAllocator);
+  STDAllocator.free(machine);
+  return stats.failed ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+/**
+ * Project Name: machine
+ * Module Name: test
+ * Filename: test-parse.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "parse/test-parse.h"
+#include <check.h>
+
+int main() {
+  SRunner *srunner = srunner_create(nullptr);
+  srunner_add_suite(srunner, recovery_suite());
+  srunner_set_fork_status(srunner, CK_NOFORK);
+  srunner_run_all(srunner, CK_NORMAL);
+  int n_failed = srunner_ntests_failed(srunner);
+  srunner_free(srunner);
+
+  return n_failed ? -1 : 0;
+}
@@ -17,6 +17,7 @@ int main() {
   srunner_add_suite(srunner, number_suite());
   srunner_add_suite(srunner, identifier_suite());
   srunner_add_suite(srunner, united_suite());
+  srunner_add_suite(srunner, source_suite());
   srunner_set_fork_status(srunner, CK_NOFORK);
   srunner_run_all(srunner, CK_NORMAL);
   int n_failed = srunner_ntests_failed(srunner);
@@ -9,11 +9,13 @@
 
 #include "allocator.h"
 #include "char_t.h"
+#include "number.h"
 #include "terminal.h"
 #include "tokenize.h"
 #include "tokens.gen.h"
 #include <check.h>
 #include <stdint.h>
+#include <string.h>
 
 #define lenof(str_literal) ((sizeof str_literal) - 1)
 
@@ -173,6 +175,58 @@ START_TEST(test_NUMBER_r2_failed) {
 }
 END_TEST
 
+START_TEST(test_NUMBER_r16_wide) {
+  const char_t *string = "0x0123456789abcdefFEDCBA9876543210";
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(string, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  ck_assert_uint_eq(cost, lenof("0x0123456789abcdefFEDCBA9876543210"));
+  ck_assert_uint_eq(n_tokens, 2);
+  ck_assert_ptr_ne(terminals, nullptr);
+  ck_assert_uint_eq(terminals[0].type, enum_NUMBER);
+  ck_assert_uint_eq(terminals[0].length, lenof("0x0123456789abcdefFEDCBA9876543210"));
+  ck_assert(isWideNumber(terminals[0].value));
+  ck_assert_uint_eq(Number_countLimbs(terminals[0].value), 2);
+  ck_assert_uint_eq(Number_getLimb(terminals[0].value, 0), 0xFEDCBA9876543210LLU);
+  ck_assert_uint_eq(Number_getLimb(terminals[0].value, 1), 0x0123456789abcdefLLU);
+  ck_assert_uint_eq(terminals[1].type, enum_TERMINATOR);
+  releaseNumber(terminals[0].value, &STDAllocator);
+  STDAllocator.free((void *) terminals);
+}
+END_TEST
+
+START_TEST(test_NUMBER_r10_wide) {
+  const char_t *string = "18446744073709551616";
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(string, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  ck_assert_uint_eq(cost, lenof("18446744073709551616"));
+  ck_assert_uint_eq(n_tokens, 2);
+  ck_assert_ptr_ne(terminals, nullptr);
+  ck_assert_uint_eq(terminals[0].type, enum_NUMBER);
+  ck_assert(isWideNumber(terminals[0].value));
+  ck_assert_uint_eq(Number_countLimbs(terminals[0].value), 2);
+  ck_assert_uint_eq(Number_getLimb(terminals[0].value, 0), 0);
+  ck_assert_uint_eq(Number_getLimb(terminals[0].value, 1), 1);
+  releaseNumber(terminals[0].value, &STDAllocator);
+  STDAllocator.free((void *) terminals);
+}
+END_TEST
+
+START_TEST(test_NUMBER_r16_overflow) {
+  // one digit more than MAX_NUMBER_LIMBS limbs hold.
+  char_t string[2 + MAX_NUMBER_LIMBS * 16 + 2] = "0x1";
+  memset(string + 3, 'f', MAX_NUMBER_LIMBS * 16);
+  string[sizeof(string) - 1] = '\0';
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(string, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  ck_assert_uint_eq(cost, 0);
+  ck_assert_uint_eq(n_tokens, 0);
+  ck_assert_ptr_eq(terminals, nullptr);
+}
+END_TEST
+
 Suite *number_suite() {
   Suite *suite = suite_create("Numbers");
   TCase *tc_numbers = tcase_create("numbers");
@@ -184,6 +238,9 @@ Suite *number_suite() {
   tcase_add_test(tc_numbers, test_NUMBER_r10_failed);
   tcase_add_test(tc_numbers, test_NUMBER_r8_failed);
   tcase_add_test(tc_numbers, test_NUMBER_r2_failed);
+  tcase_add_test(tc_numbers, test_NUMBER_r16_wide);
+  tcase_add_test(tc_numbers, test_NUMBER_r10_wide);
+  tcase_add_test(tc_numbers, test_NUMBER_r16_overflow);
   suite_add_tcase(suite, tc_numbers);
   return suite;
 }
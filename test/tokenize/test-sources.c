@@ -0,0 +1,117 @@
+/**
+ * Project Name: machine
+ * Module Name: test/tokenize
+ * Filename: test-sources.c
+ * Creator: Yaokai Liu
+ * Create Date: 2026-10-19
+ * Copyright (c) 2026 Yaokai Liu. All rights reserved.
+ **/
+
+#include "allocator.h"
+#include "char_t.h"
+#include "source.h"
+#include "target.h"
+#include "terminal.h"
+#include "tokenize.h"
+#include "tokens.gen.h"
+#include <check.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+START_TEST(test_sources_merged) {
+  const Source sources[] = {
+      {.path = "main.mm", .text = "machine abc {\n", .lineno = 0},
+      {.path = "regs.mm", .text = "  set s { a };\n", .lineno = 0},
+      {.path = "main.mm", .text = "};\n", .lineno = 2},
+  };
+  uint32_t cost = 0, n_tokens = 0, failed = 0;
+  const Terminal *terminals =
+      tokenize_sources(sources, 3, &cost, &n_tokens, &failed, &STDAllocator);
+  ck_assert_ptr_ne(terminals, nullptr);
+  ck_assert_uint_eq(failed, 3);
+  ck_assert_uint_eq(n_tokens, 12);
+  const uint32_t types[] = {
+      enum_MACHINE,    enum_IDENTIFIER,    enum_LEFT_BRACKET, enum_SET,
+      enum_IDENTIFIER, enum_LEFT_BRACKET,  enum_IDENTIFIER,   enum_RIGHT_BRACKET,
+      enum_SEMICOLON,  enum_RIGHT_BRACKET, enum_SEMICOLON,    enum_TERMINATOR,
+  };
+  for (uint32_t i = 0; i < n_tokens; i++) { ck_assert_uint_eq(terminals[i].type, types[i]); }
+  ck_assert_uint_eq(terminals[3].lineno, 0);
+  ck_assert_uint_eq(terminals[3].column, 2);
+  ck_assert_uint_eq(terminals[9].lineno, 2);
+  ck_assert_uint_eq(terminals[9].column, 0);
+  for (uint32_t i = 0; i < n_tokens; i++) {
+    releaseToken(terminals[i].value, terminals[i].type, &STDAllocator);
+  }
+  STDAllocator.free((void *) terminals);
+}
+END_TEST
+
+START_TEST(test_sources_failed) {
+  const Source sources[] = {
+      {.path = "main.mm", .text = "machine abc {\n", .lineno = 0},
+      {.path = "alu.mm", .text = "  set 12ab", .lineno = 0},
+  };
+  uint32_t cost = 0, n_tokens = 0, failed = 0;
+  const Terminal *terminals =
+      tokenize_sources(sources, 2, &cost, &n_tokens, &failed, &STDAllocator);
+  ck_assert_ptr_eq(terminals, nullptr);
+  ck_assert_uint_eq(n_tokens, 0);
+  ck_assert_uint_eq(failed, 1);
+}
+END_TEST
+
+// More sources than workers: every worker lexes every `MAX_LEX_WORKERS`-th one.
+START_TEST(test_sources_workers) {
+  enum { N_SOURCES = 3 * MAX_LEX_WORKERS + 1 };
+  Source sources[N_SOURCES] = {};
+  for (uint32_t i = 0; i < N_SOURCES; i++) {
+    sources[i] = (Source) {.path = "main.mm", .text = "a\n", .lineno = i};
+  }
+  uint32_t cost = 0, n_tokens = 0, failed = 0;
+  const Terminal *terminals =
+      tokenize_sources(sources, N_SOURCES, &cost, &n_tokens, &failed, &STDAllocator);
+  ck_assert_ptr_ne(terminals, nullptr);
+  ck_assert_uint_eq(n_tokens, N_SOURCES + 1);
+  for (uint32_t i = 0; i < N_SOURCES; i++) {
+    ck_assert_uint_eq(terminals[i].type, enum_IDENTIFIER);
+    ck_assert_uint_eq(terminals[i].lineno, i);
+  }
+  ck_assert_uint_eq(terminals[N_SOURCES].type, enum_TERMINATOR);
+  for (uint32_t i = 0; i < n_tokens; i++) {
+    releaseToken(terminals[i].value, terminals[i].type, &STDAllocator);
+  }
+  STDAllocator.free((void *) terminals);
+}
+END_TEST
+
+// `#imports` is not `#import`: the line stays in the text instead of importing `none.mm`.
+START_TEST(test_sources_import_delimiter) {
+  char path[] = "/tmp/machine-sourcesXXXXXX";
+  const int fd = mkstemp(path);
+  ck_assert_int_ge(fd, 0);
+  const char text[] = "#imports \"none.mm\"\nmachine abc {};\n";
+  ck_assert_int_eq(write(fd, text, sizeof(text) - 1), sizeof(text) - 1);
+  close(fd);
+  Array *sources = Array_new(sizeof(Source), -1, &STDAllocator);
+  ck_assert_int_eq(load_sources(path, sources, &STDAllocator), 0);
+  ck_assert_uint_eq(Array_length(sources), 1);
+  const Source *source = Array_real_addr(sources, 0);
+  ck_assert_str_eq(source->text, text);
+  release_sources(sources, &STDAllocator);
+  remove(path);
+}
+END_TEST
+
+Suite *source_suite() {
+  Suite *suite = suite_create("Sources");
+  TCase *tc_sources = tcase_create("sources");
+  tcase_add_test(tc_sources, test_sources_merged);
+  tcase_add_test(tc_sources, test_sources_failed);
+  tcase_add_test(tc_sources, test_sources_workers);
+  tcase_add_test(tc_sources, test_sources_import_delimiter);
+  suite_add_tcase(suite, tc_sources);
+  return suite;
+}
@@ -17,5 +17,6 @@ Suite *keyword_suite();
 Suite *number_suite();
 Suite *identifier_suite();
 Suite *united_suite();
+Suite *source_suite();
 
 #endif  // MACHINE_TEST_TOKENIZE_H
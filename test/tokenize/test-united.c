@@ -9,6 +9,7 @@
 
 #include "allocator.h"
 #include "char_t.h"
+#include "enum.h"
 #include "terminal.h"
 #include "tokenize.h"
 #include "tokens.gen.h"
@@ -194,6 +195,43 @@ START_TEST(test_WIDTH_byte) {
 }
 END_TEST
 
+START_TEST(test_WIDTH_order) {
+  const char_t *string = "[32-bit-be][4-byte-hw]";
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(string, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  ck_assert_uint_eq(cost, lenof("[32-bit-be][4-byte-hw]"));
+  ck_assert_uint_eq(n_tokens, 3);
+  ck_assert_ptr_ne(terminals, nullptr);
+
+  ck_assert_uint_eq(terminals[0].type, enum_WIDTH);
+  ck_assert_uint_eq(widthBits((uint64_t) terminals[0].value), 32);
+  ck_assert_uint_eq(widthOrder((uint64_t) terminals[0].value), ORDER_BIG);
+  ck_assert_uint_eq(terminals[0].length, lenof("[32-bit-be]"));
+
+  ck_assert_uint_eq(terminals[1].type, enum_WIDTH);
+  ck_assert_uint_eq(widthBits((uint64_t) terminals[1].value), 32);
+  ck_assert_uint_eq(widthOrder((uint64_t) terminals[1].value), ORDER_HALFWORD);
+  ck_assert_uint_eq(terminals[1].column, lenof("[32-bit-be]"));
+
+  ck_assert_uint_eq(terminals[2].type, enum_TERMINATOR);
+  STDAllocator.free((void *) terminals);
+}
+END_TEST
+
+START_TEST(test_WIDTH_order_failed) {
+  const char_t *string = "[32-bit-xe]";
+  uint32_t cost = 0, n_tokens = 0;
+  uint32_t lineno = 0, column = 0;
+  const Terminal *terminals = tokenize(string, &cost, &n_tokens, &lineno, &column, &STDAllocator);
+  // `[` is taken as a bracket on its own, and lexing stops before the unknown order.
+  ck_assert_uint_lt(cost, lenof("[32-bit-xe]"));
+  ck_assert_ptr_ne(terminals, nullptr);
+  ck_assert_uint_eq(terminals[0].type, enum_LEFT_SQUARE_BRACKET);
+  STDAllocator.free((void *) terminals);
+}
+END_TEST
+
 START_TEST(test_TIME_TICK) {
   const char_t *string = "(4-tick)";
   uint32_t cost = 0, n_tokens = 0;
@@ -231,6 +269,8 @@ Suite *united_suite() {
   tcase_add_test(tc_united, test_WIDTH_bit);
   tcase_add_test(tc_united, test_WIDTH_default_bit);
   tcase_add_test(tc_united, test_WIDTH_byte);
+  tcase_add_test(tc_united, test_WIDTH_order);
+  tcase_add_test(tc_united, test_WIDTH_order_failed);
   tcase_add_test(tc_united, test_TIME_TICK);
   suite_add_tcase(suite, tc_united);
   return suite;